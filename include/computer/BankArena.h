@@ -0,0 +1,114 @@
+/**
+ * @file BankArena.h
+ * @brief Contiguous, page-aligned storage for the module ROM banks
+ * @author 6502 Kernel Project
+ */
+
+#ifndef BANKARENA_H
+#define BANKARENA_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace Computer
+{
+    /**
+     * @class BankArena
+     * @brief All module ROM images (banks 1..255) in one reserved region
+     *
+     * The arena reserves one page-aligned slot per bank up front. A slot
+     * reads as zeros (open bus) until a bank is installed. Untouched slots
+     * cost address space but no memory.
+     *
+     * There are two ways to install an image:
+     * - loadFile() maps a ROM file read-only into the slot. It does not copy,
+     *   so machines loading the same ROM share page-cache pages. The file is
+     *   only checked at load time; the mapping itself waits until the bank is
+     *   first asked for with bank().
+     * - load() copies an in-memory image into the slot.
+     *
+     * On hosts without mmap the slots are one heap block and files are read
+     * into it on first use.
+     *
+     * @see Memory::loadBank, Memory::loadBankFile
+     */
+    class BankArena
+    {
+    public:
+        /// Bytes of one bank image (Memory::kModuleWindowSize).
+        static constexpr size_t kBankSize = 0x3000;
+
+        /// Number of bank slots (bank 0 is RAM and never used).
+        static constexpr int kBankCount = 256;
+
+        BankArena();
+        ~BankArena();
+
+        /// A copy installs the same images in a fresh arena (files are
+        /// mapped again, not copied).
+        BankArena(const BankArena &other);
+        BankArena &operator=(const BankArena &) = delete;
+
+        /**
+         * @brief Copy an image into a bank slot
+         * @param bank Bank 1..255
+         * @param image Truncated/zero-padded to kBankSize
+         */
+        void load(uint8_t bank, const std::vector<uint8_t> &image);
+
+        /**
+         * @brief Install a ROM file in a bank slot, mapped on first use
+         * @param bank Bank 1..255
+         * @param path ROM image file; truncated/zero-padded to kBankSize
+         * @return false when the file cannot be opened (the bank is unchanged)
+         */
+        bool loadFile(uint8_t bank, const std::string &path);
+
+        /**
+         * @brief Bytes of an installed bank, mapping a file-backed bank now
+         * @param bank Bank 1..255
+         * @return kBankSize bytes, or null when nothing is installed
+         */
+        [[nodiscard]] const uint8_t *bank(uint8_t bank);
+
+        /// Whether an image has been installed in @p bank.
+        [[nodiscard]] bool isLoaded(const uint8_t bank) const { return slots_[bank].state != State::Empty; }
+
+        /// Whether @p bank's slot currently holds its image (false until a
+        /// file-backed bank is first used).
+        [[nodiscard]] bool isMapped(const uint8_t bank) const { return slots_[bank].state == State::Ready; }
+
+    private:
+        enum class State : uint8_t
+        {
+            Empty,      ///< Reads as zeros
+            Pending,    ///< File recorded, not mapped yet
+            Ready       ///< Slot holds the image
+        };
+
+        struct Slot
+        {
+            State state = State::Empty;
+            std::string path;              ///< File backing the slot ("" = copied image)
+        };
+
+        [[nodiscard]] uint8_t *slot(const uint8_t bank) const { return base_ + bank * stride_; }
+
+        /// Return a slot to zeros (drops any file mapping).
+        void clearSlot(uint8_t bank);
+
+        /// Map or read @p bank's file into its slot.
+        void mapFile(uint8_t bank);
+
+        uint8_t *base_ = nullptr;   ///< Start of the reserved region
+        size_t stride_ = 0;         ///< Slot size: kBankSize rounded up to the host page size
+        std::array<Slot, kBankCount> slots_{};
+        std::mutex mutex_;          ///< Guards lazy mapping (arenas may be shared between machines)
+    };
+} // namespace Computer
+
+#endif // BANKARENA_H
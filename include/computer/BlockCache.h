@@ -0,0 +1,160 @@
+/**
+ * @file BlockCache.h
+ * @brief Predecoded basic-block cache for the batched CPU core
+ * @author 6502 Kernel Project
+ */
+
+#ifndef BLOCKCACHE_H
+#define BLOCKCACHE_H
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#include "Memory.h"
+
+/**
+ * @def CPU6502_FUSED_LOAD_STORE
+ * @brief (LDA opcode, STA opcode) pairs fused as BlockCache::Fusion::LoadStore:
+ *        LDA #imm/zp/abs followed by STA zp/abs/(zp),Y
+ */
+#define CPU6502_FUSED_LOAD_STORE(X) \
+    X(0xA9, 0x85) X(0xA9, 0x8D) X(0xA9, 0x91) \
+    X(0xA5, 0x85) X(0xA5, 0x8D) X(0xA5, 0x91) \
+    X(0xAD, 0x85) X(0xAD, 0x8D) X(0xAD, 0x91)
+
+namespace Computer
+{
+    /**
+     * @class BlockCache
+     * @brief Straight-line instruction runs decoded once and replayed
+     *
+     * A block is a run of up to kMaxInstructions instructions starting at a
+     * given PC, with every opcode and operand byte already fetched, so replaying
+     * it costs no Memory::read for instruction bytes. Blocks are keyed by
+     * (bank, PC): the bank is the selected module bank for PCs inside the
+     * module window and 0 everywhere else. The cache is direct-mapped, so a
+     * colliding block simply replaces the previous occupant.
+     *
+     * A block never extends past the 256-byte page it starts in, which makes
+     * invalidation page-granular: it records Memory::pageGeneration() of that
+     * page when decoded and is stale once a RAM store bumps it. Blocks decoded
+     * from ROM (the DOS ROM or a selected module bank) skip that check and are
+     * only dropped when the ROM images themselves change (Memory::romEpoch()).
+     *
+     * Code running from I/O registers, and an instruction that straddles a
+     * page boundary, is decoded on every visit into a one-off block that is
+     * never cached.
+     *
+     * Common idioms (countdown loops, copy pairs, compare-and-branch chains,
+     * pointer bumps and the DOS sector copy loop) are tagged at decode time so
+     * the replay loop can run each as one fused step; see Fusion.
+     *
+     * @see CPU6502::runCycles, Memory::pageGeneration
+     */
+    class BlockCache
+    {
+    public:
+        /// Longest block, in instructions.
+        static constexpr int kMaxInstructions = 16;
+
+        /// Number of direct-mapped slots (a power of two).
+        static constexpr size_t kSlotCount = 4096;
+
+        /**
+         * @brief Instruction idioms replayed as one fused step
+         *
+         * Set on the first record of the idiom; the records that follow stay
+         * as decoded, so the block can still be replayed one by one.
+         */
+        enum class Fusion : uint8_t
+        {
+            None,
+            CountdownBranch,   ///< DEX or DEY, BNE
+            LoadStore,         ///< LDA, STA (see CPU6502_FUSED_LOAD_STORE)
+            CompareBranch,     ///< CMP #imm, BEQ or BNE
+            IncrementBranch,   ///< INC zp, BNE
+            SectorCopy,        ///< LDA abs, STA (zp),Y, INY, BNE
+        };
+
+        /// Number of Fusion kinds, None included.
+        static constexpr size_t kFusionCount = 6;
+
+        /// Records covered by each Fusion kind.
+        static constexpr std::array<uint8_t, kFusionCount> kFusionLength = {1, 2, 2, 2, 2, 4};
+
+        /// Short name of a Fusion kind, for reports.
+        static const char *fusionName(Fusion fusion);
+
+        /// One predecoded instruction.
+        struct Instruction
+        {
+            uint8_t opcode = 0;
+            uint8_t length = 1;                   ///< Opcode plus operand bytes
+            std::array<uint8_t, 2> operands{};    ///< Unused bytes are zero
+            Fusion fusion = Fusion::None;         ///< Idiom starting here
+            uint8_t fused_length = 0;             ///< Bytes covered by that idiom
+        };
+
+        /// Native translation of a hot block (see BlockJit); takes a JitFrame.
+        using NativeCode = void (*)(void *frame);
+
+        /// A decoded run of instructions starting at @c pc.
+        struct Block
+        {
+            uint16_t pc = 0;
+            uint8_t bank = 0;          ///< Module bank, for PCs in the window
+            uint8_t count = 0;         ///< Instructions in the block; 0 = empty slot
+            bool windowed = false;     ///< PC lies in the module window
+            bool rom = false;          ///< Decoded from ROM; never self-modified
+            bool transient = false;    ///< One-off decode, not in the cache
+            uint32_t generation = 0;   ///< Page generation when decoded
+            uint32_t epoch = 0;        ///< ROM epoch when decoded
+            uint32_t executions = 0;   ///< Replays since decoded (JIT hotness)
+            NativeCode native = nullptr; ///< JIT translation, once hot
+            std::array<Instruction, kMaxInstructions> instructions{};
+
+            /**
+             * @brief Whether the bytes this block was decoded from are still mapped
+             *        and unmodified
+             * @param mem Memory the block was decoded from
+             */
+            [[nodiscard]] bool isCurrent(const Memory &mem) const
+            {
+                return (!windowed || mem.currentBank() == bank) &&
+                       (rom || mem.pageGeneration(pc >> 8) == generation);
+            }
+        };
+
+        BlockCache();
+
+        /**
+         * @brief Find or decode the block starting at @p pc
+         * @param mem Memory to decode from
+         * @param pc Address of the first instruction
+         * @return The cached block, or a one-off block for uncacheable code.
+         *         Valid until the next lookup.
+         */
+        Block &lookup(const Memory &mem, uint16_t pc);
+
+        /// Drop every cached block.
+        void clear();
+
+        /// Forget every native translation (the JIT code arena was recycled).
+        void dropTranslations();
+
+        /// Number of blocks decoded so far (cache misses), for diagnostics.
+        [[nodiscard]] uint64_t decodeCount() const { return decode_count_; }
+
+    private:
+        static void fuse(Block &block);
+        void decode(const Memory &mem, uint16_t pc, uint8_t bank, Block &block);
+        void decodeUncached(const Memory &mem, uint16_t pc);
+
+        std::vector<Block> slots_;
+        Block scratch_;                ///< One-off block for uncacheable code
+        uint64_t decode_count_ = 0;
+    };
+} // namespace Computer
+
+#endif // BLOCKCACHE_H
@@ -9,8 +9,12 @@
 
 #include <array>
 #include <cstdint>
+#include <map>
+#include <memory>
 #include <string>
 
+#include "BusDevice.h"
+
 namespace Computer
 {
     /**
@@ -41,9 +45,14 @@ namespace Computer
      * back as zeros and grows on write), so a missing disk.img is not an error.
      * Only a genuine open/I/O failure raises the error status.
      *
+     * After freezeImage() the image file becomes a read-only base: written
+     * sectors are kept in memory and shadow it. Copies of a frozen device
+     * share those sectors until one side rewrites them, which is how
+     * Computer6502::fork() gives each machine its own disk.
+     *
      * @see Memory, Computer6502
      */
-    class BlockDevice
+    class BlockDevice : public BusDevice
     {
     public:
         /// Register addresses in the always-mapped I/O page.
@@ -76,12 +85,32 @@ namespace Computer
          */
         void setImagePath(const std::string &image_path);
 
+        /**
+         * @brief Stop writing to the host image; keep written sectors in memory
+         * @note Sectors already written stay readable; there is no way back
+         *       to write-through.
+         */
+        void freezeImage();
+
+        /// Whether writes are kept in memory (see freezeImage()).
+        [[nodiscard]] bool isImageFrozen() const { return frozen_; }
+
+        /// Number of sectors written since the image was frozen.
+        [[nodiscard]] size_t overlaySectors() const { return overlay_.size(); }
+
         /**
          * @brief Whether an address falls within the block-device registers.
          * @param address 16-bit address to test ($FE24-$FE28).
          */
         [[nodiscard]] static bool isBlockAddress(uint16_t address);
 
+        /**
+         * @brief Whether reading a register changes device state.
+         * @param address Block-device register address.
+         * @return true for the data port, which advances the buffer index.
+         */
+        [[nodiscard]] bool readHasSideEffects(uint16_t address) const override;
+
         /**
          * @brief Read a block-device register.
          * @param address Register address within $FE24-$FE28.
@@ -97,6 +126,11 @@ namespace Computer
          */
         void write(uint16_t address, uint8_t value);
 
+        // BusDevice: the BLK_* registers
+        [[nodiscard]] BusRange busRange() const override { return {kRegLbaLo, kRegData}; }
+        uint8_t busRead(const uint16_t address) override { return read(address); }
+        void busWrite(const uint16_t address, const uint8_t value) override { write(address, value); }
+
     private:
         /// Read the sector at lba_ from the image into buffer_; reset index_.
         void readSector();
@@ -108,6 +142,12 @@ namespace Computer
         uint16_t lba_ = 0;                         ///< selected sector number
         size_t index_ = 0;                         ///< data-port index (0..511)
         uint8_t status_ = kStatusReady;            ///< last-operation status
+
+        /// Sectors written since freezeImage(); shared between copies and
+        /// replaced, never modified, on write.
+        using Sector = std::array<uint8_t, kSectorSize>;
+        std::map<uint16_t, std::shared_ptr<const Sector>> overlay_;
+        bool frozen_ = false;                      ///< writes go to overlay_
     };
 } // namespace Computer
 
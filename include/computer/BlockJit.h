@@ -0,0 +1,124 @@
+/**
+ * @file BlockJit.h
+ * @brief Optional x86-64 translation tier for hot predecoded blocks
+ * @author 6502 Kernel Project
+ */
+
+#ifndef BLOCKJIT_H
+#define BLOCKJIT_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+
+#include "BlockCache.h"
+
+#ifndef CPU6502_JIT_HOT_THRESHOLD
+#define CPU6502_JIT_HOT_THRESHOLD 32
+#endif
+
+namespace Computer
+{
+    namespace Isa { struct DecodedContext; }
+
+    /**
+     * @struct JitFrame
+     * @brief State a translated block runs against
+     *
+     * The same values runCycles() checks between replayed instructions: the
+     * batch context, the cycle budget, the CPU's attention latch and the block
+     * being run (for its self-modification check).
+     */
+    struct JitFrame
+    {
+        Isa::DecodedContext *ctx;
+        const Memory *mem;
+        const BlockCache::Block *block;
+        uint64_t end;             ///< Cycle count at which the batch ends
+        const std::atomic<bool> *attention;    ///< CPU6502::attention_
+    };
+
+    /**
+     * @class BlockJit
+     * @brief Translates hot BlockCache blocks into native x86-64 code
+     *
+     * The common opcodes are compiled to inline code: loads, stores and the
+     * ALU ops in the immediate, zero-page, absolute, indexed and (zp),Y modes,
+     * INC/DEC, compares, register transfers and increments, flag ops,
+     * branches, JMP, JSR and RTS. The cycle count stays in a host register
+     * and flags go straight into the LazyFlags fields; RAM accesses use
+     * Memory's page tables inline and only device, ROM-write and unmapped
+     * pages call back into Memory. Everything else, and ADC/SBC with D set,
+     * is call-threaded through the interpreter's own Isa::execute body, so
+     * rare opcodes cannot drift from the interpreter. Packed-flags builds use
+     * only the call-threaded form.
+     *
+     * After each instruction the translation applies the replay loop's stop
+     * conditions and leaves with the PC the interpreter would have: a taken
+     * branch, a store into the block's own page (self-modifying code), a
+     * write to MODULE_BANK that remaps a windowed block, a device raising
+     * attention (PIA/block-device I/O) or the end of the budget. Interrupts
+     * are then sampled by runCycles() before the next block.
+     *
+     * Translations live in one mmap'd arena that is written while
+     * read/write and executed while read/execute. When it fills up the whole
+     * arena is recycled and BlockCache::dropTranslations() forgets the old
+     * entry points. Stale blocks lose their translation when BlockCache
+     * re-decodes them.
+     *
+     * Only built with -DCPU6502_JIT=ON on x86-64 (System V ABI).
+     */
+    class BlockJit
+    {
+    public:
+        /// Replays of a block before it is translated.
+        static constexpr uint32_t kHotThreshold = CPU6502_JIT_HOT_THRESHOLD;
+
+        /// Size of the executable code arena.
+        static constexpr size_t kArenaSize = 1 << 20;
+
+        BlockJit();
+        ~BlockJit();
+
+        BlockJit(const BlockJit &) = delete;
+        BlockJit &operator=(const BlockJit &) = delete;
+
+        /**
+         * @brief Emit native code for a block
+         * @param block Decoded block; must outlive the translation
+         * @param frame A frame like the ones the code will run with; only
+         *        the layout of its context and Memory is used (the first
+         *        call fixes it for the lifetime of the JIT)
+         * @return Entry point taking a JitFrame, or nullptr when the arena is
+         *         full (call reset() and drop existing translations first) or
+         *         could not be mapped
+         */
+        [[nodiscard]] BlockCache::NativeCode translate(const BlockCache::Block &block, const JitFrame &frame);
+
+        /// Recycle the arena; every previously returned entry point is invalid.
+        void reset();
+
+        /// Number of blocks translated so far, for diagnostics.
+        [[nodiscard]] uint64_t translationCount() const { return translation_count_; }
+
+        /// Where translated code finds the context and Memory fields, as
+        /// byte offsets from the DecodedContext and the Memory.
+        struct Layout
+        {
+            int32_t a = 0, x = 0, y = 0, sp = 0, p = 0, pc = 0, cycles = 0;
+            int32_t n_source = 0, z_source = 0, carry = 0, overflow = 0;
+            int32_t read_pages = 0, write_pages = 0, page_generation = 0, side_effects = 0, current_bank = 0;
+        };
+
+    private:
+        static Layout layoutOf(const JitFrame &frame);
+
+        std::optional<Layout> layout_;
+        uint8_t *arena_ = nullptr;
+        size_t used_ = 0;
+        uint64_t translation_count_ = 0;
+    };
+} // namespace Computer
+
+#endif // BLOCKJIT_H
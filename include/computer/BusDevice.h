@@ -0,0 +1,71 @@
+/**
+ * @file BusDevice.h
+ * @brief Interface for memory-mapped peripherals attached to the system bus
+ * @author 6502 Kernel Project
+ */
+
+#ifndef BUS_DEVICE_H
+#define BUS_DEVICE_H
+
+#include <cstdint>
+
+namespace Computer
+{
+    /**
+     * @struct BusRange
+     * @brief Inclusive address range answered by a bus device
+     */
+    struct BusRange
+    {
+        uint16_t first = 0;  ///< First register address
+        uint16_t last = 0;   ///< Last register address (inclusive)
+    };
+
+    /**
+     * @class BusDevice
+     * @brief A peripheral whose registers are mapped into the address space
+     *
+     * Devices declare the range they answer with busRange() and are attached
+     * with Memory::attachDevice(). Memory builds a per-address dispatch table
+     * for the pages the devices occupy, so an access costs one indexed lookup
+     * however many devices are attached; adding a peripheral never touches
+     * Memory itself.
+     *
+     * @see Memory, VIC, PIA, BlockDevice
+     */
+    class BusDevice
+    {
+    public:
+        virtual ~BusDevice() = default;
+
+        /**
+         * @brief Addresses the device decodes
+         * @return BusRange Inclusive register range
+         */
+        [[nodiscard]] virtual BusRange busRange() const = 0;
+
+        /**
+         * @brief Read a register
+         * @param address Address within busRange()
+         * @return uint8_t Register value
+         */
+        virtual uint8_t busRead(uint16_t address) = 0;
+
+        /**
+         * @brief Write a register
+         * @param address Address within busRange()
+         * @param value Byte to write
+         */
+        virtual void busWrite(uint16_t address, uint8_t value) = 0;
+
+        /**
+         * @brief Whether reading a register changes device state
+         * @param address Address within busRange()
+         * @return bool true when the read consumes data (see
+         *         Memory::sideEffectCount()); plain registers return false
+         */
+        [[nodiscard]] virtual bool readHasSideEffects(uint16_t /*address*/) const { return false; }
+    };
+} // namespace Computer
+
+#endif // BUS_DEVICE_H
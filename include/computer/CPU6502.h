@@ -7,14 +7,28 @@
 #ifndef CPU6502_H
 #define CPU6502_H
 
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
 #include <cstdint>
 #include <functional>
 #include <map>
+#include <mutex>
+#include <ostream>
 
+#include "BlockCache.h"
 #include "Memory.h"
 
+#ifdef CPU6502_JIT
+#include "BlockJit.h"
+#endif
+
 namespace Computer {
 
+class RomTranslations;
+namespace Isa { struct StepContext; enum class Halt : uint8_t; }
+
 /**
  * @class CPU6502
  * @brief Complete MOS 6502 microprocessor emulator
@@ -31,13 +45,17 @@ namespace Computer {
  * - Cycle counting for timing accuracy
  * - Memory-mapped I/O integration
  *
+ * Instruction semantics live in CPU6502Instructions.h: each opcode is an
+ * addressing-mode policy combined with an operation functor, and the CPU
+ * dispatches through a constexpr table of the resulting specializations.
+ *
  * The CPU operates on the classic 6502 architecture with:
  * - 8-bit accumulator and index registers
  * - 16-bit program counter and address bus
  * - 8-bit stack pointer (page 1: $0100-$01FF)
  * - 8-bit processor status register with 6 flags
  *
- * @see Memory, Computer6502
+ * @see Memory, Computer6502, CPU6502Instructions.h
  */
 class CPU6502
 {
@@ -81,14 +99,35 @@ public:
         kNegative = 0x80      ///< Negative flag (bit 7) - Set when bit 7 of result is 1
     };
 
+    /**
+     * @enum RunState
+     * @brief Whether the CPU executes instructions or is halted by WAI/STP
+     */
+    enum class RunState : uint8_t
+    {
+        Running,    ///< Executing instructions
+        Waiting,    ///< WAI: until an IRQ or NMI is asserted
+        Stopped     ///< STP: until reset
+    };
+
     /**
      * @brief Reset the CPU to initial power-on state
      *
      * Sets all registers to their default values and loads the program counter
-     * from the reset vector at memory locations $FFFC-$FFFD.
+     * from the reset vector at memory locations $FFFC-$FFFD. Also releases a
+     * CPU halted by WAI or STP.
      */
     void reset();
 
+    /**
+     * @brief Take over another CPU's architectural state
+     * @param other CPU to copy registers, clock, interrupt lines and halt
+     *        state from
+     * @note Decoded blocks are not copied; they are rebuilt against this
+     *       CPU's memory on first use.
+     */
+    void copyStateFrom(const CPU6502 &other);
+
     /**
      * @brief Set or clear a processor status flag
      * @param flag The status flag to modify
@@ -113,10 +152,36 @@ public:
     /**
      * @brief Execute one CPU instruction cycle
      * @return bool true if instruction executed successfully, false if unknown opcode
-     * @note Fetches opcode from memory at PC, executes instruction, updates cycle count
+     * @note Fetches opcode from memory at PC, executes instruction, updates cycle count.
+     *       While halted (see runState()) a call only advances the clock by one cycle.
      */
     bool executeSingleInstruction();
 
+    /**
+     * @brief Execute instructions until a cycle budget is spent
+     * @param budget Number of cycles to run (the last instruction may overshoot)
+     * @return uint64_t Cycles actually executed
+     * @note Registers are held in locals for the whole batch. The loop also
+     *       returns early, at an instruction boundary, when an interrupt line
+     *       changes or a device calls raiseAttention(). Interrupts are sampled
+     *       before each instruction exactly as in executeSingleInstruction().
+     *       Instructions are replayed from the predecoded BlockCache, with
+     *       common idioms fused into one step (-DCPU6502_FUSION=OFF disables).
+     *       A loop that keeps re-reading unchanged state (a keyboard poll) is
+     *       fast-forwarded by whole passes to the end of the budget; the
+     *       skipped cycles are counted as if executed (see idleCycles()).
+     *       While halted by WAI or STP the rest of the budget elapses at once.
+     */
+    uint64_t runCycles(uint64_t budget);
+
+    /**
+     * @brief Ask a running runCycles() batch to return at the next
+     *        instruction boundary
+     * @note Called by devices that need the host to act (e.g. a PIA file
+     *       command), and internally when an interrupt line changes.
+     */
+    void raiseAttention();
+
     /**
      * @brief Read next byte from memory and increment program counter
      * @return uint8_t The byte value at current PC location
@@ -172,302 +237,166 @@ public:
      * @brief Set/clear the IRQ line. While asserted and the I flag is clear,
      *        an IRQ is serviced before each instruction; the handler must clear
      *        the source (ack) to deassert the line.
+     * @note Asserting the line releases a CPU waiting in WAI, even with the
+     *       I flag set; execution then resumes after the WAI.
      */
     void setIrqLine(bool asserted);
 
+    /// Running, or halted by WAI (Waiting) or STP (Stopped).
+    [[nodiscard]] RunState runState() const { return run_state_.load(std::memory_order_acquire); }
+
+    /// Whether WAI or STP has halted the CPU.
+    [[nodiscard]] bool isHalted() const { return runState() != RunState::Running; }
+
+    /**
+     * @brief Block the calling thread while the CPU is halted
+     * @param timeout Longest time to wait
+     * @return bool true once the CPU runs again, false on timeout
+     * @note Woken by requestNmi(), setIrqLine(true) and reset(), from any
+     *       thread. Lets a host sleep instead of running empty batches.
+     */
+    bool waitWhileHalted(std::chrono::microseconds timeout);
+
+    /**
+     * @brief Name of the opcode dispatch core this build was compiled with
+     * @note "table" (dense 256-entry array, the default) or "map"
+     *       (std::map lookup, selected with -DCPU6502_MAP_DISPATCH=ON), with
+     *       "+jit" appended when hot blocks are translated (-DCPU6502_JIT=ON)
+     */
+    static const char *dispatchCoreName();
+
+    /**
+     * @brief Run ahead-of-time ROM translations from runCycles()
+     * @param translations Bound directory (see RomTranslations::bind), or
+     *        nullptr to interpret everything; must outlive the CPU
+     */
+    void setRomTranslations(RomTranslations *translations) { rom_translations_ = translations; }
+
+    /// Cycles skipped by idle-loop fast-forward or spent halted so far (included in getCycles()).
+    [[nodiscard]] uint64_t idleCycles() const { return idle_cycles_; }
+
+    /// Whether the last runCycles() batch fast-forwarded through an idle loop or halted.
+    [[nodiscard]] bool isIdle() const { return idle_; }
+
+    /// How often one fused idiom ran (see BlockCache::Fusion).
+    struct FusionStats
+    {
+        uint64_t fused = 0;     ///< Replays as one fused step
+        uint64_t unfused = 0;   ///< Replays one record at a time (budget nearly spent)
+    };
+
+    /// Counters for @p fusion since power-on.
+    [[nodiscard]] FusionStats fusionStats(BlockCache::Fusion fusion) const
+    {
+        return fusion_stats_[static_cast<size_t>(fusion)];
+    }
+
+    /**
+     * @brief Print the per-idiom fusion hit rates
+     * @param out Stream to write one line per idiom to
+     */
+    void printFusionReport(std::ostream &out) const;
+
+    /**
+     * @struct WatchHit
+     * @brief A watched access, attributed to the instruction that made it
+     */
+    struct WatchHit
+    {
+        WatchKind kind;     ///< kWatchRead, kWatchWrite or kWatchExecute
+        uint16_t pc;        ///< Address of the instruction
+        uint16_t address;   ///< Address accessed (== pc for execute hits)
+        uint8_t value;      ///< Byte read or stored, or the opcode
+        uint64_t cycles;    ///< getCycles() when the instruction started
+    };
+
+    using WatchHandler = std::function<void(const WatchHit &)>;
+
+    /**
+     * @brief Report accesses to @p address
+     * @param address Guest address
+     * @param kinds WatchKind mask
+     * @note Only the page holding the address leaves the fast path. While
+     *       any watch is armed runCycles() steps one instruction at a time so
+     *       every hit carries its instruction's PC; each hit also ends the
+     *       batch (see raiseAttention()).
+     */
+    void addWatchpoint(uint16_t address, uint8_t kinds) { mem_.watch(address, kinds); }
+
+    /// Stop reporting @p kinds at @p address.
+    void removeWatchpoint(uint16_t address, uint8_t kinds) { mem_.unwatch(address, kinds); }
+
+    /// Receive watch hits as they happen (replaces any previous handler).
+    void setWatchHandler(WatchHandler handler) { watch_handler_ = std::move(handler); }
+
 private:
     Memory &mem_;
     uint64_t cycles_;
-    using handlerFunction = std::function<void()>;
-    std::map<uint8_t, handlerFunction> handlers_;
+    BlockCache blocks_;  ///< Predecoded instruction runs for runCycles()
+    RomTranslations *rom_translations_ = nullptr;  ///< Build-time ROM translations
+    std::array<FusionStats, BlockCache::kFusionCount> fusion_stats_{};
+
+    /// Longest idle-loop pass recognised, in cycles.
+    static constexpr uint64_t kIdleWindow = 1024;
+
+    /// Machine state at one block boundary, compared with later boundaries
+    /// to recognise a loop that re-reads unchanged state (see runCycles()).
+    struct IdleProbe
+    {
+        uint64_t cycles = 0;
+        uint64_t side_effects = ~uint64_t{0};  ///< Memory::sideEffectCount(); ~0 = unarmed
+        uint16_t pc = 0;
+        uint8_t a = 0, x = 0, y = 0, sp = 0;
+        uint8_t p = 0;
+        bool has_status = false;               ///< p is recorded
+    };
+    IdleProbe idle_probe_;
+    uint64_t idle_cycles_ = 0;
+    bool idle_ = false;
 
-    // Hardware interrupt lines
-    bool nmi_pending_ = false;  ///< edge-triggered NMI latch
-    bool irq_line_ = false;     ///< level-sensitive IRQ line
+#ifdef CPU6502_JIT
+    BlockJit jit_;       ///< Native translations of hot blocks
+#endif
 
-    /// Push PC + status and vector through $FFFA (NMI) or $FFFE (IRQ).
-    void serviceInterrupt(uint16_t vector);
+#ifdef CPU6502_MAP_DISPATCH
+    /// Reference core: ordered-map lookup per opcode (kept for A/B comparison).
+    using handlerFunction = std::function<void(Isa::StepContext &)>;
+    std::map<uint8_t, handlerFunction> handlers_;
 
     void initializeInstructionHandlers();
+#endif
+
+    WatchHandler watch_handler_;
+
+    /// executeSingleInstruction() with watch checks around the instruction.
+    bool executeWatched();
+
+    /// The interpreter step behind executeSingleInstruction().
+    bool executeInstruction();
+
+    /// Run a batch one instruction at a time (runCycles() with watches armed).
+    uint64_t runWatched(uint64_t budget);
+
+    /// Pass one hit to the handler and end the batch.
+    void reportWatch(const WatchHit &hit);
+
+    // Hardware interrupt lines. Atomic because requestNmi() and setIrqLine()
+    // may come from another thread; wake_mutex_ orders them against halt().
+    std::atomic<bool> nmi_pending_{false};  ///< edge-triggered NMI latch
+    std::atomic<bool> irq_line_{false};     ///< level-sensitive IRQ line
+    std::atomic<bool> attention_{false};    ///< end the current runCycles() batch
+
+    // WAI/STP halt; the mutex and condition variable let hosts sleep on it
+    std::atomic<RunState> run_state_{RunState::Running};
+    std::mutex wake_mutex_;
+    std::condition_variable wake_;
+
+    /// Enter the halt an instruction requested (WAI returns at once if an
+    /// interrupt is already pending).
+    void halt(Isa::Halt request);
 
-    // Addressing calculation functions
-    std::pair<uint16_t, bool> calculateAddress(bool use_one_byte, uint8_t offset);
-    uint16_t calculateAddressSimple(bool use_one_byte, uint8_t offset);
-    std::pair<uint16_t, bool> calculateRelativeAddress(uint8_t offset);
-    std::pair<uint16_t, uint8_t> calculateIndexedAddress(uint8_t offset);
-    std::pair<uint16_t, uint8_t> calculateIndirectAddress(uint8_t offset);
-    bool checkPageBoundaryCrossed(uint16_t base_addr, uint16_t final_addr);
-    bool validateAddress(uint16_t address);
-
-    // 65C02 New addressing mode functions
-    uint16_t calculateZeroPageIndirectAddress();
-    uint16_t calculateAbsoluteIndexedIndirectAddress();
-
-    // ALU helper functions
-    uint8_t addValues(uint8_t val1, uint8_t val2);
-    uint8_t subtractValues(uint8_t val1, uint8_t val2);
-    void compareValues(uint8_t val1, uint8_t val2);
-
-    // Stack helper functions
-    void pushStack16(uint16_t value);
-    uint16_t popStack16();
-
-    // Math instructions (Add/Subtract).
-    void handleAdcImmediate();
-    void handleAdcZeroPage();
-    void handleAdcZeroPageX();
-    void handleAdcAbsolute();
-    void handleAdcAbsoluteX();
-    void handleAdcAbsoluteY();
-    void handleAdcIndexedIndirect();
-    void handleAdcIndirectIndexed();
-    void handleAdcBase(uint16_t address, uint8_t pc_offset, uint8_t cycles);
-    void handleSbcImmediate();
-    void handleSbcZeroPage();
-    void handleSbcZeroPageX();
-    void handleSbcAbsolute();
-    void handleSbcAbsoluteX();
-    void handleSbcAbsoluteY();
-    void handleSbcIndexedIndirect();
-    void handleSbcIndirectIndexed();
-    void handleSbcBase(uint16_t address, uint8_t pc_offset, uint8_t cycles);
-
-    // Bitwise operations.
-    void handleAndImmediate();
-    void handleAndZeroPage();
-    void handleAndZeroPageX();
-    void handleAndAbsolute();
-    void handleAndAbsoluteX();
-    void handleAndAbsoluteY();
-    void handleAndIndexedIndirect();
-    void handleAndIndirectIndexed();
-    void handleAndBase(uint16_t address, uint8_t pc_offset, uint8_t cycles);
-    void handleEorImmediate();
-    void handleEorZeroPage();
-    void handleEorZeroPageX();
-    void handleEorAbsolute();
-    void handleEorAbsoluteX();
-    void handleEorAbsoluteY();
-    void handleEorIndexedIndirect();
-    void handleEorIndirectIndexed();
-    void handleEorBase(uint16_t address, uint8_t pc_offset, uint8_t cycles);
-    void handleOraImmediate();
-    void handleOraZeroPage();
-    void handleOraZeroPageX();
-    void handleOraAbsolute();
-    void handleOraAbsoluteX();
-    void handleOraAbsoluteY();
-    void handleOraIndexedIndirect();
-    void handleOraIndirectIndexed();
-    void handleOraBase(uint16_t address, uint8_t pc_offset, uint8_t cycles);
-
-    // Shift & rotation (Left/Right) operations.
-    void handleAslAccumulator();
-    void handleAslZeroPage();
-    void handleAslZeroPageX();
-    void handleAslAbsolute();
-    void handleAslAbsoluteX();
-    void handleAslBase(uint16_t address, uint8_t pc_offset, uint8_t cycles);
-    void handleLsrAccumulator();
-    void handleLsrZeroPage();
-    void handleLsrZeroPageX();
-    void handleLsrAbsolute();
-    void handleLsrAbsoluteX();
-    void handleLsrBase(uint16_t address, uint8_t pc_offset, uint8_t cycles);
-    void handleRolAccumulator();
-    void handleRolZeroPage();
-    void handleRolZeroPageX();
-    void handleRolAbsolute();
-    void handleRolAbsoluteX();
-    void handleRolBase(uint16_t address, uint8_t pc_offset, uint8_t cycles);
-    void handleRorAccumulator();
-    void handleRorZeroPage();
-    void handleRorZeroPageX();
-    void handleRorAbsolute();
-    void handleRorAbsoluteX();
-    void handleRorBase(uint16_t address, uint8_t pc_offset, uint8_t cycles);
-
-    // Branching Instructions.
-    void handleBcc();
-    void handleBcs();
-    void handleBeq();
-    void handleBmi();
-    void handleBne();
-    void handleBpl();
-    void handleBvc();
-    void handleBvs();
-
-    // Bit testing.
-    void handleBitZeroPage();
-    void handleBitAbsolute();
-    void handleBitBase(uint16_t address, uint8_t pc_offset, uint8_t cycles);
-
-    // Flag Instructions.
-    void handleClc();
-    void handleCld();
-    void handleCli();
-    void handleClv();
-    void handleSec();
-    void handleSed();
-    void handleSei();
-
-    // Compare Instructions (A/X/Y).
-    void handleCmpImmediate();
-    void handleCmpZeroPage();
-    void handleCmpZeroPageX();
-    void handleCmpAbsolute();
-    void handleCmpAbsoluteX();
-    void handleCmpAbsoluteY();
-    void handleCmpIndexedIndirect();
-    void handleCmpIndirectIndexed();
-    void handleCmpBase(uint16_t address, uint8_t pc_offset, uint8_t cycles);
-    void handleCpxImmediate();
-    void handleCpxZeroPage();
-    void handleCpxAbsolute();
-    void handleCpxBase(uint16_t address, uint8_t pc_offset, uint8_t cycles);
-    void handleCpyImmediate();
-    void handleCpyZeroPage();
-    void handleCpyAbsolute();
-    void handleCpyBase(uint16_t address, uint8_t pc_offset, uint8_t cycles);
-
-    // Incrementors & Decrementors (Memory/X/Y).
-    void handleIncZeroPage();\
-    void handleIncZeroPageX();
-    void handleIncAbsolute();
-    void handleIncAbsoluteX();
-    void handleIncBase(uint16_t address, uint8_t pc_offset, uint8_t cycles);
-    void handleInx();
-    void handleIny();
-    void handleDecZeroPage();
-    void handleDecZeroPageX();
-    void handleDecAbsolute();
-    void handleDecAbsoluteX();
-    void handleDecBase(uint16_t address, uint8_t pc_offset, uint8_t cycles);
-    void handleDex();
-    void handleDey();
-
-    // Jump & Return operations.
-    void handleJmpAbsolute();
-    void handleJmpIndirect();
-    void handleJmpBase(uint16_t address, uint8_t cycles);
-    void handleJsr();
-    void handleRti();
-    void handleRts();
-
-    // Load Value (A/X/Y).
-    void handleLdaImmediate();
-    void handleLdaZeroPage();
-    void handleLdaZeroPageX();
-    void handleLdaAbsolute();
-    void handleLdaAbsoluteX();
-    void handleLdaAbsoluteY();
-    void handleLdaIndexedIndirect();
-    void handleLdaIndirectIndexed();
-    void handleLdaBase(uint16_t address, uint8_t pc_offset, uint8_t cycles);
-    void handleLdxImmediate();
-    void handleLdxZeroPage();
-    void handleLdxZeroPageY();
-    void handleLdxAbsolute();
-    void handleLdxAbsoluteY();
-    void handleLdxBase(uint16_t address, uint8_t pc_offset, uint8_t cycles);
-    void handleLdyImmediate();
-    void handleLdyZeroPage();
-    void handleLdyZeroPageX();
-    void handleLdyAbsolute();
-    void handleLdyAbsoluteX();
-    void handleLdyBase(uint16_t address, uint8_t pc_offset, uint8_t cycles);
-
-    // Store value (A/X/Y)
-    void handleStaZeroPage();
-    void handleStaZeroPageX();
-    void handleStaAbsolute();
-    void handleStaAbsoluteX();
-    void handleStaAbsoluteY();
-    void handleStaIndexedIndirect();
-    void handleStaIndirectIndexed();
-    void handleStaBase(uint16_t address, uint8_t pc_offset, uint8_t cycles);
-    void handleStxZeroPage();
-    void handleStxZeroPageY();
-    void handleStxAbsolute();
-    void handleStxBase(uint16_t address, uint8_t pc_offset, uint8_t cycles);
-    void handleStyZeroPage();
-    void handleStyZeroPageX();
-    void handleStyAbsolute();
-    void handleStyBase(uint16_t address, uint8_t pc_offset, uint8_t cycles);
-
-    // Stack instructions.
-    void handlePha();
-    void handlePhp();
-    void handlePla();
-    void handlePlp();
-    void handlePhx();
-    void handlePlx();
-    void handlePhy();
-    void handlePly();
-
-    // Register Transfers (A/X/Y/Stack).
-    void handleTax();
-    void handleTay();
-    void handleTsx();
-    void handleTxa();
-    void handleTxs();
-    void handleTya();
-
-    // 65C02 New Instructions
-
-    // 65C02 Accumulator increment/decrement
-    void handleIncAccumulator();  // INC A - $1A
-    void handleDecAccumulator();  // DEC A - $3A
-
-    // 65C02 Enhanced BIT instructions
-    void handleBitImmediate();    // BIT # - $89
-    void handleBitZeroPageX();    // BIT zp,X - $34
-    void handleBitAbsoluteX();    // BIT abs,X - $3C
-
-    // 65C02 Branch Always
-    void handleBra();             // BRA rel - $80
-
-    // 65C02 Zero-page indirect addressing modes — (zp), a 1-byte zero-page
-    // operand whose pointer at zp/zp+1 (zp-wrapped) gives the effective address.
-    void handleAdcZeroPageIndirect();  // ADC (zp) - $72
-    void handleAndZeroPageIndirect();  // AND (zp) - $32
-    void handleCmpZeroPageIndirect();  // CMP (zp) - $D2
-    void handleEorZeroPageIndirect();  // EOR (zp) - $52
-    void handleLdaZeroPageIndirect();  // LDA (zp) - $B2
-    void handleOraZeroPageIndirect();  // ORA (zp) - $12
-    void handleSbcZeroPageIndirect();  // SBC (zp) - $F2
-    void handleStaZeroPageIndirect();  // STA (zp) - $92
-
-    // 65C02 Jump Absolute Indexed Indirect
-    void handleJmpAbsoluteIndexedIndirect();  // JMP (addr,X) - $7C
-
-    // 65C02 Store Zero instructions
-    void handleStzZeroPage();     // STZ zp - $64
-    void handleStzZeroPageX();    // STZ zp,X - $74
-    void handleStzAbsolute();     // STZ abs - $9C
-    void handleStzAbsoluteX();    // STZ abs,X - $9E
-    void handleStzBase(uint16_t address, uint8_t pc_offset, uint8_t cycles);
-
-    // 65C02 Test and Reset/Set Bits
-    void handleTrbZeroPage();     // TRB zp - $14
-    void handleTrbAbsolute();     // TRB abs - $1C
-    void handleTsbZeroPage();     // TSB zp - $04
-    void handleTsbAbsolute();     // TSB abs - $0C
-    void handleTrbTsbBase(uint16_t address, uint8_t pc_offset, uint8_t cycles, bool is_set);
-
-    // 65C02 (Rockwell/WDC) single-bit memory ops on zero page.
-    void handleRmb(uint8_t bit);  // RMBn zp - $07,$17,...,$77 (reset bit n)
-    void handleSmb(uint8_t bit);  // SMBn zp - $87,$97,...,$F7 (set bit n)
-    void handleBbr(uint8_t bit);  // BBRn zp,rel - $0F,$1F,...,$7F (branch if bit n reset)
-    void handleBbs(uint8_t bit);  // BBSn zp,rel - $8F,$9F,...,$FF (branch if bit n set)
-
-    // 65C02 Processor Control
-    void handleStp();             // STP - $DB (Stop processor)
-    void handleWai();             // WAI - $CB (Wait for interrupt)
-
-    // No operation & break.
-    void handleNop();
-    void handleBrk();
+    /// Leave a WAI (or, with @p from_stop, an STP) halt and wake waiters.
+    void wake(bool from_stop);
 };
 
 } // namespace Computer
@@ -0,0 +1,1263 @@
+/**
+ * @file CPU6502Instructions.h
+ * @brief Compile-time 65C02 instruction set: addressing-mode policies,
+ *        operation functors and the canonical opcode table
+ * @author 6502 Kernel Project
+ *
+ * Every opcode is the composition of one addressing-mode policy (how the
+ * operand is located) and one operation functor (what is done with it),
+ * listed once in CPU6502_OPCODE_TABLE. Isa::execute<Op, Mode, Cycles> stitches
+ * the pair together, so the compiler emits one specialized, fully inlined
+ * body per opcode. This table is the single place opcode semantics are
+ * defined: the CPU builds its dispatch table from it and
+ * tools/gen_opcode_table.py builds the assembler/disassembler tables from it.
+ *
+ * Operations are templated on an execution context (see Isa::BasicContext) so the
+ * same bodies can run against different register/flag storage.
+ */
+
+#ifndef CPU6502_INSTRUCTIONS_H
+#define CPU6502_INSTRUCTIONS_H
+
+#include <array>
+#include <cstdint>
+
+#include "CPU6502.h"
+#include "Memory.h"
+
+namespace Computer::Isa {
+
+/**
+ * @struct PackedFlags
+ * @brief Status flags kept in reg.P, updated on every write
+ *
+ * Used when P must be current after every instruction (single-stepping,
+ * where callers inspect reg.P between steps).
+ */
+struct PackedFlags
+{
+    [[nodiscard]] static bool get(const uint8_t p, const uint8_t mask) { return (p & mask) != 0; }
+    static void set(uint8_t &p, const uint8_t mask, const bool value) { p = value ? (p | mask) : (p & ~mask); }
+    static void setNZ(uint8_t &p, const uint8_t value)
+    {
+        p = (p & ~(CPU6502::kZero | CPU6502::kNegative)) |
+            (value == 0 ? CPU6502::kZero : 0) | (value & CPU6502::kNegative);
+    }
+    [[nodiscard]] static uint8_t pack(const uint8_t p) { return p; }
+    static void unpack(uint8_t &p, const uint8_t value) { p = value; }
+};
+
+/**
+ * @struct LazyFlags
+ * @brief N/Z/C/V kept in their cheapest form and packed into P on demand
+ *
+ * N and Z are derived from the last result byte (N is its bit 7, Z is set
+ * when it is zero); C and V are kept as plain booleans. An ALU op then costs
+ * one byte store instead of two read-modify-writes of P. BIT and TRB/TSB set
+ * N and Z independently, so they get separate source bytes. P itself is only
+ * rebuilt when it is observed (PHP, BRK, interrupts, end of a batch); the
+ * I, D, B and unused bits stay in reg.P.
+ */
+struct LazyFlags
+{
+    static constexpr uint8_t kLazyMask = CPU6502::kNegative | CPU6502::kOverflow | CPU6502::kZero | CPU6502::kCarry;
+
+    uint8_t n_source = 0;  ///< N is bit 7
+    uint8_t z_source = 1;  ///< Z is set when zero
+    bool carry = false;
+    bool overflow = false;
+
+    [[nodiscard]] bool get(const uint8_t p, const uint8_t mask) const
+    {
+        switch (mask)
+        {
+            case CPU6502::kNegative: return (n_source & 0x80) != 0;
+            case CPU6502::kZero: return z_source == 0;
+            case CPU6502::kCarry: return carry;
+            case CPU6502::kOverflow: return overflow;
+            default: return (p & mask) != 0;
+        }
+    }
+
+    void set(uint8_t &p, const uint8_t mask, const bool value)
+    {
+        switch (mask)
+        {
+            case CPU6502::kNegative: n_source = value ? 0x80 : 0x00; break;
+            case CPU6502::kZero: z_source = value ? 0 : 1; break;
+            case CPU6502::kCarry: carry = value; break;
+            case CPU6502::kOverflow: overflow = value; break;
+            default: p = value ? (p | mask) : (p & ~mask); break;
+        }
+    }
+
+    void setNZ(uint8_t &, const uint8_t value)
+    {
+        n_source = value;
+        z_source = value;
+    }
+
+    [[nodiscard]] uint8_t pack(const uint8_t p) const
+    {
+        return (p & ~kLazyMask) | (n_source & CPU6502::kNegative) | (overflow ? CPU6502::kOverflow : 0) |
+               (z_source == 0 ? CPU6502::kZero : 0) | (carry ? CPU6502::kCarry : 0);
+    }
+
+    void unpack(uint8_t &p, const uint8_t value)
+    {
+        p = value & ~kLazyMask;
+        n_source = value & CPU6502::kNegative;
+        z_source = (value & CPU6502::kZero) ? 0 : 1;
+        carry = (value & CPU6502::kCarry) != 0;
+        overflow = (value & CPU6502::kOverflow) != 0;
+    }
+};
+
+/// Halt requested by the instruction just executed (WAI or STP).
+enum class Halt : uint8_t
+{
+    None,
+    Wait,   ///< WAI: until IRQ or NMI is asserted
+    Stop,   ///< STP: until reset
+};
+
+/**
+ * @struct BasicContext
+ * @brief Execution context: registers, cycle counter and the memory bus
+ *
+ * The context is what operation bodies see; any type with the same members
+ * can be used in its place. The program counter points just past the opcode
+ * byte while an instruction executes. Stack operations do not count cycles;
+ * the per-opcode cycle count in the table already includes them.
+ *
+ * Operations reach the status register only through flag(), setFlag(),
+ * setNZ(), status() and setStatus(), so the flag storage is a policy. With
+ * LazyFlags, reg.P is incomplete while the context is live: seed it with
+ * setStatus(reg.P) and read it back with status().
+ *
+ * @tparam Regs   CPU6502::Registers, by reference or by value
+ * @tparam Cycles uint64_t, by reference or by value
+ * @tparam Flags  PackedFlags or LazyFlags
+ */
+template <class Regs, class Cycles, class Flags = PackedFlags>
+struct BasicContext
+{
+    Memory &mem;
+    Regs reg;
+    Cycles cycles;
+    Flags flags{};
+    Halt halt = Halt::None;     ///< Set by WAI/STP; the CPU clears it
+
+    uint8_t read(const uint16_t address) { return mem.read(address); }
+    void write(const uint16_t address, const uint8_t value) { mem.write(address, value); }
+
+    /// Operand byte @p index (0 or 1) of the current instruction.
+    uint8_t operand8(const uint8_t index) { return mem.read(static_cast<uint16_t>(reg.PC + index)); }
+    uint16_t operand16() { return operand8(0) | (operand8(1) << 8); }
+
+    [[nodiscard]] bool flag(const uint8_t mask) const { return flags.get(reg.P, mask); }
+    void setFlag(const uint8_t mask, const bool value) { flags.set(reg.P, mask, value); }
+    void setNZ(const uint8_t value) { flags.setNZ(reg.P, value); }
+    [[nodiscard]] uint8_t status() const { return flags.pack(reg.P); }
+    void setStatus(const uint8_t value) { flags.unpack(reg.P, value); }
+
+    void push(const uint8_t value) { mem.write(0x0100 + reg.SP--, value); }
+    uint8_t pull() { return mem.read(0x0100 + ++reg.SP); }
+};
+
+/// A view of the CPU's live registers (single-stepping).
+using Context = BasicContext<CPU6502::Registers &, uint64_t &>;
+
+/// Registers and cycle count copied into locals for a batch (runCycles).
+#ifdef CPU6502_PACKED_FLAGS
+using LocalContext = BasicContext<CPU6502::Registers, uint64_t>;
+#else
+using LocalContext = BasicContext<CPU6502::Registers, uint64_t, LazyFlags>;
+#endif
+
+/**
+ * @struct Operand
+ * @brief Result of addressing-mode resolution
+ */
+struct Operand
+{
+    uint16_t address = 0;       ///< Effective address (branch target for Relative)
+    uint16_t target = 0;        ///< Branch target (ZeroPageRelative only)
+    uint8_t value = 0;          ///< Operand byte (Immediate only)
+    bool page_crossed = false;  ///< Indexing or branch crossed a page boundary
+};
+
+[[nodiscard]] constexpr bool pageCrossed(const uint16_t from, const uint16_t to)
+{
+    return (from & 0xFF00) != (to & 0xFF00);
+}
+
+[[nodiscard]] constexpr uint16_t branchTarget(const uint16_t next_pc, const uint8_t offset)
+{
+    return static_cast<uint16_t>(next_pc + static_cast<int8_t>(offset));
+}
+
+// ---------------------------------------------------------------------------
+// Addressing-mode policies. resolve() reads the operand bytes at PC without
+// advancing it; execute() advances PC by kOperandBytes afterwards.
+// ---------------------------------------------------------------------------
+
+struct ModeTraits
+{
+    static constexpr uint8_t kOperandBytes = 0;
+    static constexpr bool kAccumulator = false;  ///< RMW ops act on A
+    static constexpr bool kImmediate = false;    ///< operand byte is the value
+};
+
+struct Implied : ModeTraits
+{
+    template <class Ctx> static Operand resolve(Ctx &) { return {}; }
+};
+
+struct Accumulator : ModeTraits
+{
+    static constexpr bool kAccumulator = true;
+    template <class Ctx> static Operand resolve(Ctx &) { return {}; }
+};
+
+struct Immediate : ModeTraits
+{
+    static constexpr uint8_t kOperandBytes = 1;
+    static constexpr bool kImmediate = true;
+    template <class Ctx> static Operand resolve(Ctx &c) { return {.address = c.reg.PC, .value = c.operand8(0)}; }
+};
+
+struct ZeroPage : ModeTraits
+{
+    static constexpr uint8_t kOperandBytes = 1;
+    template <class Ctx> static Operand resolve(Ctx &c) { return {.address = c.operand8(0)}; }
+};
+
+struct ZeroPageX : ModeTraits
+{
+    static constexpr uint8_t kOperandBytes = 1;
+    template <class Ctx> static Operand resolve(Ctx &c)
+    {
+        return {.address = static_cast<uint8_t>(c.operand8(0) + c.reg.X)};
+    }
+};
+
+struct ZeroPageY : ModeTraits
+{
+    static constexpr uint8_t kOperandBytes = 1;
+    template <class Ctx> static Operand resolve(Ctx &c)
+    {
+        return {.address = static_cast<uint8_t>(c.operand8(0) + c.reg.Y)};
+    }
+};
+
+/// Read a pointer from zero page; the high byte wraps within page 0.
+template <class Ctx> uint16_t zeroPagePointer(Ctx &c, const uint8_t zp)
+{
+    return c.read(zp) | (c.read(static_cast<uint8_t>(zp + 1)) << 8);
+}
+
+/// 65C02 (zp): the operand names a pointer held at zp/zp+1.
+struct ZeroPageIndirect : ModeTraits
+{
+    static constexpr uint8_t kOperandBytes = 1;
+    template <class Ctx> static Operand resolve(Ctx &c) { return {.address = zeroPagePointer(c, c.operand8(0))}; }
+};
+
+/// (zp,X): pointer at zp+X; no page-crossing penalty.
+struct IndexedIndirect : ModeTraits
+{
+    static constexpr uint8_t kOperandBytes = 1;
+    template <class Ctx> static Operand resolve(Ctx &c)
+    {
+        return {.address = zeroPagePointer(c, static_cast<uint8_t>(c.operand8(0) + c.reg.X))};
+    }
+};
+
+/// (zp),Y: pointer at zp, then indexed by Y.
+struct IndirectIndexed : ModeTraits
+{
+    static constexpr uint8_t kOperandBytes = 1;
+    template <class Ctx> static Operand resolve(Ctx &c)
+    {
+        const uint16_t base = zeroPagePointer(c, c.operand8(0));
+        const auto address = static_cast<uint16_t>(base + c.reg.Y);
+        return {.address = address, .page_crossed = pageCrossed(base, address)};
+    }
+};
+
+struct Absolute : ModeTraits
+{
+    static constexpr uint8_t kOperandBytes = 2;
+    template <class Ctx> static Operand resolve(Ctx &c) { return {.address = c.operand16()}; }
+};
+
+struct AbsoluteX : ModeTraits
+{
+    static constexpr uint8_t kOperandBytes = 2;
+    template <class Ctx> static Operand resolve(Ctx &c)
+    {
+        const uint16_t base = c.operand16();
+        const auto address = static_cast<uint16_t>(base + c.reg.X);
+        return {.address = address, .page_crossed = pageCrossed(base, address)};
+    }
+};
+
+struct AbsoluteY : ModeTraits
+{
+    static constexpr uint8_t kOperandBytes = 2;
+    template <class Ctx> static Operand resolve(Ctx &c)
+    {
+        const uint16_t base = c.operand16();
+        const auto address = static_cast<uint16_t>(base + c.reg.Y);
+        return {.address = address, .page_crossed = pageCrossed(base, address)};
+    }
+};
+
+/// JMP (abs). The pointer is read with a full 16-bit increment (65C02: no
+/// page-wrap bug).
+struct Indirect : ModeTraits
+{
+    static constexpr uint8_t kOperandBytes = 2;
+    template <class Ctx> static Operand resolve(Ctx &c)
+    {
+        const uint16_t pointer = c.operand16();
+        return {.address = static_cast<uint16_t>(c.read(pointer) | (c.read(pointer + 1) << 8))};
+    }
+};
+
+/// 65C02 JMP (abs,X).
+struct AbsoluteIndexedIndirect : ModeTraits
+{
+    static constexpr uint8_t kOperandBytes = 2;
+    template <class Ctx> static Operand resolve(Ctx &c)
+    {
+        const auto pointer = static_cast<uint16_t>(c.operand16() + c.reg.X);
+        return {.address = static_cast<uint16_t>(c.read(pointer) | (c.read(pointer + 1) << 8))};
+    }
+};
+
+/// Branches: address is the target; page_crossed compares it with the
+/// address of the next instruction.
+struct Relative : ModeTraits
+{
+    static constexpr uint8_t kOperandBytes = 1;
+    template <class Ctx> static Operand resolve(Ctx &c)
+    {
+        const auto next = static_cast<uint16_t>(c.reg.PC + kOperandBytes);
+        const uint16_t target = branchTarget(next, c.operand8(0));
+        return {.address = target, .page_crossed = pageCrossed(next, target)};
+    }
+};
+
+/// BBR/BBS zp,rel: address is the zero-page byte, target the branch target.
+struct ZeroPageRelative : ModeTraits
+{
+    static constexpr uint8_t kOperandBytes = 2;
+    template <class Ctx> static Operand resolve(Ctx &c)
+    {
+        const auto next = static_cast<uint16_t>(c.reg.PC + kOperandBytes);
+        return {.address = c.operand8(0), .target = branchTarget(next, c.operand8(1))};
+    }
+};
+
+/// Undefined 65C02 opcodes: deterministic NOPs that skip 0, 1 or 2 operand
+/// bytes without touching memory.
+template <uint8_t Bytes>
+struct UndefinedNop : ModeTraits
+{
+    static constexpr uint8_t kOperandBytes = Bytes;
+    template <class Ctx> static Operand resolve(Ctx &) { return {}; }
+};
+using Undefined1 = UndefinedNop<0>;
+using Undefined2 = UndefinedNop<1>;
+using Undefined3 = UndefinedNop<2>;
+
+// ---------------------------------------------------------------------------
+// Operand access shared by the operation functors
+// ---------------------------------------------------------------------------
+
+/// Value of a read operand: the immediate byte or the byte at the address.
+template <class Mode, class Ctx> uint8_t load(Ctx &c, const Operand &o)
+{
+    if constexpr (Mode::kImmediate)
+        return o.value;
+    else
+        return c.read(o.address);
+}
+
+/// Read-modify-write source: A in accumulator mode, memory otherwise.
+template <class Mode, class Ctx> uint8_t loadRmw(Ctx &c, const Operand &o)
+{
+    if constexpr (Mode::kAccumulator)
+        return c.reg.A;
+    else
+        return c.read(o.address);
+}
+
+template <class Mode, class Ctx> void storeRmw(Ctx &c, const Operand &o, const uint8_t value)
+{
+    if constexpr (Mode::kAccumulator)
+        c.reg.A = value;
+    else
+        c.write(o.address, value);
+}
+
+template <class Ctx> void push16(Ctx &c, const uint16_t value)
+{
+    c.push(static_cast<uint8_t>(value >> 8));    // MSB first
+    c.push(static_cast<uint8_t>(value & 0xFF));
+}
+
+template <class Ctx> uint16_t pull16(Ctx &c)
+{
+    const uint8_t low = c.pull();                // LSB first
+    const uint8_t high = c.pull();
+    return static_cast<uint16_t>((high << 8) | low);
+}
+
+// ---------------------------------------------------------------------------
+// ALU
+// ---------------------------------------------------------------------------
+
+/// A + M + C. Sets C and V; the caller sets N and Z from the result.
+template <class Ctx> uint8_t addWithCarry(Ctx &c, const uint8_t val1, const uint8_t val2)
+{
+    const int carry_in = c.flag(CPU6502::kCarry) ? 1 : 0;
+
+    if (c.flag(CPU6502::kDecimal))
+    {
+        // 65C02 BCD add — a faithful port of the documented hardware algorithm
+        // (http://www.6502.org/tutorials/decimal_mode.html, appendix B), so the
+        // result/flags match a real W65C02S even for invalid BCD inputs
+        // (validated against the Klaus2m5/amb5l decimal test, cputype=65C02).
+        // N and Z are set from the final result by the caller; C and V here.
+        bool carry = carry_in != 0;
+        int t = (val1 & 0x0F) + (val2 & 0x0F) + (carry ? 1 : 0);
+        uint8_t a = static_cast<uint8_t>(t);
+        int x = 0;
+        if (a >= 0x0A)                       // low nibble decimal-adjusts
+        {
+            x = 1;
+            a = static_cast<uint8_t>(a + 5 + 1) & 0x0F;   // adc #5 (compare set carry)
+            carry = true;                                  // sec
+        }
+        else
+        {
+            carry = false;
+        }
+        a |= (val1 & 0xF0);
+        const uint8_t hi_operand = x ? ((val2 & 0xF0) | 0x0F) : (val2 & 0xF0);
+        const uint8_t a_before = a;
+        t = a + hi_operand + (carry ? 1 : 0);
+        a = static_cast<uint8_t>(t);
+        carry = t > 0xFF;
+
+        // V is the overflow of this high-nibble add, before the +$60 adjust.
+        c.setFlag(CPU6502::kOverflow, ((~(a_before ^ hi_operand) & (a_before ^ a)) & 0x80) != 0);
+
+        if (carry || a >= 0xA0)              // high nibble decimal-adjusts (+$60)
+        {
+            a = static_cast<uint8_t>(a + 0x5F + 1);
+            carry = true;
+        }
+        c.setFlag(CPU6502::kCarry, carry);
+        return a;
+    }
+
+    // Binary mode: A + M + C.
+    // V is set when both operands have the same sign but the result's sign
+    // differs (signed overflow): ~(val1^val2) & (val1^result) & $80.
+    const uint16_t result = val1 + val2 + carry_in;
+    const uint8_t res8 = result & 0xFF;
+    c.setFlag(CPU6502::kCarry, (result > 0xFF));
+    c.setFlag(CPU6502::kOverflow, ((~(val1 ^ val2) & (val1 ^ res8)) & 0x80) != 0);
+    return res8;
+}
+
+/// A - M - !C. Sets C and V; the caller sets N and Z from the result.
+template <class Ctx> uint8_t subtractWithBorrow(Ctx &c, const uint8_t val1, const uint8_t val2)
+{
+    const int carry_in = c.flag(CPU6502::kCarry) ? 1 : 0;
+
+    // Carry and overflow derive from the binary subtraction in BOTH decimal and
+    // binary modes (this matches real 6502/65C02 SBC behaviour). Carry is set
+    // when there is no borrow; V on signed overflow:
+    // (val1^val2) & (val1^result) & $80.
+    const int bin = val1 - val2 - (1 - carry_in);
+    const uint8_t res8 = static_cast<uint8_t>(bin);
+    c.setFlag(CPU6502::kCarry, bin >= 0);
+    c.setFlag(CPU6502::kOverflow, (((val1 ^ val2) & (val1 ^ res8)) & 0x80) != 0);
+
+    if (c.flag(CPU6502::kDecimal))
+    {
+        // 65C02 BCD subtract — faithful port of the documented hardware
+        // algorithm (matches a real W65C02S for invalid BCD too). On the 65C02,
+        // SBC takes V and C from the binary subtraction above; only the
+        // accumulator result is decimal-adjusted here (N and Z come from it).
+        bool dcarry = carry_in != 0;
+        int t = (val1 & 0x0F) - (val2 & 0x0F) - (dcarry ? 0 : 1);
+        uint8_t a = static_cast<uint8_t>(t);
+        int x = 0;
+        if (t < 0)                           // low nibble borrowed
+        {
+            x = 1;
+            a &= 0x0F;
+            dcarry = false;                  // clc
+        }
+        else
+        {
+            dcarry = true;
+        }
+        a |= (val1 & 0xF0);
+        const uint8_t hi_operand = x ? ((val2 & 0xF0) | 0x0F) : (val2 & 0xF0);
+        t = a - hi_operand - (dcarry ? 0 : 1);
+        a = static_cast<uint8_t>(t);
+        dcarry = (t >= 0);
+        if (!dcarry)                         // sbc #$5F  (-$60)
+        {
+            t = a - 0x5F - 1;
+            a = static_cast<uint8_t>(t);
+            dcarry = (t >= 0);
+        }
+        if (x != 0)                          // extra -6 when the low nibble borrowed
+        {
+            // The hardware does `cpx #0` (which always sets carry) before this
+            // SBC, so there is never a borrow-in here.
+            a = static_cast<uint8_t>(a - 6);
+        }
+        return a;
+    }
+
+    return res8;
+}
+
+/// CMP/CPX/CPY: flags from (val1 - val2).
+template <class Ctx> void compare(Ctx &c, const uint8_t val1, const uint8_t val2)
+{
+    // N must come from bit 7 of the 8-bit difference, NOT from val1 itself,
+    // otherwise CMP-then-BMI/BPL idioms (e.g. EhBASIC's FP exponent alignment)
+    // branch the wrong way.
+    c.setFlag(CPU6502::kCarry, val1 >= val2);
+    c.setNZ(static_cast<uint8_t>(val1 - val2));
+}
+
+// ---------------------------------------------------------------------------
+// Operation functors. apply() runs after the operand is resolved and PC has
+// been advanced past it; control-flow ops overwrite PC.
+// ---------------------------------------------------------------------------
+
+struct OpTraits
+{
+    static constexpr bool kPagePenalty = false;  ///< +1 cycle on indexed page cross
+};
+
+struct ReadOp : OpTraits
+{
+    static constexpr bool kPagePenalty = true;
+};
+
+// Loads and ALU ops (+1 cycle when indexing crosses a page)
+struct Lda : ReadOp { template <class M, class C> static void apply(C &c, const Operand &o) { c.reg.A = load<M>(c, o); c.setNZ(c.reg.A); } };
+struct Ldx : ReadOp { template <class M, class C> static void apply(C &c, const Operand &o) { c.reg.X = load<M>(c, o); c.setNZ(c.reg.X); } };
+struct Ldy : ReadOp { template <class M, class C> static void apply(C &c, const Operand &o) { c.reg.Y = load<M>(c, o); c.setNZ(c.reg.Y); } };
+struct And : ReadOp { template <class M, class C> static void apply(C &c, const Operand &o) { c.reg.A &= load<M>(c, o); c.setNZ(c.reg.A); } };
+struct Ora : ReadOp { template <class M, class C> static void apply(C &c, const Operand &o) { c.reg.A |= load<M>(c, o); c.setNZ(c.reg.A); } };
+struct Eor : ReadOp { template <class M, class C> static void apply(C &c, const Operand &o) { c.reg.A ^= load<M>(c, o); c.setNZ(c.reg.A); } };
+struct Adc : ReadOp { template <class M, class C> static void apply(C &c, const Operand &o) { c.reg.A = addWithCarry(c, c.reg.A, load<M>(c, o)); c.setNZ(c.reg.A); } };
+struct Sbc : ReadOp { template <class M, class C> static void apply(C &c, const Operand &o) { c.reg.A = subtractWithBorrow(c, c.reg.A, load<M>(c, o)); c.setNZ(c.reg.A); } };
+struct Cmp : ReadOp { template <class M, class C> static void apply(C &c, const Operand &o) { compare(c, c.reg.A, load<M>(c, o)); } };
+struct Cpx : ReadOp { template <class M, class C> static void apply(C &c, const Operand &o) { compare(c, c.reg.X, load<M>(c, o)); } };
+struct Cpy : ReadOp { template <class M, class C> static void apply(C &c, const Operand &o) { compare(c, c.reg.Y, load<M>(c, o)); } };
+
+/// BIT: Z from A & M; N and V from M, except BIT #imm which only sets Z.
+struct Bit : ReadOp
+{
+    template <class M, class C> static void apply(C &c, const Operand &o)
+    {
+        const uint8_t val = load<M>(c, o);
+        c.setFlag(CPU6502::kZero, (c.reg.A & val) == 0);
+        if constexpr (!M::kImmediate)
+        {
+            c.setFlag(CPU6502::kNegative, (val & 0x80) != 0);
+            c.setFlag(CPU6502::kOverflow, (val & 0x40) != 0);
+        }
+    }
+};
+
+// Stores
+struct Sta : OpTraits { template <class M, class C> static void apply(C &c, const Operand &o) { c.write(o.address, c.reg.A); } };
+struct Stx : OpTraits { template <class M, class C> static void apply(C &c, const Operand &o) { c.write(o.address, c.reg.X); } };
+struct Sty : OpTraits { template <class M, class C> static void apply(C &c, const Operand &o) { c.write(o.address, c.reg.Y); } };
+struct Stz : OpTraits { template <class M, class C> static void apply(C &c, const Operand &o) { c.write(o.address, 0x00); } };
+
+// Read-modify-write (memory or accumulator)
+struct Asl : OpTraits
+{
+    template <class M, class C> static void apply(C &c, const Operand &o)
+    {
+        const uint8_t val = loadRmw<M>(c, o);
+        c.setFlag(CPU6502::kCarry, (val & 0x80) != 0);
+        const auto result = static_cast<uint8_t>(val << 1);
+        storeRmw<M>(c, o, result);
+        c.setNZ(result);
+    }
+};
+
+struct Lsr : OpTraits
+{
+    template <class M, class C> static void apply(C &c, const Operand &o)
+    {
+        const uint8_t val = loadRmw<M>(c, o);
+        c.setFlag(CPU6502::kCarry, (val & 0x01) != 0);
+        const auto result = static_cast<uint8_t>(val >> 1);
+        storeRmw<M>(c, o, result);
+        c.setNZ(result);
+    }
+};
+
+struct Rol : OpTraits
+{
+    template <class M, class C> static void apply(C &c, const Operand &o)
+    {
+        const uint8_t val = loadRmw<M>(c, o);
+        const uint8_t carry_in = c.flag(CPU6502::kCarry) ? 0x01 : 0x00;
+        c.setFlag(CPU6502::kCarry, (val & 0x80) != 0);
+        const auto result = static_cast<uint8_t>((val << 1) | carry_in);
+        storeRmw<M>(c, o, result);
+        c.setNZ(result);
+    }
+};
+
+struct Ror : OpTraits
+{
+    template <class M, class C> static void apply(C &c, const Operand &o)
+    {
+        const uint8_t val = loadRmw<M>(c, o);
+        const uint8_t carry_in = c.flag(CPU6502::kCarry) ? 0x80 : 0x00;
+        c.setFlag(CPU6502::kCarry, (val & 0x01) != 0);
+        const auto result = static_cast<uint8_t>((val >> 1) | carry_in);
+        storeRmw<M>(c, o, result);
+        c.setNZ(result);
+    }
+};
+
+struct Inc : OpTraits
+{
+    template <class M, class C> static void apply(C &c, const Operand &o)
+    {
+        const auto result = static_cast<uint8_t>(loadRmw<M>(c, o) + 1);
+        storeRmw<M>(c, o, result);
+        c.setNZ(result);
+    }
+};
+
+struct Dec : OpTraits
+{
+    template <class M, class C> static void apply(C &c, const Operand &o)
+    {
+        const auto result = static_cast<uint8_t>(loadRmw<M>(c, o) - 1);
+        storeRmw<M>(c, o, result);
+        c.setNZ(result);
+    }
+};
+
+/// TSB/TRB: Z from A & M, then set/reset the A bits in memory.
+template <bool Set>
+struct TestBits : OpTraits
+{
+    template <class M, class C> static void apply(C &c, const Operand &o)
+    {
+        const uint8_t val = c.read(o.address);
+        c.setFlag(CPU6502::kZero, (c.reg.A & val) == 0);
+        c.write(o.address, Set ? (val | c.reg.A) : (val & ~c.reg.A));
+    }
+};
+using Tsb = TestBits<true>;
+using Trb = TestBits<false>;
+
+/// Rockwell/WDC RMBn/SMBn: reset/set bit n of a zero-page byte; no flags.
+template <bool Set, uint8_t Bit>
+struct MemoryBit : OpTraits
+{
+    template <class M, class C> static void apply(C &c, const Operand &o)
+    {
+        const uint8_t val = c.read(o.address);
+        c.write(o.address, static_cast<uint8_t>(Set ? (val | (1u << Bit)) : (val & ~(1u << Bit))));
+    }
+};
+template <uint8_t Bit> using Rmb = MemoryBit<false, Bit>;
+template <uint8_t Bit> using Smb = MemoryBit<true, Bit>;
+
+/// Rockwell/WDC BBRn/BBSn: branch if bit n of a zero-page byte is reset/set.
+/// Fixed cost; no taken-branch penalty.
+template <bool Set, uint8_t Bit>
+struct BranchOnBit : OpTraits
+{
+    template <class M, class C> static void apply(C &c, const Operand &o)
+    {
+        if (((c.read(o.address) & (1u << Bit)) != 0) == Set)
+            c.reg.PC = o.target;
+    }
+};
+template <uint8_t Bit> using Bbr = BranchOnBit<false, Bit>;
+template <uint8_t Bit> using Bbs = BranchOnBit<true, Bit>;
+
+// Branches: +1 cycle when taken, +1 more when the target is on another page.
+template <uint8_t Flag, bool Set>
+struct Branch : OpTraits
+{
+    template <class M, class C> static void apply(C &c, const Operand &o)
+    {
+        if (c.flag(Flag) == Set)
+        {
+            c.reg.PC = o.address;
+            c.cycles += 1 + (o.page_crossed ? 1 : 0);
+        }
+    }
+};
+using Bcc = Branch<CPU6502::kCarry, false>;
+using Bcs = Branch<CPU6502::kCarry, true>;
+using Bne = Branch<CPU6502::kZero, false>;
+using Beq = Branch<CPU6502::kZero, true>;
+using Bpl = Branch<CPU6502::kNegative, false>;
+using Bmi = Branch<CPU6502::kNegative, true>;
+using Bvc = Branch<CPU6502::kOverflow, false>;
+using Bvs = Branch<CPU6502::kOverflow, true>;
+
+/// BRA: always taken; only the page-cross cycle is variable.
+struct Bra : ReadOp
+{
+    template <class M, class C> static void apply(C &c, const Operand &o) { c.reg.PC = o.address; }
+};
+
+// Jumps and subroutines
+struct Jmp : OpTraits
+{
+    template <class M, class C> static void apply(C &c, const Operand &o) { c.reg.PC = o.address; }
+};
+
+/// JSR pushes the address of its own last byte.
+struct Jsr : OpTraits
+{
+    template <class M, class C> static void apply(C &c, const Operand &o)
+    {
+        push16(c, static_cast<uint16_t>(c.reg.PC - 1));
+        c.reg.PC = o.address;
+    }
+};
+
+struct Rts : OpTraits
+{
+    template <class M, class C> static void apply(C &c, const Operand &) { c.reg.PC = static_cast<uint16_t>(pull16(c) + 1); }
+};
+
+/// RTI: B and U are not real flags; U always reads back set.
+struct Rti : OpTraits
+{
+    template <class M, class C> static void apply(C &c, const Operand &)
+    {
+        c.setStatus((c.pull() & ~(CPU6502::kBreak | CPU6502::kUnused)) | CPU6502::kUnused);
+        c.reg.PC = pull16(c);
+    }
+};
+
+/// BRK pushes BRK+2 (it skips a signature byte) and the status with B set,
+/// then vectors through $FFFE. The 65C02 also clears D (the NMOS 6502 does not).
+struct Brk : OpTraits
+{
+    template <class M, class C> static void apply(C &c, const Operand &)
+    {
+        c.reg.PC += 1;
+        c.setFlag(CPU6502::kBreak, true);
+        push16(c, c.reg.PC);
+        c.push(c.status());
+        c.setFlag(CPU6502::kInterrupt, true);
+        c.setFlag(CPU6502::kDecimal, false);
+        c.reg.PC = static_cast<uint16_t>(c.read(0xFFFE) | (c.read(0xFFFF) << 8));
+    }
+};
+
+// Flag set/clear
+template <uint8_t Flag, bool Value>
+struct FlagOp : OpTraits
+{
+    template <class M, class C> static void apply(C &c, const Operand &) { c.setFlag(Flag, Value); }
+};
+using Clc = FlagOp<CPU6502::kCarry, false>;
+using Sec = FlagOp<CPU6502::kCarry, true>;
+using Cli = FlagOp<CPU6502::kInterrupt, false>;
+using Sei = FlagOp<CPU6502::kInterrupt, true>;
+using Cld = FlagOp<CPU6502::kDecimal, false>;
+using Sed = FlagOp<CPU6502::kDecimal, true>;
+using Clv = FlagOp<CPU6502::kOverflow, false>;
+
+// Stack
+struct Pha : OpTraits { template <class M, class C> static void apply(C &c, const Operand &) { c.push(c.reg.A); } };
+struct Phx : OpTraits { template <class M, class C> static void apply(C &c, const Operand &) { c.push(c.reg.X); } };
+struct Phy : OpTraits { template <class M, class C> static void apply(C &c, const Operand &) { c.push(c.reg.Y); } };
+struct Pla : OpTraits { template <class M, class C> static void apply(C &c, const Operand &) { c.reg.A = c.pull(); c.setNZ(c.reg.A); } };
+struct Plx : OpTraits { template <class M, class C> static void apply(C &c, const Operand &) { c.reg.X = c.pull(); c.setNZ(c.reg.X); } };
+struct Ply : OpTraits { template <class M, class C> static void apply(C &c, const Operand &) { c.reg.Y = c.pull(); c.setNZ(c.reg.Y); } };
+
+/// PHP: B and U are set in the pushed copy.
+struct Php : OpTraits
+{
+    template <class M, class C> static void apply(C &c, const Operand &)
+    {
+        c.push(c.status() | CPU6502::kBreak | CPU6502::kUnused);
+    }
+};
+
+struct Plp : OpTraits
+{
+    template <class M, class C> static void apply(C &c, const Operand &)
+    {
+        c.setStatus((c.pull() & ~(CPU6502::kBreak | CPU6502::kUnused)) | CPU6502::kUnused);
+    }
+};
+
+// Register transfers and increments
+struct Tax : OpTraits { template <class M, class C> static void apply(C &c, const Operand &) { c.reg.X = c.reg.A; c.setNZ(c.reg.X); } };
+struct Tay : OpTraits { template <class M, class C> static void apply(C &c, const Operand &) { c.reg.Y = c.reg.A; c.setNZ(c.reg.Y); } };
+struct Txa : OpTraits { template <class M, class C> static void apply(C &c, const Operand &) { c.reg.A = c.reg.X; c.setNZ(c.reg.A); } };
+struct Tya : OpTraits { template <class M, class C> static void apply(C &c, const Operand &) { c.reg.A = c.reg.Y; c.setNZ(c.reg.A); } };
+struct Tsx : OpTraits { template <class M, class C> static void apply(C &c, const Operand &) { c.reg.X = c.reg.SP; c.setNZ(c.reg.X); } };
+struct Txs : OpTraits { template <class M, class C> static void apply(C &c, const Operand &) { c.reg.SP = c.reg.X; } };
+struct Inx : OpTraits { template <class M, class C> static void apply(C &c, const Operand &) { c.setNZ(++c.reg.X); } };
+struct Iny : OpTraits { template <class M, class C> static void apply(C &c, const Operand &) { c.setNZ(++c.reg.Y); } };
+struct Dex : OpTraits { template <class M, class C> static void apply(C &c, const Operand &) { c.setNZ(--c.reg.X); } };
+struct Dey : OpTraits { template <class M, class C> static void apply(C &c, const Operand &) { c.setNZ(--c.reg.Y); } };
+
+struct Nop : OpTraits
+{
+    template <class M, class C> static void apply(C &, const Operand &) {}
+};
+
+/// STP/WAI: request the halt; the CPU stops executing after the instruction.
+struct Stp : OpTraits { template <class M, class C> static void apply(C &c, const Operand &) { c.halt = Halt::Stop; } };
+struct Wai : OpTraits { template <class M, class C> static void apply(C &c, const Operand &) { c.halt = Halt::Wait; } };
+
+/**
+ * @brief Hardware interrupt entry (IRQ/NMI): push PC and the status with B
+ *        clear, set I, clear D (65C02), then vector through @p vector
+ * @note Charges 10 cycles: 7 for the sequence plus the three pushes.
+ */
+template <class Ctx> void interrupt(Ctx &c, const uint16_t vector)
+{
+    push16(c, c.reg.PC);
+    c.push((c.status() & ~CPU6502::kBreak) | CPU6502::kUnused);
+    c.setFlag(CPU6502::kInterrupt, true);
+    c.setFlag(CPU6502::kDecimal, false);
+    c.reg.PC = static_cast<uint16_t>(c.read(vector) | (c.read(vector + 1) << 8));
+    c.cycles += 10;
+}
+
+/**
+ * @brief Execute one instruction whose opcode byte has already been fetched
+ *
+ * Resolves the operand, advances PC past it, applies the operation and
+ * charges @p Cycles (plus the page-cross cycle for read operations).
+ * @p Cycles counts everything after the opcode fetch, which the caller
+ * charges.
+ */
+template <class Op, class Mode, unsigned Cycles, class Ctx>
+inline void execute(Ctx &c)
+{
+    const Operand o = Mode::resolve(c);
+    c.reg.PC += Mode::kOperandBytes;
+    Op::template apply<Mode>(c, o);
+    if constexpr (Op::kPagePenalty)
+        c.cycles += Cycles + (o.page_crossed ? 1 : 0);
+    else
+        c.cycles += Cycles;
+}
+
+/**
+ * @def CPU6502_OPCODE_TABLE
+ * @brief The W65C02S instruction set, one X(opcode, Operation, Mode, Cycles)
+ *        entry per opcode in opcode order
+ *
+ * Cycles is the count charged after the opcode fetch, including operand
+ * fetches, stack traffic and the not-taken branch cost. Undefined opcodes are
+ * deterministic 1-, 2- and 3-byte NOPs (Undefined1/2/3).
+ */
+#define CPU6502_OPCODE_TABLE(X) \
+    X(0x00, Brk,     Implied,                  10) \
+    X(0x01, Ora,     IndexedIndirect,           6) \
+    X(0x02, Nop,     Undefined2,                2) \
+    X(0x03, Nop,     Undefined1,                2) \
+    X(0x04, Tsb,     ZeroPage,                  5) \
+    X(0x05, Ora,     ZeroPage,                  3) \
+    X(0x06, Asl,     ZeroPage,                  5) \
+    X(0x07, Rmb<0>,  ZeroPage,                  5) \
+    X(0x08, Php,     Implied,                   3) \
+    X(0x09, Ora,     Immediate,                 2) \
+    X(0x0A, Asl,     Accumulator,               2) \
+    X(0x0B, Nop,     Undefined1,                2) \
+    X(0x0C, Tsb,     Absolute,                  6) \
+    X(0x0D, Ora,     Absolute,                  4) \
+    X(0x0E, Asl,     Absolute,                  6) \
+    X(0x0F, Bbr<0>,  ZeroPageRelative,          5) \
+    X(0x10, Bpl,     Relative,                  3) \
+    X(0x11, Ora,     IndirectIndexed,           5) \
+    X(0x12, Ora,     ZeroPageIndirect,          5) \
+    X(0x13, Nop,     Undefined1,                2) \
+    X(0x14, Trb,     ZeroPage,                  5) \
+    X(0x15, Ora,     ZeroPageX,                 4) \
+    X(0x16, Asl,     ZeroPageX,                 6) \
+    X(0x17, Rmb<1>,  ZeroPage,                  5) \
+    X(0x18, Clc,     Implied,                   2) \
+    X(0x19, Ora,     AbsoluteY,                 4) \
+    X(0x1A, Inc,     Accumulator,               2) \
+    X(0x1B, Nop,     Undefined1,                2) \
+    X(0x1C, Trb,     Absolute,                  6) \
+    X(0x1D, Ora,     AbsoluteX,                 4) \
+    X(0x1E, Asl,     AbsoluteX,                 7) \
+    X(0x1F, Bbr<1>,  ZeroPageRelative,          5) \
+    X(0x20, Jsr,     Absolute,                 10) \
+    X(0x21, And,     IndexedIndirect,           6) \
+    X(0x22, Nop,     Undefined2,                2) \
+    X(0x23, Nop,     Undefined1,                2) \
+    X(0x24, Bit,     ZeroPage,                  3) \
+    X(0x25, And,     ZeroPage,                  3) \
+    X(0x26, Rol,     ZeroPage,                  5) \
+    X(0x27, Rmb<2>,  ZeroPage,                  5) \
+    X(0x28, Plp,     Implied,                   4) \
+    X(0x29, And,     Immediate,                 2) \
+    X(0x2A, Rol,     Accumulator,               2) \
+    X(0x2B, Nop,     Undefined1,                2) \
+    X(0x2C, Bit,     Absolute,                  4) \
+    X(0x2D, And,     Absolute,                  4) \
+    X(0x2E, Rol,     Absolute,                  6) \
+    X(0x2F, Bbr<2>,  ZeroPageRelative,          5) \
+    X(0x30, Bmi,     Relative,                  3) \
+    X(0x31, And,     IndirectIndexed,           5) \
+    X(0x32, And,     ZeroPageIndirect,          5) \
+    X(0x33, Nop,     Undefined1,                2) \
+    X(0x34, Bit,     ZeroPageX,                 4) \
+    X(0x35, And,     ZeroPageX,                 4) \
+    X(0x36, Rol,     ZeroPageX,                 6) \
+    X(0x37, Rmb<3>,  ZeroPage,                  5) \
+    X(0x38, Sec,     Implied,                   2) \
+    X(0x39, And,     AbsoluteY,                 4) \
+    X(0x3A, Dec,     Accumulator,               2) \
+    X(0x3B, Nop,     Undefined1,                2) \
+    X(0x3C, Bit,     AbsoluteX,                 4) \
+    X(0x3D, And,     AbsoluteX,                 4) \
+    X(0x3E, Rol,     AbsoluteX,                 7) \
+    X(0x3F, Bbr<3>,  ZeroPageRelative,          5) \
+    X(0x40, Rti,     Implied,                   9) \
+    X(0x41, Eor,     IndexedIndirect,           6) \
+    X(0x42, Nop,     Undefined2,                2) \
+    X(0x43, Nop,     Undefined1,                2) \
+    X(0x44, Nop,     Undefined2,                2) \
+    X(0x45, Eor,     ZeroPage,                  3) \
+    X(0x46, Lsr,     ZeroPage,                  5) \
+    X(0x47, Rmb<4>,  ZeroPage,                  5) \
+    X(0x48, Pha,     Implied,                   3) \
+    X(0x49, Eor,     Immediate,                 2) \
+    X(0x4A, Lsr,     Accumulator,               2) \
+    X(0x4B, Nop,     Undefined1,                2) \
+    X(0x4C, Jmp,     Absolute,                  5) \
+    X(0x4D, Eor,     Absolute,                  4) \
+    X(0x4E, Lsr,     Absolute,                  6) \
+    X(0x4F, Bbr<4>,  ZeroPageRelative,          5) \
+    X(0x50, Bvc,     Relative,                  3) \
+    X(0x51, Eor,     IndirectIndexed,           5) \
+    X(0x52, Eor,     ZeroPageIndirect,          5) \
+    X(0x53, Nop,     Undefined1,                2) \
+    X(0x54, Nop,     Undefined2,                2) \
+    X(0x55, Eor,     ZeroPageX,                 4) \
+    X(0x56, Lsr,     ZeroPageX,                 6) \
+    X(0x57, Rmb<5>,  ZeroPage,                  5) \
+    X(0x58, Cli,     Implied,                   2) \
+    X(0x59, Eor,     AbsoluteY,                 4) \
+    X(0x5A, Phy,     Implied,                   4) \
+    X(0x5B, Nop,     Undefined1,                2) \
+    X(0x5C, Nop,     Undefined3,                4) \
+    X(0x5D, Eor,     AbsoluteX,                 4) \
+    X(0x5E, Lsr,     AbsoluteX,                 7) \
+    X(0x5F, Bbr<5>,  ZeroPageRelative,          5) \
+    X(0x60, Rts,     Implied,                   8) \
+    X(0x61, Adc,     IndexedIndirect,           6) \
+    X(0x62, Nop,     Undefined2,                2) \
+    X(0x63, Nop,     Undefined1,                2) \
+    X(0x64, Stz,     ZeroPage,                  3) \
+    X(0x65, Adc,     ZeroPage,                  3) \
+    X(0x66, Ror,     ZeroPage,                  5) \
+    X(0x67, Rmb<6>,  ZeroPage,                  5) \
+    X(0x68, Pla,     Implied,                   4) \
+    X(0x69, Adc,     Immediate,                 2) \
+    X(0x6A, Ror,     Accumulator,               2) \
+    X(0x6B, Nop,     Undefined1,                2) \
+    X(0x6C, Jmp,     Indirect,                  8) \
+    X(0x6D, Adc,     Absolute,                  4) \
+    X(0x6E, Ror,     Absolute,                  6) \
+    X(0x6F, Bbr<6>,  ZeroPageRelative,          5) \
+    X(0x70, Bvs,     Relative,                  3) \
+    X(0x71, Adc,     IndirectIndexed,           5) \
+    X(0x72, Adc,     ZeroPageIndirect,          5) \
+    X(0x73, Nop,     Undefined1,                2) \
+    X(0x74, Stz,     ZeroPageX,                 4) \
+    X(0x75, Adc,     ZeroPageX,                 4) \
+    X(0x76, Ror,     ZeroPageX,                 6) \
+    X(0x77, Rmb<7>,  ZeroPage,                  5) \
+    X(0x78, Sei,     Implied,                   2) \
+    X(0x79, Adc,     AbsoluteY,                 4) \
+    X(0x7A, Ply,     Implied,                   5) \
+    X(0x7B, Nop,     Undefined1,                2) \
+    X(0x7C, Jmp,     AbsoluteIndexedIndirect,   8) \
+    X(0x7D, Adc,     AbsoluteX,                 4) \
+    X(0x7E, Ror,     AbsoluteX,                 7) \
+    X(0x7F, Bbr<7>,  ZeroPageRelative,          5) \
+    X(0x80, Bra,     Relative,                  3) \
+    X(0x81, Sta,     IndexedIndirect,           6) \
+    X(0x82, Nop,     Undefined2,                2) \
+    X(0x83, Nop,     Undefined1,                2) \
+    X(0x84, Sty,     ZeroPage,                  3) \
+    X(0x85, Sta,     ZeroPage,                  3) \
+    X(0x86, Stx,     ZeroPage,                  3) \
+    X(0x87, Smb<0>,  ZeroPage,                  5) \
+    X(0x88, Dey,     Implied,                   2) \
+    X(0x89, Bit,     Immediate,                 3) \
+    X(0x8A, Txa,     Implied,                   2) \
+    X(0x8B, Nop,     Undefined1,                2) \
+    X(0x8C, Sty,     Absolute,                  4) \
+    X(0x8D, Sta,     Absolute,                  4) \
+    X(0x8E, Stx,     Absolute,                  4) \
+    X(0x8F, Bbs<0>,  ZeroPageRelative,          5) \
+    X(0x90, Bcc,     Relative,                  3) \
+    X(0x91, Sta,     IndirectIndexed,           6) \
+    X(0x92, Sta,     ZeroPageIndirect,          5) \
+    X(0x93, Nop,     Undefined1,                2) \
+    X(0x94, Sty,     ZeroPageX,                 4) \
+    X(0x95, Sta,     ZeroPageX,                 4) \
+    X(0x96, Stx,     ZeroPageY,                 4) \
+    X(0x97, Smb<1>,  ZeroPage,                  5) \
+    X(0x98, Tya,     Implied,                   2) \
+    X(0x99, Sta,     AbsoluteY,                 5) \
+    X(0x9A, Txs,     Implied,                   2) \
+    X(0x9B, Nop,     Undefined1,                2) \
+    X(0x9C, Stz,     Absolute,                  4) \
+    X(0x9D, Sta,     AbsoluteX,                 5) \
+    X(0x9E, Stz,     AbsoluteX,                 5) \
+    X(0x9F, Bbs<1>,  ZeroPageRelative,          5) \
+    X(0xA0, Ldy,     Immediate,                 2) \
+    X(0xA1, Lda,     IndexedIndirect,           6) \
+    X(0xA2, Ldx,     Immediate,                 2) \
+    X(0xA3, Nop,     Undefined1,                2) \
+    X(0xA4, Ldy,     ZeroPage,                  3) \
+    X(0xA5, Lda,     ZeroPage,                  3) \
+    X(0xA6, Ldx,     ZeroPage,                  3) \
+    X(0xA7, Smb<2>,  ZeroPage,                  5) \
+    X(0xA8, Tay,     Implied,                   2) \
+    X(0xA9, Lda,     Immediate,                 2) \
+    X(0xAA, Tax,     Implied,                   2) \
+    X(0xAB, Nop,     Undefined1,                2) \
+    X(0xAC, Ldy,     Absolute,                  4) \
+    X(0xAD, Lda,     Absolute,                  4) \
+    X(0xAE, Ldx,     Absolute,                  4) \
+    X(0xAF, Bbs<2>,  ZeroPageRelative,          5) \
+    X(0xB0, Bcs,     Relative,                  3) \
+    X(0xB1, Lda,     IndirectIndexed,           5) \
+    X(0xB2, Lda,     ZeroPageIndirect,          5) \
+    X(0xB3, Nop,     Undefined1,                2) \
+    X(0xB4, Ldy,     ZeroPageX,                 4) \
+    X(0xB5, Lda,     ZeroPageX,                 4) \
+    X(0xB6, Ldx,     ZeroPageY,                 4) \
+    X(0xB7, Smb<3>,  ZeroPage,                  5) \
+    X(0xB8, Clv,     Implied,                   2) \
+    X(0xB9, Lda,     AbsoluteY,                 4) \
+    X(0xBA, Tsx,     Implied,                   2) \
+    X(0xBB, Nop,     Undefined1,                2) \
+    X(0xBC, Ldy,     AbsoluteX,                 4) \
+    X(0xBD, Lda,     AbsoluteX,                 4) \
+    X(0xBE, Ldx,     AbsoluteY,                 4) \
+    X(0xBF, Bbs<3>,  ZeroPageRelative,          5) \
+    X(0xC0, Cpy,     Immediate,                 2) \
+    X(0xC1, Cmp,     IndexedIndirect,           6) \
+    X(0xC2, Nop,     Undefined2,                2) \
+    X(0xC3, Nop,     Undefined1,                2) \
+    X(0xC4, Cpy,     ZeroPage,                  3) \
+    X(0xC5, Cmp,     ZeroPage,                  3) \
+    X(0xC6, Dec,     ZeroPage,                  5) \
+    X(0xC7, Smb<4>,  ZeroPage,                  5) \
+    X(0xC8, Iny,     Implied,                   2) \
+    X(0xC9, Cmp,     Immediate,                 2) \
+    X(0xCA, Dex,     Implied,                   2) \
+    X(0xCB, Wai,     Implied,                   3) \
+    X(0xCC, Cpy,     Absolute,                  4) \
+    X(0xCD, Cmp,     Absolute,                  4) \
+    X(0xCE, Dec,     Absolute,                  6) \
+    X(0xCF, Bbs<4>,  ZeroPageRelative,          5) \
+    X(0xD0, Bne,     Relative,                  3) \
+    X(0xD1, Cmp,     IndirectIndexed,           5) \
+    X(0xD2, Cmp,     ZeroPageIndirect,          5) \
+    X(0xD3, Nop,     Undefined1,                2) \
+    X(0xD4, Nop,     Undefined2,                2) \
+    X(0xD5, Cmp,     ZeroPageX,                 4) \
+    X(0xD6, Dec,     ZeroPageX,                 6) \
+    X(0xD7, Smb<5>,  ZeroPage,                  5) \
+    X(0xD8, Cld,     Implied,                   2) \
+    X(0xD9, Cmp,     AbsoluteY,                 4) \
+    X(0xDA, Phx,     Implied,                   4) \
+    X(0xDB, Stp,     Implied,                   3) \
+    X(0xDC, Nop,     Undefined3,                4) \
+    X(0xDD, Cmp,     AbsoluteX,                 4) \
+    X(0xDE, Dec,     AbsoluteX,                 7) \
+    X(0xDF, Bbs<5>,  ZeroPageRelative,          5) \
+    X(0xE0, Cpx,     Immediate,                 2) \
+    X(0xE1, Sbc,     IndexedIndirect,           6) \
+    X(0xE2, Nop,     Undefined2,                2) \
+    X(0xE3, Nop,     Undefined1,                2) \
+    X(0xE4, Cpx,     ZeroPage,                  3) \
+    X(0xE5, Sbc,     ZeroPage,                  3) \
+    X(0xE6, Inc,     ZeroPage,                  5) \
+    X(0xE7, Smb<6>,  ZeroPage,                  5) \
+    X(0xE8, Inx,     Implied,                   2) \
+    X(0xE9, Sbc,     Immediate,                 2) \
+    X(0xEA, Nop,     Implied,                   2) \
+    X(0xEB, Nop,     Undefined1,                2) \
+    X(0xEC, Cpx,     Absolute,                  4) \
+    X(0xED, Sbc,     Absolute,                  4) \
+    X(0xEE, Inc,     Absolute,                  6) \
+    X(0xEF, Bbs<6>,  ZeroPageRelative,          5) \
+    X(0xF0, Beq,     Relative,                  3) \
+    X(0xF1, Sbc,     IndirectIndexed,           5) \
+    X(0xF2, Sbc,     ZeroPageIndirect,          5) \
+    X(0xF3, Nop,     Undefined1,                2) \
+    X(0xF4, Nop,     Undefined2,                2) \
+    X(0xF5, Sbc,     ZeroPageX,                 4) \
+    X(0xF6, Inc,     ZeroPageX,                 6) \
+    X(0xF7, Smb<7>,  ZeroPage,                  5) \
+    X(0xF8, Sed,     Implied,                   2) \
+    X(0xF9, Sbc,     AbsoluteY,                 4) \
+    X(0xFA, Plx,     Implied,                   5) \
+    X(0xFB, Nop,     Undefined1,                2) \
+    X(0xFC, Nop,     Undefined3,                4) \
+    X(0xFD, Sbc,     AbsoluteX,                 4) \
+    X(0xFE, Inc,     AbsoluteX,                 7) \
+    X(0xFF, Bbs<7>,  ZeroPageRelative,          5)
+
+namespace detail {
+#define CPU6502_OPCODE_ORDER_ENTRY(opcode, op, mode, cycles) opcode,
+inline constexpr std::array<uint8_t, 256> kOpcodeOrder = {{CPU6502_OPCODE_TABLE(CPU6502_OPCODE_ORDER_ENTRY)}};
+#undef CPU6502_OPCODE_ORDER_ENTRY
+
+constexpr bool isOpcodeOrdered()
+{
+    for (unsigned i = 0; i < kOpcodeOrder.size(); ++i)
+        if (kOpcodeOrder[i] != i)
+            return false;
+    return true;
+}
+} // namespace detail
+
+static_assert(detail::isOpcodeOrdered(),
+              "CPU6502_OPCODE_TABLE must list all 256 opcodes in order");
+
+/// Instruction length in bytes (opcode plus operands), indexed by opcode.
+#define CPU6502_LENGTH_ENTRY(opcode, op, mode, cycles) static_cast<uint8_t>(1 + mode::kOperandBytes),
+inline constexpr std::array<uint8_t, 256> kInstructionLength = {{CPU6502_OPCODE_TABLE(CPU6502_LENGTH_ENTRY)}};
+#undef CPU6502_LENGTH_ENTRY
+
+/**
+ * @struct OpcodeEntry
+ * @brief Compile-time view of one CPU6502_OPCODE_TABLE row
+ *
+ * For code that names instructions by opcode number (the fused idioms in
+ * CPU6502::runCycles) but must run the same bodies as the table.
+ */
+template <uint8_t Opcode>
+struct OpcodeEntry;
+
+#define CPU6502_OPCODE_ENTRY(opcode, op, mode, cycles)   \
+    template <>                                          \
+    struct OpcodeEntry<opcode>                           \
+    {                                                    \
+        using Operation = op;                            \
+        using AddressingMode = mode;                     \
+        static constexpr unsigned kCycles = cycles;      \
+    };
+CPU6502_OPCODE_TABLE(CPU6502_OPCODE_ENTRY)
+#undef CPU6502_OPCODE_ENTRY
+
+/// Execute opcode @p Opcode through its table entry.
+template <uint8_t Opcode, class C>
+inline void executeOpcode(C &c)
+{
+    using Entry = OpcodeEntry<Opcode>;
+    execute<typename Entry::Operation, typename Entry::AddressingMode, Entry::kCycles>(c);
+}
+
+/**
+ * @brief Whether a predecoded block must end after this opcode
+ *
+ * Unconditional transfers (the bytes after them are rarely code) and the
+ * instructions that can unmask a pending IRQ (CLI, PLP, RTI), so interrupts
+ * are still checked between the same instructions as when single-stepping.
+ * Conditional branches may stay inside a block: when taken, the PC no longer
+ * matches the next record and the replay stops there.
+ */
+[[nodiscard]] constexpr bool endsBlock(const uint8_t opcode)
+{
+    switch (opcode)
+    {
+        case 0x00: // BRK
+        case 0x20: // JSR
+        case 0x28: // PLP
+        case 0x40: // RTI
+        case 0x4C: // JMP abs
+        case 0x58: // CLI
+        case 0x60: // RTS
+        case 0x6C: // JMP (abs)
+        case 0x7C: // JMP (abs,X)
+        case 0x80: // BRA
+        case 0xCB: // WAI
+        case 0xDB: // STP
+            return true;
+        default:
+            return false;
+    }
+}
+
+/**
+ * @struct DecodedContext
+ * @brief Batch context whose operand bytes come from a predecoded record
+ *
+ * Replaying a cached block (see BlockCache) sets @c operands to the record's
+ * operand bytes before each instruction, so addressing modes resolve without
+ * touching the bus. Everything else behaves as LocalContext.
+ */
+struct DecodedContext : LocalContext
+{
+    const uint8_t *operands = nullptr;
+
+    [[nodiscard]] uint8_t operand8(const uint8_t index) const { return operands[index]; }
+    [[nodiscard]] uint16_t operand16() const { return operands[0] | (operands[1] << 8); }
+};
+
+/**
+ * @struct StepContext
+ * @brief Single-step context that fetches operands from the code's page
+ *
+ * When the whole instruction lies in a plain RAM/ROM page,
+ * executeSingleInstruction() points @c code at its operand bytes in the page
+ * returned by Memory::codePage(), so operand fetches skip the bus. Otherwise
+ * @c code is null and they go through Memory::read() as in Context.
+ */
+struct StepContext : Context
+{
+    const uint8_t *code = nullptr;
+
+    uint8_t operand8(const uint8_t index)
+    {
+        return code ? code[index] : mem.read(static_cast<uint16_t>(reg.PC + index));
+    }
+    uint16_t operand16() { return operand8(0) | (operand8(1) << 8); }
+};
+
+} // namespace Computer::Isa
+
+#endif // CPU6502_INSTRUCTIONS_H
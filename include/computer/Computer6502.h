@@ -7,6 +7,9 @@
 #ifndef COMPUTER6502_H
 #define COMPUTER6502_H
 
+#include <functional>
+#include <memory>
+
 #include "Memory.h"
 #include "CPU6502.h"
 #include "ResetCircuit.h"
@@ -14,6 +17,8 @@
 #include "VIC.h"
 #include "PIA.h"
 #include "BlockDevice.h"
+#include "EventScheduler.h"
+#include "RomTranslation.h"
 
 namespace Computer
 {
@@ -38,6 +43,12 @@ namespace Computer
     class Computer6502
     {
     public:
+        /// CPU cycles between jiffy (interval-timer) IRQs: 60 Hz at 1 MHz.
+        static constexpr uint64_t kJiffyCycles = 16667;
+
+        /// Runs a job that needs the host (see setFileJobRunner()).
+        using JobRunner = std::function<void(const std::function<void()> &job)>;
+
         /**
          * @brief Construct a new Computer6502 system
          *
@@ -46,6 +57,10 @@ namespace Computer
          */
         Computer6502();
 
+        // Components point at each other; use fork() to copy a machine.
+        Computer6502(const Computer6502 &) = delete;
+        Computer6502 &operator=(const Computer6502 &) = delete;
+
         /**
          * @brief Power on the computer system
          *
@@ -63,24 +78,117 @@ namespace Computer
          * @brief Execute CPU instructions for a specified number of cycles
          *
          * Runs the 6502 CPU for the specified number of instruction cycles.
-         * Each cycle represents one CPU instruction execution. File operations
-         * and other system tasks are processed between instruction executions.
+         * Each cycle represents one CPU instruction execution. Scheduled
+         * events that have come due (including file operations the guest
+         * started) are processed between instruction executions.
          *
          * @param max_cycles Maximum number of CPU instruction cycles to execute
          *                   Default is 100 cycles
-         * @note Execution may stop early if an unknown instruction is encountered
+         * @note Execution may stop early if an unknown instruction is encountered.
+         *       While WAI or STP halts the CPU the clock jumps to the next
+         *       scheduled event (each idle cycle counts as a step); with no
+         *       event pending the call sleeps instead of spinning, and
+         *       returns if nothing wakes the CPU in time.
          */
         void run(int max_cycles = 100);
 
+        /**
+         * @brief Execute CPU cycles against a cycle budget
+         *
+         * Runs the CPU in batches (CPU6502::runCycles) until @p budget cycles
+         * have elapsed. A batch never runs past the next scheduled event (see
+         * getScheduler()), so events fire on their cycle and an idle loop is
+         * only fast-forwarded up to it. Due events are processed whenever a
+         * batch ends, either because the budget ran out, an event came due, or
+         * a device or an interrupt line asked for attention. A file command
+         * written by the guest rings the PIA's doorbell, which posts the file
+         * work as an event due at once.
+         *
+         * @param budget Number of CPU clock cycles to execute
+         * @return uint64_t Cycles actually executed (may overshoot by the tail
+         *         of the last instruction)
+         * @note A CPU halted by WAI/STP lets the budget elapse at once; hosts
+         *       pacing in real time can sleep on CPU6502::waitWhileHalted().
+         */
+        uint64_t runCycles(uint64_t budget);
+
+        /**
+         * @brief Run one real-time slice at the selected clock
+         *
+         * Runs TimingCircuit::sliceCycles() cycles with runCycles(), then
+         * waits in TimingCircuit::pace() until the wall clock has caught up,
+         * so calling it in a loop holds the machine to the target frequency
+         * (see getTimingCircuit()).
+         *
+         * @return uint64_t Cycles executed
+         * @note Blocks for up to about a millisecond; never when unthrottled.
+         */
+        uint64_t runSlice();
+
         /**
          * @brief Reset the computer system
          *
          * Triggers a system reset, reinitializing the CPU and all components
          * to their default state. The program counter will be loaded from
-         * the reset vector at $FFFC-$FFFD.
+         * the reset vector at $FFFC-$FFFD. The CPU clock restarts at 0, and
+         * the jiffy timer with it.
          */
         void reset();
 
+        /**
+         * @brief Create an independent copy of the running machine
+         *
+         * The copy resumes exactly where this machine is: RAM, CPU registers
+         * and clock, interrupt lines, screen, keyboard queue and disk state.
+         * Module ROM banks and the DOS ROM image are shared, and so are disk
+         * sectors, copy-on-write: the first fork freezes this machine's disk
+         * image (see BlockDevice::freezeImage()) so that neither machine's
+         * writes reach the file or each other. RAM is copied (64KB).
+         *
+         * @return std::unique_ptr<Computer6502> The new machine, already
+         *         powered on
+         * @note Not thread-safe against a concurrent run() of this machine.
+         */
+        std::unique_ptr<Computer6502> fork();
+
+        /**
+         * @brief Get the event scheduler that paces devices in CPU cycles
+         * @return EventScheduler* Events are due on CPU6502::getCycles() values
+         * @note The machine keeps the jiffy timer here: every kJiffyCycles
+         *       it asserts the PIA timer IRQ, in emulated time, so BASIC's
+         *       ON IRQ rate follows the CPU clock whatever the host speed. A
+         *       forked machine starts with only its own jiffy timer (in phase
+         *       with the parent's) and pending file work.
+         */
+        EventScheduler *getScheduler()
+        {
+            return &scheduler;
+        }
+
+        /**
+         * @brief Choose where PIA file operations run
+         * @param runner Called with the file job when the guest's command
+         *        comes due; it must run the job before returning (or
+         *        give up because emulation is stopping). Hosts that
+         *        run the machine off their UI thread use it to move the job
+         *        (and its file dialog) onto that thread while emulation
+         *        waits. Empty (the default) runs the job in place.
+         */
+        void setFileJobRunner(JobRunner runner)
+        {
+            file_job_runner_ = std::move(runner);
+        }
+
+        /**
+         * @brief Get the real-time pacer used by runSlice()
+         * @return TimingCircuit* Select the target clock and read the
+         *         effective frequency here
+         */
+        TimingCircuit *getTimingCircuit()
+        {
+            return &timing_circuit;
+        }
+
         /**
          * @brief Get pointer to the video chip (VIC)
          * @return VIC* Pointer to the VIC video chip for screen operations
@@ -139,13 +247,33 @@ namespace Computer
          */
         void showFatalError(const std::string &message);
 
+        /**
+         * @brief Bind the linked-in ROM translations to the loaded images
+         * @return size_t Number of blocks bound (0 leaves the CPU interpreting)
+         */
+        size_t bindRomTranslations();
+
+        /// Run the PIA's pending file operation at the next batch boundary.
+        void scheduleFileOperation();
+
+        /// Post the next jiffy IRQ at @p due; each tick posts the next.
+        void armJiffyTimer(uint64_t due);
+
+        /// Replace every scheduled event with the machine's own: the jiffy
+        /// timer, first due at @p jiffy_due, and any pending file work.
+        void rearmEvents(uint64_t jiffy_due);
+
         VIC video_chip; ///< VIC-II video chip for screen output
         PIA pia; ///< Peripheral Interface Adapter for I/O
         BlockDevice block_device; ///< Block device backing the FAT16 disk image
         Memory memory; ///< 64KB system memory with memory-mapped I/O
         CPU6502 cpu; ///< MOS 65C02 microprocessor
+        RomTranslations rom_translations; ///< Build-time translations of the ROM images
         ResetCircuit reset_circuit; ///< Reset circuit for system initialization
-        TimingCircuit timing_circuit; ///< System timing and synchronization
+        TimingCircuit timing_circuit; ///< Real-time pacer for runSlice()
+        EventScheduler scheduler; ///< Device events keyed on the CPU cycle count
+        uint64_t jiffy_due_ = 0;  ///< Cycle of the pending jiffy IRQ
+        JobRunner file_job_runner_; ///< See setFileJobRunner()
     };
 } // namespace Computer
 
@@ -0,0 +1,169 @@
+/**
+ * @file EmulationThread.h
+ * @brief Runs a Computer6502 on its own thread, talking to the host lock-free
+ * @author 6502 Kernel Project
+ */
+
+#ifndef EMULATIONTHREAD_H
+#define EMULATIONTHREAD_H
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <thread>
+
+#include "Computer6502.h"
+#include "Seqlock.h"
+#include "SpscQueue.h"
+#include "VIC.h"
+
+namespace Computer
+{
+    /**
+     * @struct ScreenFrame
+     * @brief What the display shows: screen memory and the kernel's cursor
+     */
+    struct ScreenFrame
+    {
+        std::array<uint8_t, VIC::kScreenSize> cells{};  ///< Row-major characters
+        uint8_t cursor_x = 0xFF;                        ///< CURSOR_X ($0276); >= width = none
+        uint8_t cursor_y = 0xFF;                        ///< CURSOR_Y ($0277); >= height = none
+    };
+
+    /**
+     * @struct CpuSnapshot
+     * @brief Registers and clock as of the end of the last slice
+     */
+    struct CpuSnapshot
+    {
+        uint16_t pc = 0;
+        uint8_t a = 0, x = 0, y = 0, sp = 0, p = 0;
+        uint8_t current_byte = 0;       ///< Opcode at PC
+        bool halted = false;            ///< Stopped by WAI or STP
+        uint64_t cycles = 0;            ///< CPU6502::getCycles()
+        double frequency = 0.0;         ///< TimingCircuit::getActualFrequency()
+    };
+
+    /**
+     * @class EmulationThread
+     * @brief Owns the thread a Computer6502 runs on and the host's view of it
+     *
+     * The thread runs Computer6502::runSlice() in a loop, so the machine is
+     * paced by its TimingCircuit without involving the host's event loop.
+     * Nothing is shared under a lock:
+     * - keypresses go through an SpscQueue that the thread drains into the
+     *   PIA at every slice boundary (at most one slice, 1 ms, of latency; a
+     *   batch never starts with stale idle-loop state, see
+     *   CPU6502::runCycles);
+     * - reset, NMI and clock changes are atomic requests applied at the next
+     *   slice boundary;
+     * - the screen and the registers are published through Seqlocks after
+     *   every slice (the screen only when it or the cursor changed), so the
+     *   host reads a consistent copy whenever it likes.
+     *
+     * Host-side calls (postKey(), the request*() functions, screen(),
+     * registers()) must come from one thread, the host's UI thread. File
+     * operations need that thread too (for their dialogs): with a host
+     * executor set, the emulation thread hands the job over and waits for it.
+     *
+     * The machine must not be touched directly while the thread runs.
+     *
+     * @see Computer6502::runSlice, SpscQueue, Seqlock
+     */
+    class EmulationThread
+    {
+    public:
+        /// Queues @p job to run on the host thread, returning at once.
+        using HostExecutor = std::function<void(std::function<void()> job)>;
+
+        /// Keypresses that can wait between two slices.
+        static constexpr size_t kKeyQueueSize = 256;
+
+        explicit EmulationThread(Computer6502 &computer);
+        ~EmulationThread();
+
+        EmulationThread(const EmulationThread &) = delete;
+        EmulationThread &operator=(const EmulationThread &) = delete;
+
+        /// Start running the machine (no-op if already running).
+        void start();
+
+        /// Stop after the current slice and join the thread.
+        void stop();
+
+        [[nodiscard]] bool isRunning() const { return thread_.joinable(); }
+
+        /**
+         * @brief Set how file jobs reach the host thread
+         * @param executor Posts a job to the host's event loop; empty runs
+         *        file jobs on the emulation thread
+         * @note Call while the thread is stopped.
+         */
+        void setHostExecutor(HostExecutor executor) { host_executor_ = std::move(executor); }
+
+        /**
+         * @brief Queue a keypress for the PIA
+         * @return bool false if the queue is full (the key is dropped)
+         */
+        bool postKey(uint8_t ascii_code) { return keys_.push(ascii_code); }
+
+        /// Reset the machine at the next slice boundary.
+        void requestReset() { reset_requested_.store(true, std::memory_order_release); }
+
+        /// Raise an NMI at the next slice boundary.
+        void requestNmi() { nmi_requested_.store(true, std::memory_order_release); }
+
+        /// Change the target clock (TimingCircuit::setTargetFrequency()).
+        void requestFrequency(uint32_t hz);
+
+        /// Latest published screen.
+        [[nodiscard]] ScreenFrame screen() const { return screen_.load(); }
+
+        /// Changes whenever a new screen is published.
+        [[nodiscard]] uint32_t screenVersion() const { return screen_.version(); }
+
+        /// Latest published registers.
+        [[nodiscard]] CpuSnapshot registers() const { return registers_.load(); }
+
+        /**
+         * @brief Publish the current screen and registers now
+         * @note For the host before start() (or after stop()); the thread
+         *       publishes on its own while it runs.
+         */
+        void publish();
+
+    private:
+        /// No frequency change pending.
+        static constexpr uint32_t kNoRequest = ~uint32_t{0};
+
+        /// The thread body.
+        void run();
+
+        /// Apply keys and requests from the host (emulation thread).
+        void applyRequests();
+
+        /// Publish the screen if it changed, and the registers (emulation thread).
+        void publishChanges();
+
+        /// Hand @p job to the host thread and wait until it has run.
+        void runOnHost(const std::function<void()> &job);
+
+        Computer6502 &computer_;
+        std::thread thread_;
+        std::atomic<bool> stop_{false};
+
+        SpscQueue<uint8_t, kKeyQueueSize> keys_;
+        std::atomic<bool> reset_requested_{false};
+        std::atomic<bool> nmi_requested_{false};
+        std::atomic<uint32_t> frequency_request_{kNoRequest};
+        HostExecutor host_executor_;
+
+        Seqlock<ScreenFrame> screen_;
+        Seqlock<CpuSnapshot> registers_;
+        uint8_t cursor_x_ = 0xFF;   ///< Cursor in the last published frame
+        uint8_t cursor_y_ = 0xFF;
+    };
+} // namespace Computer
+
+#endif // EMULATIONTHREAD_H
@@ -0,0 +1,112 @@
+/**
+ * @file EventScheduler.h
+ * @brief Cycle-timestamped events for devices that act at a given time
+ * @author 6502 Kernel Project
+ */
+
+#ifndef EVENTSCHEDULER_H
+#define EVENTSCHEDULER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <unordered_set>
+#include <vector>
+
+namespace Computer
+{
+    /**
+     * @class EventScheduler
+     * @brief Min-heap of callbacks keyed on the CPU cycle count
+     *
+     * A device that needs to act at a point in emulated time (a timer tick,
+     * the end of a transfer) posts an event for that cycle instead of being
+     * polled. The run loop asks nextDue() how far the CPU may run, runs it
+     * exactly that far in one batch, and then fires what is due with
+     * runDue(). Time is the CPU clock (CPU6502::getCycles()), so an event
+     * fires after the same instructions however fast the host is.
+     *
+     * Events due on the same cycle fire in the order they were posted. A
+     * callback receives the cycle it was due on (the clock may be a few
+     * cycles past it, at the end of the instruction that crossed it), so a
+     * periodic event reposts itself at due + period without drifting.
+     *
+     * @see Computer6502::runCycles
+     */
+    class EventScheduler
+    {
+    public:
+        /// Handle returned by schedule(), for cancel().
+        using EventId = uint64_t;
+
+        /// Called with the cycle the event was due on.
+        using Callback = std::function<void(uint64_t due)>;
+
+        /// nextDue() with nothing scheduled.
+        static constexpr uint64_t kNever = ~uint64_t{0};
+
+        /**
+         * @brief Post an event
+         * @param due CPU cycle the event fires at (a past cycle fires at the
+         *        next runDue())
+         * @param callback Action; may schedule or cancel events itself
+         * @return EventId Handle for cancel()
+         * @note Calls the wake-up hook when the event becomes the earliest,
+         *       so a batch already running can stop in time.
+         */
+        EventId schedule(uint64_t due, Callback callback);
+
+        /**
+         * @brief Withdraw an event that has not fired
+         * @return bool false if it already fired or was cancelled
+         */
+        bool cancel(EventId id);
+
+        /// Cycle of the earliest pending event, or kNever.
+        [[nodiscard]] uint64_t nextDue() const { return heap_.empty() ? kNever : heap_.front().due; }
+
+        /**
+         * @brief Fire every event due at or before @p now, earliest first
+         * @param now Current CPU cycle count
+         * @return size_t Number of events fired (including ones a callback
+         *         posted for a cycle already reached)
+         */
+        size_t runDue(uint64_t now);
+
+        /// Number of pending events.
+        [[nodiscard]] size_t size() const { return heap_.size() - cancelled_.size(); }
+
+        /// Drop every pending event.
+        void clear();
+
+        /**
+         * @brief Set the hook called when a newly posted event is the earliest
+         * @note Computer6502 points it at CPU6502::raiseAttention().
+         */
+        void setWakeup(std::function<void()> wakeup) { wakeup_ = std::move(wakeup); }
+
+    private:
+        struct Event
+        {
+            uint64_t due;
+            EventId id;     ///< Also the posting order
+            Callback callback;
+        };
+
+        /// std::push_heap order: the top is the smallest (due, id).
+        static bool later(const Event &a, const Event &b)
+        {
+            return a.due != b.due ? a.due > b.due : a.id > b.id;
+        }
+
+        /// Pop cancelled events off the top, so front() is always live.
+        void dropCancelled();
+
+        std::vector<Event> heap_;
+        std::unordered_set<EventId> cancelled_;   ///< Still in heap_, skipped when popped
+        EventId next_id_ = 1;
+        std::function<void()> wakeup_;
+    };
+} // namespace Computer
+
+#endif // EVENTSCHEDULER_H
@@ -7,15 +7,58 @@
 #ifndef MEMORY_H
 #define MEMORY_H
 
+#include <array>
+#include <bitset>
+#include <memory>
+#include <span>
+#include <string>
 #include <vector>
+#include <cstddef>
 #include <cstdint>
 
 namespace Computer
 {
+    class BankArena;
+    class BusDevice;
     class VIC;
     class PIA;
     class BlockDevice;
 
+    /**
+     * @struct MemoryDelta
+     * @brief RAM pages changed since a checkpoint (see Memory::checkpoint())
+     */
+    struct MemoryDelta
+    {
+        static constexpr size_t kPageSize = 256;
+
+        uint8_t bank = 0;               ///< MODULE_BANK at the checkpoint
+        uint8_t ram_bank = 0;           ///< RAM_BANK at the checkpoint
+        std::vector<uint8_t> pages;     ///< Changed page numbers, ascending
+        std::vector<uint8_t> data;      ///< kPageSize bytes per entry of pages
+        std::vector<uint8_t> ram_banks; ///< Changed expansion RAM banks, ascending
+        std::vector<uint8_t> ram_bank_data; ///< Memory::kModuleWindowSize bytes per entry of ram_banks
+    };
+
+    /// Accesses a watchpoint can catch (combine as a mask).
+    enum WatchKind : uint8_t
+    {
+        kWatchRead = 0x01,      ///< Data reads (not instruction fetches)
+        kWatchWrite = 0x02,     ///< Stores, including ignored stores to ROM
+        kWatchExecute = 0x04    ///< An instruction starting at the address
+    };
+
+    /**
+     * @struct WatchAccess
+     * @brief A read or write that hit a watched address (see Memory::watch())
+     */
+    struct WatchAccess
+    {
+        WatchKind kind;
+        uint16_t address;
+        uint8_t value;          ///< Byte read, or byte stored
+    };
+
     /**
      * @class Memory
      * @brief 64KB system memory with memory-mapped I/O support
@@ -29,10 +72,25 @@ namespace Computer
      * - $0400-$07FF: Screen memory (1KB) - Character display data
      * - $0800-$8FFF: User RAM (~34KB) - Available for programs / module working RAM
      * - $9000-$AFFF: DOS ROM (8KB) - always-mapped FAT16 filesystem / DOS shell
-     * - $B000-$DFFF: Module window (12KB) - bank 0 = RAM, banks 1..255 = ROM modules
+     * - $B000-$DFFF: Module window (12KB) - bank 0 = RAM (RAM_BANK picks which),
+     *                banks 1..255 = ROM modules
      * - $E000-$FFFF: ROM area (8KB) - Kernel ROM (I/O page at $FE00, bank reg $FE23,
      *                block-device registers $FE24-$FE28)
      *
+     * Accesses go through a page table: each 256-byte page has a read and a
+     * write pointer into RAM or a ROM image, so plain RAM/ROM traffic is one
+     * indexed load or store. Pages holding device registers (the $FE I/O
+     * page) have no pointers and fall back to readIo() and writeIo(), which
+     * find the device in a per-address dispatch table built from the attached
+     * BusDevices; ROM pages have no write pointer. Screen memory is plain RAM
+     * that the VIC displays from, so screen stores take the RAM path too.
+     * Switching banks or installing ROMs only swaps page pointers.
+     *
+     * Watchpoints use the same mechanism: a page holding a watched address
+     * loses its read and/or write pointer, so only accesses to that page take
+     * the slow path that checks the address. Unwatched pages, and every page
+     * when nothing is watched, cost nothing extra.
+     *
      * @see VIC, PIA, CPU6502
      */
     class Memory
@@ -59,6 +117,15 @@ namespace Computer
         /// Number of selectable banks (one byte of bank index: 0..255).
         static constexpr int kBankCount = 256;
 
+        /// RAM_BANK select register. While MODULE_BANK is 0, write n to back
+        /// the window with RAM bank n (mod kRamBankCount): 0 is the base RAM
+        /// under the window, 1..15 are expansion banks. Reads return the last
+        /// value written.
+        static constexpr uint16_t kRamBankRegister = 0xFE29;
+
+        /// Number of window-sized RAM banks, the base RAM included.
+        static constexpr int kRamBankCount = 16;
+
         /**
          * @brief Construct a new Memory system
          * @param video_chip Pointer to VIC chip for memory-mapped video I/O
@@ -66,13 +133,37 @@ namespace Computer
          */
         explicit Memory(VIC *video_chip = nullptr, PIA *pia = nullptr);
 
+        /// Copies share the devices and the module ROM arena (until one of
+        /// them installs a bank); the page table is rebuilt to point into
+        /// the copy's own storage. The VIC keeps displaying the original's
+        /// screen memory.
+        Memory(const Memory &other);
+        Memory &operator=(const Memory &other);
+        ~Memory();
+
+        /**
+         * @brief Take over another memory's contents, keeping this memory's
+         *        devices
+         * @param other Memory whose RAM, ROM images, bank selection and
+         *        checkpoint state are copied (module ROM banks are shared
+         *        until either side installs one)
+         */
+        void copyStateFrom(const Memory &other);
+
         /**
          * @brief Read a byte from memory
          * @param address 16-bit memory address to read from
          * @return uint8_t Value at the specified memory address
          * @note Automatically handles memory-mapped I/O for VIC and PIA regions
          */
-        [[nodiscard]] uint8_t read(uint16_t address) const;
+        [[nodiscard]] uint8_t read(const uint16_t address) const
+        {
+            if (const uint8_t *page = read_pages_[address >> 8])
+            {
+                return page[address & 0xFF];
+            }
+            return readIo(address);
+        }
 
         /**
          * @brief Write a byte to memory
@@ -80,7 +171,71 @@ namespace Computer
          * @param value 8-bit value to write
          * @note Automatically handles memory-mapped I/O for VIC and PIA regions
          */
-        void write(uint16_t address, uint8_t value);
+        void write(const uint16_t address, const uint8_t value)
+        {
+            if (uint8_t *page = write_pages_[address >> 8])
+            {
+                // Storing the value already there changes nothing: no side
+                // effect, and decoded code in the page stays valid.
+                uint8_t &cell = page[address & 0xFF];
+                if (cell != value)
+                {
+                    cell = value;
+                    ++page_generation_[address >> 8];
+                    ++side_effects_;
+                }
+                return;
+            }
+            if (io_pages_[address >> 8])
+            {
+                writeIo(address, value);
+            }
+            // Otherwise ROM: writes are ignored.
+        }
+
+        /**
+         * @brief Backing bytes of a page, for instruction fetch
+         * @param page Page number (address >> 8)
+         * @return The page's 256 bytes as read() would return them, or null
+         *         for a page holding device registers
+         * @note Valid until the next bank switch or ROM install; fetch one
+         *       instruction at a time through it.
+         */
+        [[nodiscard]] const uint8_t *codePage(const uint8_t page) const { return code_pages_[page]; }
+
+        /**
+         * @brief Watch accesses to an address
+         * @param address Guest address
+         * @param kinds WatchKind mask to add
+         * @note Read and write hits are appended to watchLog(); execute
+         *       watches are checked by the CPU (see isExecuteWatched()).
+         */
+        void watch(uint16_t address, uint8_t kinds);
+
+        /**
+         * @brief Stop watching an address
+         * @param address Guest address
+         * @param kinds WatchKind mask to remove
+         */
+        void unwatch(uint16_t address, uint8_t kinds);
+
+        /// Remove every watch.
+        void clearWatches();
+
+        /// Whether any address is watched.
+        [[nodiscard]] bool hasWatches() const { return watched_addresses_ != 0; }
+
+        /// Whether an instruction starting at @p address should be reported.
+        [[nodiscard]] bool isExecuteWatched(const uint16_t address) const
+        {
+            return (watch_pages_[address >> 8] & kWatchExecute) && (watch_flags_[address] & kWatchExecute);
+        }
+
+        /**
+         * @brief Watched reads and writes, oldest first
+         * @return The log, which the reader clears once handled
+         */
+        [[nodiscard]] std::vector<WatchAccess> &watchLog() const { return watch_log_; }
 
         /**
          * @brief Read a 16-bit word from memory (little-endian)
@@ -98,6 +253,25 @@ namespace Computer
          */
         void writeWord(uint16_t address, uint16_t value);
 
+        /**
+         * @brief Read a range of memory as the CPU would see it
+         * @param address First address; the range wraps at $FFFF
+         * @param out Destination, at most 64 KB
+         * @note RAM and ROM pages are copied a page at a time; I/O pages are
+         *       read byte by byte through the devices, with their side effects.
+         */
+        void readBlock(uint16_t address, std::span<uint8_t> out) const;
+
+        /**
+         * @brief Write a range of memory as the CPU would
+         * @param address First address; the range wraps at $FFFF
+         * @param data Bytes to store, at most 64 KB
+         * @note RAM pages are copied a page at a time, ROM pages are skipped
+         *       and I/O pages go byte by byte to the devices, exactly as
+         *       write() would treat each byte.
+         */
+        void writeBlock(uint16_t address, std::span<const uint8_t> data);
+
         /**
          * @brief Load a program or ROM data into memory
          * @param program Vector containing the program data to load
@@ -107,8 +281,23 @@ namespace Computer
         void loadProgram(const std::vector<uint8_t> &program, uint16_t start_address);
 
         /**
-         * @brief Set or update the video chip for memory-mapped I/O
-         * @param video_chip Pointer to VIC chip instance
+         * @brief Map a device's registers (BusDevice::busRange()) into the
+         *        address space
+         * @param device Device to attach; must outlive the Memory or be
+         *        detached first. A later device wins where ranges overlap.
+         */
+        void attachDevice(BusDevice *device);
+
+        /**
+         * @brief Unmap a device attached with attachDevice()
+         * @param device Device to detach; its addresses revert to RAM
+         */
+        void detachDevice(BusDevice *device);
+
+        /**
+         * @brief Set or update the video chip
+         * @param video_chip Pointer to VIC chip instance; its screen memory
+         *        becomes $0400-$07FF of this memory
          */
         void setVideoChip(VIC *video_chip);
 
@@ -145,6 +334,16 @@ namespace Computer
          */
         void loadBank(uint8_t bank, const std::vector<uint8_t> &image);
 
+        /**
+         * @brief Install a module ROM file into a bank without copying it
+         * @param bank Bank index 1..255
+         * @param path ROM image file; truncated/zero-padded to 12KB
+         * @return false if the file cannot be opened (the bank is unchanged)
+         * @note The file is mapped read-only the first time the bank is
+         *       selected (see BankArena), so unused banks cost nothing.
+         */
+        bool loadBankFile(uint8_t bank, const std::string &path);
+
         /**
          * @brief Map a bank into the module window (same effect as writing MODULE_BANK)
          * @param bank 0 = RAM, 1..255 = ROM module
@@ -155,7 +354,24 @@ namespace Computer
          * @brief Get the currently mapped bank
          * @return uint8_t Current bank (0 = RAM)
          */
-        [[nodiscard]] uint8_t currentBank() const;
+        [[nodiscard]] uint8_t currentBank() const { return current_bank_; }
+
+        /**
+         * @brief Select the RAM bank behind the window (same effect as writing RAM_BANK)
+         * @param bank Register value; bank % kRamBankCount is used
+         */
+        void selectRamBank(uint8_t bank);
+
+        /// RAM bank backing the window while MODULE_BANK is 0.
+        [[nodiscard]] uint8_t currentRamBank() const { return ram_bank_ % kRamBankCount; }
+
+        /**
+         * @brief Whether an expansion RAM bank has storage yet
+         * @param bank 1..kRamBankCount-1
+         * @note A bank is allocated, zero-filled, by its first store; until
+         *       then it reads as zeros and costs no host memory.
+         */
+        [[nodiscard]] bool isRamBankAllocated(uint8_t bank) const;
 
         /**
          * @brief Whether a ROM image has been installed for a bank
@@ -163,20 +379,179 @@ namespace Computer
          */
         [[nodiscard]] bool isBankLoaded(uint8_t bank) const;
 
+        /**
+         * @brief Write generation of a 256-byte page
+         * @param page Page number (address >> 8)
+         * @return Counter bumped by every RAM store that changes a byte in
+         *         the page
+         * @note Used by the CPU's decoded-block cache to spot self-modifying
+         *       code. ROM regions never change it.
+         */
+        [[nodiscard]] uint32_t pageGeneration(const uint8_t page) const { return page_generation_[page]; }
+
+        /**
+         * @brief RAM pages changed since the last checkpoint
+         * @return Bit n set when page n's generation has moved on since
+         *         clearDirtyPages() or checkpoint() (all pages at first)
+         * @note Derived from the page generations, so stores pay nothing
+         *       extra for it.
+         */
+        [[nodiscard]] std::bitset<256> dirtyPages() const;
+
+        /// Treat the current RAM contents as checkpointed.
+        void clearDirtyPages();
+
+        /**
+         * @brief Collect the dirty pages and start a new checkpoint
+         * @return The RAM of every page in dirtyPages() (the bytes under
+         *         ROM and I/O, not what read() returns there), every
+         *         expansion RAM bank stored to since the last checkpoint,
+         *         and the selected banks
+         */
+        [[nodiscard]] MemoryDelta checkpoint();
+
+        /**
+         * @brief Bring RAM, expansion RAM and the bank selection to a
+         *        checkpoint's state
+         * @param delta A delta from checkpoint(), applied in order after the
+         *        previous ones from the same source
+         * @note The applied pages are not marked dirty here.
+         */
+        void applyDelta(const MemoryDelta &delta);
+
+        /**
+         * @brief Number of bus accesses with a visible effect so far
+         * @return Counter bumped by every store that changes a RAM byte or the
+         *         selected bank, every device register write, and every device
+         *         read that consumes state (a queued key, a stream byte, the
+         *         block-device data port)
+         * @note Equal values before and after a stretch of execution mean it
+         *       only re-read unchanged state; CPU6502 uses that to spot idle
+         *       poll loops.
+         */
+        [[nodiscard]] uint64_t sideEffectCount() const { return side_effects_; }
+
+        /**
+         * @brief Generation of the installed ROM images
+         * @return Counter bumped by loadBank() and loadDosRom()
+         */
+        [[nodiscard]] uint32_t romEpoch() const { return rom_epoch_; }
+
+        /**
+         * @brief Whether an address reads back plain RAM/ROM contents
+         * @param address Address to classify
+         * @return false for I/O registers, whose reads may have side effects
+         *         and are not tracked by the page generations
+         */
+        [[nodiscard]] bool isCodeCacheable(uint16_t address) const;
+
+        /**
+         * @brief Whether an address is currently backed by read-only ROM
+         * @param address Address to classify
+         * @return true inside an installed DOS ROM or a selected module bank
+         */
+        [[nodiscard]] bool isRomAddress(uint16_t address) const;
+
     private:
+        /// Compiles the read()/write() fast paths into translated code.
+        friend class BlockJit;
+
+        /// Slow path for pages without a read pointer (devices, watches).
+        [[nodiscard]] uint8_t readIo(uint16_t address) const;
+
+        /// Register or RAM read in a device page.
+        [[nodiscard]] uint8_t readDevice(uint16_t address) const;
+
+        /// Slow path for writes to device and write-watched pages.
+        void writeIo(uint16_t address, uint8_t value);
+
+        /// Swap @p old_device for @p new_device on the bus (either may be null).
+        void replaceDevice(BusDevice *old_device, BusDevice *new_device);
+
+        /// Device answering @p address, or null (I/O pages only).
+        [[nodiscard]] BusDevice *deviceAt(uint16_t address) const;
+
+        /// Rebuild the device dispatch table and the page table.
+        void mapDevices();
+
+        /// Rebuild the whole page table (device or ROM image changes).
+        void mapPages();
+
+        /// Point the module window's pages at the selected bank.
+        void mapModuleWindow();
+
+        /// Derive the access pointers of pages first..last from their
+        /// backing, leaving watched pages to the slow path.
+        void publishPages(int first, int last);
+
+        /// Append a hit to the log if @p address is watched for @p kind.
+        void noteWatch(WatchKind kind, uint16_t address, uint8_t value) const;
+
+        /// Expansion RAM bank currently visible in the window (0 = none).
+        [[nodiscard]] int mappedRamBank() const;
+
+        /// Window pages stand for an expansion bank that has no storage yet.
+        [[nodiscard]] bool windowIsUnallocatedRam() const;
+
+        /// Mark the mapped expansion bank dirty if the window was written
+        /// since mapRamBankStart(); call before the mapping changes.
+        void noteRamBankWrites();
+
+        /// Record the window generations for noteRamBankWrites().
+        void mapRamBankStart();
+
+        /// Window contents changed under the CPU: new generations, but pages
+        /// that were checkpointed stay clean.
+        void bumpWindowGenerations();
+
+        /// Change the MODULE_BANK or RAM_BANK value, keeping caches and
+        /// dirty tracking in step.
+        void switchWindow(uint8_t bank, uint8_t ram_bank);
+
+        /// The bank arena, unshared first if another Memory uses it too.
+        BankArena &ownBanks();
+
         std::vector<uint8_t> ram_;    ///< 64KB system RAM storage
         VIC *video_chip_;             ///< Pointer to VIC for memory-mapped video I/O
         PIA *pia_;                    ///< Pointer to PIA for memory-mapped peripheral I/O
         BlockDevice *block_device_ = nullptr; ///< Block device ($FE24-$FE28), or null
 
-        /// Module ROM images, indexed by bank (1..255). Each entry is either
-        /// empty (no module installed) or exactly kModuleWindowSize bytes.
-        std::vector<std::vector<uint8_t>> bank_rom_;
+        /// Module ROM images (banks 1..255), shared by copies of this Memory.
+        std::shared_ptr<BankArena> banks_;
         uint8_t current_bank_ = 0;    ///< Bank mapped into $B000-$DFFF (0 = RAM)
 
         /// Always-mapped DOS ROM image ($9000-$AFFF). Empty = not installed
         /// (region behaves as RAM); otherwise exactly kDosRomSize bytes.
         std::vector<uint8_t> dos_rom_;
+
+        std::array<const uint8_t *, 256> code_pages_{}; ///< Per-page backing bytes; null = device page
+        std::array<uint8_t *, 256> store_pages_{};      ///< Per-page writable backing; null = device or ROM
+        std::array<const uint8_t *, 256> read_pages_{}; ///< Fast-path read pointer; null = slow path
+        std::array<uint8_t *, 256> write_pages_{};      ///< Fast-path write pointer; null = slow path or ROM
+        std::array<bool, 256> io_pages_{};              ///< Writes take the slow path (devices, watches)
+        std::array<bool, 256> device_io_pages_{};       ///< Pages holding device registers
+
+        std::vector<uint8_t> watch_flags_;              ///< WatchKind mask per address (allocated on first watch)
+        std::array<uint8_t, 256> watch_pages_{};        ///< WatchKind masks of each page's addresses, OR'd
+        size_t watched_addresses_ = 0;                  ///< Addresses with a non-zero mask
+        mutable std::vector<WatchAccess> watch_log_;    ///< See watchLog()
+
+        std::vector<BusDevice *> devices_;                       ///< Attached devices, in order
+        std::vector<std::array<BusDevice *, 256>> device_pages_; ///< Per-address dispatch of device pages
+        std::array<uint8_t, 256> device_page_index_{};           ///< 1 + index into device_pages_; 0 = none
+
+        /// Expansion RAM banks 1..kRamBankCount-1 (null until first written).
+        using RamBank = std::array<uint8_t, kModuleWindowSize>;
+        std::array<std::unique_ptr<RamBank>, kRamBankCount> ram_banks_;
+        uint8_t ram_bank_ = 0;                        ///< RAM_BANK register value
+        std::bitset<kRamBankCount> ram_bank_dirty_;   ///< Expansion banks changed since the checkpoint
+        std::array<uint32_t, kModuleWindowSize / 256> ram_bank_generation_{}; ///< Window generations at mapRamBankStart()
+
+        std::array<uint32_t, 256> page_generation_{}; ///< Per-page RAM write counters
+        std::array<uint32_t, 256> clean_generation_{}; ///< page_generation_ at the last checkpoint
+        bool clean_valid_ = false;                     ///< A checkpoint has been taken
+        uint32_t rom_epoch_ = 0;                      ///< Bumped when ROM images change
+        mutable uint64_t side_effects_ = 0;           ///< See sideEffectCount()
     };
 } // namespace Computer
 
@@ -8,9 +8,12 @@
 
 #include <cstdint>
 #include <array>
+#include <functional>
 #include <vector>
 #include <string>
 
+#include "BusDevice.h"
+
 namespace Computer
 {
     /**
@@ -44,7 +47,7 @@ namespace Computer
      *
      * @see Memory, Computer6502
      */
-    class PIA
+    class PIA : public BusDevice
     {
     public:
         static constexpr uint16_t kPiaMemoryStart = 0xFE00;
@@ -114,6 +117,14 @@ namespace Computer
          */
         [[nodiscard]] bool isPiaAddress(uint16_t address) const;
 
+        /**
+         * @brief Check whether reading a register would change PIA state
+         * @param address PIA register address
+         * @return bool true when the read consumes a queued key or a stream
+         *         byte; status and control reads only report state
+         */
+        [[nodiscard]] bool readHasSideEffects(uint16_t address) const override;
+
         /**
          * @brief Write a value to PIA register space
          * @param address Memory address within PIA range
@@ -130,6 +141,11 @@ namespace Computer
          */
         uint8_t readPia(uint16_t address);
 
+        // BusDevice: the register block at kPiaMemoryStart-kPiaMemoryEnd
+        [[nodiscard]] BusRange busRange() const override { return {kPiaMemoryStart, kPiaMemoryEnd}; }
+        uint8_t busRead(const uint16_t address) override { return readPia(address); }
+        void busWrite(const uint16_t address, const uint8_t value) override { writePia(address, value); }
+
         /**
          * @brief Add a keypress to the input buffer
          * @param ascii_code ASCII code of the key pressed (0-127)
@@ -189,11 +205,22 @@ namespace Computer
 
         /**
          * @brief One tick of the VIA/CIA-style interval timer: assert the CPU
-         *        IRQ line. Driven by the host at wall-clock frequency (~60 Hz);
+         *        IRQ line. Computer6502 ticks it every
+         *        Computer6502::kJiffyCycles of emulated time (60 Hz at 1 MHz);
          *        the line stays asserted until the handler acks it via $DC0E.
          */
         void pulseTimerIrq();
 
+        /**
+         * @brief Set the doorbell rung when the guest starts a file operation
+         * @param doorbell Called from the kFileCommand write that needs host
+         *        work; it should arrange for processFileOperations() to run
+         *        at the next batch boundary (Computer6502 posts it as an
+         *        event). Without one, the CPU's batch is ended instead and
+         *        the host is expected to poll.
+         */
+        void setFileDoorbell(std::function<void()> doorbell) { file_doorbell_ = std::move(doorbell); }
+
         /**
          * @brief Check if a file operation is pending
          * @return bool true if load or save operation is queued
@@ -202,7 +229,8 @@ namespace Computer
 
         /**
          * @brief Process pending file operations
-         * @note Should be called regularly during CPU execution cycles
+         * @note Run when the file doorbell rings (see setFileDoorbell());
+         *       does nothing if no operation is pending.
          */
         void processFileOperations();
 
@@ -229,6 +257,7 @@ namespace Computer
         std::array<char, 12> filename_{};
         class Memory *memory_;
         class CPU6502 *cpu_ = nullptr;
+        std::function<void()> file_doorbell_;  // see setFileDoorbell()
 
         // Byte-stream file state (BASIC LOAD/SAVE)
         uint8_t stream_mode_ = kStreamNone;  // none / read / write
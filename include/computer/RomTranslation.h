@@ -0,0 +1,169 @@
+/**
+ * @file RomTranslation.h
+ * @brief Ahead-of-time C++ translations of the ROM images and their runtime
+ * @author 6502 Kernel Project
+ *
+ * tools/romc/romc.py turns a ROM image (plus its ld65 map) into a C++ file
+ * with one function per reachable basic block. Each function is a straight
+ * sequence of aotStep() calls, i.e. the same Isa::execute bodies the
+ * interpreter uses, with the operand bytes as compile-time constants. The
+ * generated file registers a RomTranslation with RomTranslations::builtin();
+ * Computer6502 binds the registered images against what is actually in memory
+ * and hands the directory to the CPU, which runs a translation whenever a
+ * batch reaches the start of a bound block.
+ */
+
+#ifndef ROMTRANSLATION_H
+#define ROMTRANSLATION_H
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "CPU6502Instructions.h"
+#include "Memory.h"
+
+namespace Computer
+{
+    /**
+     * @struct AotFrame
+     * @brief State a translated block runs against
+     *
+     * The batch context and exit conditions from CPU6502::runCycles(), plus
+     * how the block was bound, so every step can check that the bytes it was
+     * generated from are still the ones mapped.
+     */
+    struct AotFrame
+    {
+        Isa::DecodedContext *ctx;
+        const Memory *mem;
+        uint64_t end;              ///< Cycle count at which the batch ends
+        const std::atomic<bool> *attention;     ///< CPU6502::attention_
+        uint8_t page = 0;          ///< Page the block lives in
+        uint32_t generation = 0;   ///< Its write generation when verified
+        bool rom = false;          ///< Bound to ROM (no generation check)
+        int bank = -1;             ///< Module bank, or -1 outside the window
+
+        [[nodiscard]] bool current() const
+        {
+            return (bank < 0 || mem->currentBank() == bank) && (rom || mem->pageGeneration(page) == generation);
+        }
+    };
+
+    /// A translated basic block.
+    using TranslatedBlock = void (*)(AotFrame &frame);
+
+    /**
+     * @brief Run one instruction of a translated block
+     * @tparam Op, Mode, Cycles The opcode's entry in CPU6502_OPCODE_TABLE
+     * @return Whether the block may continue with its next instruction: the
+     *         same conditions that end a replayed BlockCache block
+     */
+    template <class Op, class Mode, unsigned Cycles>
+    inline bool aotStep(AotFrame &frame, const uint8_t operand_lo, const uint8_t operand_hi)
+    {
+        Isa::DecodedContext &ctx = *frame.ctx;
+        const uint8_t operands[2] = {operand_lo, operand_hi};
+        const uint16_t next = static_cast<uint16_t>(ctx.reg.PC + 1 + Mode::kOperandBytes);
+        ctx.operands = operands;
+        ctx.reg.PC++;
+        ctx.cycles++;
+        Isa::execute<Op, Mode, Cycles>(ctx);
+        return ctx.reg.PC == next && !frame.attention->load(std::memory_order_relaxed) && ctx.cycles < frame.end && frame.current();
+    }
+
+    /**
+     * @struct RomTranslation
+     * @brief One ROM image's generated code, as emitted by romc
+     */
+    struct RomTranslation
+    {
+        struct Block
+        {
+            uint16_t pc;           ///< Address of the first instruction
+            uint16_t length;       ///< Bytes covered by the block
+            TranslatedBlock code;
+        };
+
+        const char *name;          ///< ROM file name, for diagnostics
+        uint16_t base;             ///< Load address of image[0]
+        int bank;                  ///< Module bank, or -1 when not banked
+        const uint8_t *image;      ///< Bytes the code was generated from
+        size_t size;
+        const Block *blocks;
+        size_t block_count;
+    };
+
+    /**
+     * @class RomTranslations
+     * @brief Directory of bound ROM translations, indexed by PC
+     *
+     * bind() checks every block's bytes against memory and indexes the ones
+     * that match, so a ROM rebuilt without regenerating its translation, or a
+     * region loaded differently, simply falls back to the interpreter. Blocks
+     * in the DOS ROM and the module banks are read-only and never re-checked.
+     * Blocks in RAM-backed regions (the kernel image at $E000) remember their
+     * page's write generation; after a store to the page the block's bytes are
+     * compared again on its next use.
+     */
+    class RomTranslations
+    {
+    public:
+        /**
+         * @brief Register a generated translation (called from generated code
+         *        during static initialization)
+         * @return true, so it can initialize a static
+         */
+        static bool registerBuiltin(const RomTranslation &translation);
+
+        /// Every translation linked into this executable.
+        [[nodiscard]] static const std::vector<const RomTranslation *> &builtin();
+
+        RomTranslations();
+
+        /// Add a translation to be considered by the next bind().
+        void add(const RomTranslation &translation);
+
+        /**
+         * @brief Index the blocks whose bytes match memory
+         * @param mem Memory with all ROM images installed; the selected bank is
+         *        switched while checking banked images and then restored
+         * @return Number of blocks bound
+         */
+        size_t bind(Memory &mem);
+
+        /**
+         * @brief Find the translation for a block starting at @p pc
+         * @param mem Memory the block will run against
+         * @param pc Current program counter
+         * @param frame Receives how the block was bound (see AotFrame::current)
+         * @return The block, or nullptr to interpret
+         */
+        TranslatedBlock find(const Memory &mem, uint16_t pc, AotFrame &frame);
+
+        /// Number of blocks bound by the last bind().
+        [[nodiscard]] size_t boundCount() const { return bound_count_; }
+
+    private:
+        struct Slot
+        {
+            TranslatedBlock code = nullptr;
+            const uint8_t *bytes = nullptr;   ///< Source bytes, for re-checks
+            uint16_t length = 0;
+            uint32_t generation = 0;
+            bool rom = false;
+        };
+
+        static bool matches(const Memory &mem, uint16_t pc, const uint8_t *bytes, uint16_t length);
+
+        std::vector<const RomTranslation *> translations_;
+        std::vector<Slot> fixed_;                                   ///< Outside the window, by PC
+        std::array<std::vector<TranslatedBlock>, Memory::kBankCount> banked_; ///< By window offset
+        uint32_t epoch_ = 0;                                         ///< Memory::romEpoch() at bind
+        size_t bound_count_ = 0;
+    };
+} // namespace Computer
+
+#endif // ROMTRANSLATION_H
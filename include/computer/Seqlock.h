@@ -0,0 +1,102 @@
+/**
+ * @file Seqlock.h
+ * @brief Single-writer value that readers on other threads copy without locking
+ * @author 6502 Kernel Project
+ */
+
+#ifndef SEQLOCK_H
+#define SEQLOCK_H
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <thread>
+#include <type_traits>
+
+namespace Computer
+{
+    /**
+     * @class Seqlock
+     * @brief A published copy of a plain struct, updated by one thread and
+     *        read consistently by others
+     *
+     * The writer bumps a sequence number to odd, stores the value, and bumps
+     * it to even again. A reader copies the value between two reads of the
+     * sequence and retries if they differ or were odd, so it never sees half
+     * of one update and half of another, and the writer never waits for
+     * readers. The value is held as relaxed atomic words, which keeps the
+     * racing copy well-defined.
+     *
+     * @tparam T A trivially copyable struct (screen contents, a register set)
+     * @see EmulationThread
+     */
+    template <typename T>
+    class Seqlock
+    {
+        static_assert(std::is_trivially_copyable_v<T>, "Seqlock values are copied bytewise");
+
+    public:
+        Seqlock() { store(T{}); }
+
+        Seqlock(const Seqlock &) = delete;
+        Seqlock &operator=(const Seqlock &) = delete;
+
+        /// Publish a new value (writer thread only).
+        void store(const T &value)
+        {
+            std::array<uint64_t, kWords> words{};
+            std::memcpy(words.data(), &value, sizeof(T));
+
+            const uint32_t sequence = sequence_.load(std::memory_order_relaxed);
+            sequence_.store(sequence + 1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+            for (size_t i = 0; i < kWords; ++i)
+            {
+                words_[i].store(words[i], std::memory_order_relaxed);
+            }
+            sequence_.store(sequence + 2, std::memory_order_release);
+        }
+
+        /// Copy the latest complete value (any thread).
+        [[nodiscard]] T load() const
+        {
+            std::array<uint64_t, kWords> words{};
+            for (;;)
+            {
+                const uint32_t before = sequence_.load(std::memory_order_acquire);
+                if ((before & 1) == 0)
+                {
+                    for (size_t i = 0; i < kWords; ++i)
+                    {
+                        words[i] = words_[i].load(std::memory_order_relaxed);
+                    }
+                    std::atomic_thread_fence(std::memory_order_acquire);
+                    if (sequence_.load(std::memory_order_relaxed) == before)
+                    {
+                        break;
+                    }
+                }
+                std::this_thread::yield();
+            }
+
+            // Through void*: T may have default member initialisers, which
+            // makes it non-trivial (but still trivially copyable).
+            T value;
+            std::memcpy(static_cast<void *>(&value), words.data(), sizeof(T));
+            return value;
+        }
+
+        /// Changes with every store(); lets a reader skip an unchanged value.
+        [[nodiscard]] uint32_t version() const { return sequence_.load(std::memory_order_acquire); }
+
+    private:
+        static constexpr size_t kWords = (sizeof(T) + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+
+        std::array<std::atomic<uint64_t>, kWords> words_{};
+        std::atomic<uint32_t> sequence_{0};
+    };
+} // namespace Computer
+
+#endif // SEQLOCK_H
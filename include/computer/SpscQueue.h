@@ -0,0 +1,82 @@
+/**
+ * @file SpscQueue.h
+ * @brief Bounded lock-free queue for one producer thread and one consumer
+ * @author 6502 Kernel Project
+ */
+
+#ifndef SPSCQUEUE_H
+#define SPSCQUEUE_H
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+
+namespace Computer
+{
+    /**
+     * @class SpscQueue
+     * @brief Fixed-capacity ring buffer, wait-free for exactly one pusher and
+     *        one popper
+     *
+     * The producer only writes tail_ and the consumer only writes head_, so
+     * neither side ever blocks or retries: push() fails when the ring is full
+     * and pop() when it is empty. The indices run freely and are masked on
+     * use, which is why @p Capacity must be a power of two.
+     *
+     * @tparam T Element type (copied in and out)
+     * @tparam Capacity Number of slots, a power of two
+     * @see EmulationThread
+     */
+    template <typename T, size_t Capacity>
+    class SpscQueue
+    {
+        static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+
+    public:
+        /**
+         * @brief Append an element (producer thread only)
+         * @return bool false if the queue is full (the element is dropped)
+         */
+        bool push(const T &value)
+        {
+            const size_t tail = tail_.load(std::memory_order_relaxed);
+            if (tail - head_.load(std::memory_order_acquire) == Capacity)
+            {
+                return false;
+            }
+            slots_[tail & (Capacity - 1)] = value;
+            tail_.store(tail + 1, std::memory_order_release);
+            return true;
+        }
+
+        /**
+         * @brief Take the oldest element (consumer thread only)
+         * @param value Receives the element
+         * @return bool false if the queue is empty (@p value is untouched)
+         */
+        bool pop(T &value)
+        {
+            const size_t head = head_.load(std::memory_order_relaxed);
+            if (head == tail_.load(std::memory_order_acquire))
+            {
+                return false;
+            }
+            value = slots_[head & (Capacity - 1)];
+            head_.store(head + 1, std::memory_order_release);
+            return true;
+        }
+
+        /// Whether the queue looks empty (exact only on the consumer thread).
+        [[nodiscard]] bool empty() const
+        {
+            return head_.load(std::memory_order_acquire) == tail_.load(std::memory_order_acquire);
+        }
+
+    private:
+        std::array<T, Capacity> slots_{};
+        alignas(64) std::atomic<size_t> head_{0};   ///< Next slot to pop (consumer-owned)
+        alignas(64) std::atomic<size_t> tail_{0};   ///< Next slot to push (producer-owned)
+    };
+} // namespace Computer
+
+#endif // SPSCQUEUE_H
@@ -7,67 +7,121 @@
 #ifndef TIMINGCIRCUIT_H
 #define TIMINGCIRCUIT_H
 
+#include <array>
+#include <chrono>
 #include <cstdint>
 
 namespace Computer
 {
     /**
      * @class TimingCircuit
-     * @brief System timing circuit for CPU cycle timing control
+     * @brief Real-time pacer that holds emulation to a target clock
      *
-     * This class manages timing operations for the 6502 computer system,
-     * providing accurate cycle timing for proper CPU emulation. It helps
-     * maintain realistic execution speeds and timing accuracy.
+     * The emulator runs in time slices: a batch of sliceCycles() CPU cycles
+     * (1 ms of emulated time at the target clock), then pace(), which waits
+     * until the wall clock has caught up with the emulated one. Sleeping
+     * cannot honour one cycle (1 µs at 1 MHz) or even reliably one slice, so
+     * the pacer:
+     * - keeps a single time origin and computes every deadline from the
+     *   total cycles run since it, so an oversleep in one slice is repaid by
+     *   a shorter wait in the next (no accumulated drift);
+     * - sleeps for all but the last kSpinThreshold of a wait and yields in a
+     *   short spin for the rest, which hits the deadline closely without
+     *   burning a core for the whole wait;
+     * - forgets a backlog larger than kMaxLag (a stall in the host, a
+     *   debugger stop) instead of racing to catch up.
      *
-     * Features:
-     * - Target frequency management (typically 1 MHz for 6502)
-     * - Cycle-accurate timing delays
-     * - Actual frequency measurement and monitoring
-     * - Precise timing control for emulation accuracy
+     * Target clocks are 1, 2, 4 and 8 MHz (kSupportedFrequencies) or
+     * kUnthrottled, which never waits. getActualFrequency() reports the
+     * effective rate measured over the last kMeasureWindow either way.
      *
-     * The timing circuit ensures that the emulated 6502 runs at realistic
-     * speeds, preventing it from running too fast compared to original
-     * hardware while maintaining smooth operation.
-     *
-     * @see CPU6502, Computer6502
+     * @see Computer6502::runSlice
      */
     class TimingCircuit
     {
     public:
+        using Clock = std::chrono::steady_clock;
+
+        /// Target frequency that runs as fast as the host allows.
+        static constexpr uint32_t kUnthrottled = 0;
+
+        /// Selectable target clocks, in Hz.
+        static constexpr std::array<uint32_t, 4> kSupportedFrequencies{1000000, 2000000, 4000000, 8000000};
+
+        /// Emulated time per slice.
+        static constexpr std::chrono::microseconds kSlice{1000};
+
+        /// Cycles per slice when unthrottled (long enough to amortise the
+        /// per-slice overhead).
+        static constexpr uint64_t kUnthrottledSliceCycles = 20000;
+
+        /// Remaining wait below which pace() spins instead of sleeping.
+        static constexpr std::chrono::microseconds kSpinThreshold{200};
+
+        /// Backlog beyond which pace() re-bases instead of catching up.
+        static constexpr std::chrono::milliseconds kMaxLag{50};
+
+        /// Span over which getActualFrequency() is measured.
+        static constexpr std::chrono::milliseconds kMeasureWindow{250};
+
         /**
          * @brief Construct a new TimingCircuit
          *
-         * Initializes the timing circuit with default 6502 frequency
-         * and sets up timing parameters for cycle-accurate emulation.
+         * Starts paced at 1 MHz, the 65C02's nominal clock.
          */
         TimingCircuit();
 
         /**
-         * @brief Wait for one CPU cycle to complete
-         *
-         * Delays execution to maintain proper timing for the next
-         * CPU cycle. This ensures the emulated CPU runs at realistic
-         * speeds rather than maximum host CPU speed.
+         * @brief Select the target clock
+         * @param hz One of kSupportedFrequencies, or kUnthrottled; any other
+         *        value is used as given (below 1 kHz each slice is a single
+         *        cycle, paced to 1/@p hz)
+         * @note Restarts pacing (and the measurement) from now.
          */
-        void waitForCycle();
+        void setTargetFrequency(uint32_t hz);
 
         /**
-         * @brief Get the actual measured frequency of the emulation
-         * @return double Actual frequency in Hz (cycles per second)
-         * @note Used for performance monitoring and timing verification
+         * @brief Get the target frequency for the emulation
+         * @return uint32_t Target frequency in Hz, or kUnthrottled
          */
-        [[nodiscard]] double getActualFrequency() const;
+        [[nodiscard]] uint32_t getTargetFrequency() const;
+
+        /// Whether pace() never waits.
+        [[nodiscard]] bool isUnthrottled() const { return clock_frequency_ == kUnthrottled; }
 
         /**
-         * @brief Get the target frequency for the emulation
-         * @return uint32_t Target frequency in Hz (typically 1,000,000 for 1 MHz)
+         * @brief CPU cycles to run before the next pace()
+         * @return uint64_t One kSlice at the target clock (at least one
+         *         cycle), or kUnthrottledSliceCycles
          */
-        [[nodiscard]] uint32_t getTargetFrequency() const;
+        [[nodiscard]] uint64_t sliceCycles() const;
+
+        /**
+         * @brief Account for a slice and wait until real time catches up
+         * @param cycles CPU cycles just executed
+         * @note Blocks for up to about one slice; returns at once when
+         *       unthrottled or behind.
+         */
+        void pace(uint64_t cycles);
+
+        /// Take now as the origin for deadlines (after a pause in running).
+        void restart();
+
+        /**
+         * @brief Get the actual measured frequency of the emulation
+         * @return double Cycles per second over the last kMeasureWindow, or 0
+         *         before the first window completes
+         * @note Used for performance monitoring and timing verification
+         */
+        [[nodiscard]] double getActualFrequency() const;
 
     private:
-        uint32_t clock_frequency_;    ///< Target clock frequency in Hz
-        uint64_t cycle_time_ns_;      ///< Target cycle time in nanoseconds
-        uint64_t actual_cycle_time_;  ///< Actual measured cycle time
+        uint32_t clock_frequency_;          ///< Target clock frequency in Hz (0 = unthrottled)
+        Clock::time_point origin_;          ///< Wall time at which paced_cycles_ was 0
+        uint64_t paced_cycles_ = 0;         ///< Cycles accounted since origin_
+        Clock::time_point measure_start_;   ///< Start of the current measurement window
+        uint64_t measure_cycles_ = 0;       ///< Cycles accounted in that window
+        double actual_frequency_ = 0.0;     ///< Rate over the last completed window
     };
 } // namespace Computer
 
@@ -9,9 +9,12 @@
 
 #include <cstdint>
 #include <array>
+#include <span>
 
 namespace Computer
 {
+    class Memory;
+
     /**
      * @class VIC
      * @brief VIC-II Video Interface Chip emulator for text mode display
@@ -28,7 +31,12 @@ namespace Computer
      * - Direct character access and manipulation
      *
      * The VIC chip interfaces with the 6502 memory system to provide video
-     * output for the monitor program and system display.
+     * output for the monitor program and system display. Screen memory lives
+     * in the system RAM (Memory::setVideoChip() binds it), so CPU stores to
+     * it are plain RAM writes. The VIC's own edits go through Memory too,
+     * so they dirty the screen pages like a CPU store. The VIC finds the
+     * rows that changed by comparing the screen with what was last displayed
+     * (see dirtyRows()).
      *
      * @see Memory, Computer6502
      */
@@ -41,15 +49,38 @@ namespace Computer
         static constexpr uint16_t kScreenMemoryStart = 0x0400;
         static constexpr uint16_t kScreenMemoryEnd = 0x07E7;
 
+        /// Bit n of dirtyRows() is screen row n.
+        static constexpr uint32_t kAllRows = (1u << kScreenHeight) - 1;
+
         VIC();
 
+        // The screen may point into the VIC itself.
+        VIC(const VIC &) = delete;
+        VIC &operator=(const VIC &) = delete;
+
+        /**
+         * @brief Use @p backing (kScreenSize bytes of system RAM) as screen
+         *        memory, carrying the current contents over
+         * @param backing Screen memory, or null to go back to the VIC's own
+         * @param memory Memory that owns @p backing; the VIC's screen edits
+         *        are written through it (null when @p backing is null)
+         */
+        void bindScreen(uint8_t *backing, Memory *memory);
+
+        /**
+         * @brief Take over another VIC's screen contents, cursor and
+         *        displayed-state snapshot
+         * @param other VIC to copy (its screen memory stays where it is)
+         */
+        void copyStateFrom(const VIC &other);
+
         // Memory-mapped I/O interface
         [[nodiscard]] bool isScreenAddress(uint16_t address) const;
         void writeScreen(uint16_t address, uint8_t value);
         [[nodiscard]] uint8_t readScreen(uint16_t address) const;
 
         // Display buffer access
-        [[nodiscard]] const std::array<uint8_t, kScreenSize> &getScreenBuffer() const;
+        [[nodiscard]] std::span<const uint8_t, kScreenSize> getScreenBuffer() const;
         [[nodiscard]] uint8_t getCharacterAt(uint16_t x, uint16_t y) const;
         void setCharacterAt(uint16_t x, uint16_t y, uint8_t character);
 
@@ -61,15 +92,28 @@ namespace Computer
 
         // Status and control
         [[nodiscard]] bool isDirty() const;
+
+        /**
+         * @brief Rows changed since the last clearDirty()
+         * @return Mask with bit n set when row n differs from what was last
+         *         displayed (kAllRows before the first clearDirty())
+         */
+        [[nodiscard]] uint32_t dirtyRows() const;
+
+        /// Record the current screen as displayed.
         void clearDirty();
 
     private:
-        std::array<uint8_t, kScreenSize> screen_buffer_{};
+        std::array<uint8_t, kScreenSize> own_screen_{};         ///< Screen memory while unbound
+        std::span<uint8_t, kScreenSize> screen_buffer_{own_screen_};
+        Memory *memory_ = nullptr;                              ///< Owner of screen_buffer_ while bound
+        std::array<uint8_t, kScreenSize> shown_{};              ///< Screen at the last clearDirty()
         uint16_t cursor_x_;
         uint16_t cursor_y_;
-        bool dirty_flag_;
+        bool shown_valid_ = false;                              ///< shown_ has been recorded
 
         // Helper functions
+        void store(uint16_t offset, std::span<const uint8_t> bytes);
         [[nodiscard]] uint16_t addressToOffset(uint16_t address) const;
         [[nodiscard]] uint16_t coordinatesToOffset(uint16_t x, uint16_t y) const;
         void offsetToCoordinates(uint16_t offset, uint16_t &x, uint16_t &y) const;
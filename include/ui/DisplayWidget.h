@@ -7,17 +7,17 @@
 #include <QPainter>
 #include <QPaintEvent>
 #include <QKeyEvent>
-#include "VIC.h"
-#include "Memory.h"
+#include "EmulationThread.h"
 
 class DisplayWidget : public QWidget
 {
     Q_OBJECT
 
 public:
-    // memory is used to read the kernel's tracked cursor position
-    // (CURSOR_X/CURSOR_Y) so the on-screen cursor follows where text is typed.
-    DisplayWidget(Computer::VIC* video_chip, Computer::Memory* memory, QWidget* parent = nullptr);
+    // Shows the screen the emulation thread publishes, including the kernel's
+    // tracked cursor position (CURSOR_X/CURSOR_Y), so the widget never reads
+    // the machine while it runs.
+    DisplayWidget(const Computer::EmulationThread* emulation, QWidget* parent = nullptr);
 
     // Display configuration
     void setCharacterSize(int width, int height);
@@ -45,8 +45,9 @@ private slots:
     void blinkCursor();
 
 private:
-    Computer::VIC* video_chip_;
-    Computer::Memory* memory_;
+    const Computer::EmulationThread* emulation_;
+    Computer::ScreenFrame frame_;   // Screen as last painted
+    uint32_t frame_version_;        // emulation_->screenVersion() of frame_
     QTimer* refresh_timer_;
     
     // Display settings
@@ -64,6 +65,7 @@ private:
     // Cursor state
     bool show_cursor_;
     QTimer* cursor_timer_;
+    int cursor_cell_;   // CURSOR_Y * width + CURSOR_X at the last refresh, -1 = none
     
     // Helper methods
     void setupFont();
@@ -71,6 +73,8 @@ private:
     QChar asciiToChar(uint8_t ascii_code) const;
     void drawCharacterAt(QPainter& painter, int x, int y, uint8_t character);
     void drawCursor(QPainter& painter);
+    int cursorCell() const;
+    void updateRow(int row);
     uint8_t qtKeyToAscii(QKeyEvent* event) const;
 };
 
@@ -8,6 +8,7 @@
 #include <QLabel>
 #include <QTimer>
 #include "Computer6502.h"
+#include "EmulationThread.h"
 #include "DisplayWidget.h"
 
 class MainWindow : public QMainWindow
@@ -44,6 +45,7 @@ private:
     QPushButton* nmi_button_;
 
     QLabel* status_label_;
+    QLabel* speed_label_;   ///< effective clock rate, in the status bar
     
     // Status sidebar labels
     QLabel* cpu_header_label_;
@@ -58,13 +60,11 @@ private:
     
     QTimer* status_timer_;
     
-    // Computer system
+    // Computer system. The machine runs on emulation_'s thread; the UI only
+    // talks to it through emulation_ (queued keys and requests, published
+    // screen and registers).
     Computer::Computer6502* computer_;
-    QTimer* execution_timer_;
-    QTimer* irq_timer_;   ///< drives the PIA interval-timer IRQ at ~60 Hz
-    
-    bool is_running_;
-    int execution_cycle_count_;
+    Computer::EmulationThread* emulation_;
 };
 
 #endif // MAINWINDOW_H
\ No newline at end of file
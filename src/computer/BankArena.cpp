@@ -0,0 +1,175 @@
+#include "BankArena.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iterator>
+#include <new>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define BANKARENA_MMAP
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace Computer
+{
+    namespace
+    {
+        size_t hostPageSize()
+        {
+#ifdef BANKARENA_MMAP
+            const long size = sysconf(_SC_PAGESIZE);
+            return size > 0 ? static_cast<size_t>(size) : 4096;
+#else
+            return 4096;
+#endif
+        }
+
+        size_t roundUp(const size_t value, const size_t multiple)
+        {
+            return (value + multiple - 1) / multiple * multiple;
+        }
+
+        std::vector<uint8_t> readFile(const std::string &path)
+        {
+            std::ifstream file(path, std::ios::binary);
+            return {std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()};
+        }
+    } // namespace
+
+    BankArena::BankArena() : stride_(roundUp(kBankSize, hostPageSize()))
+    {
+#ifdef BANKARENA_MMAP
+        // Reserved read-only and zero-filled; only installed banks get pages.
+        void *region = mmap(nullptr, stride_ * kBankCount, PROT_READ, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE,
+                            -1, 0);
+        if (region == MAP_FAILED)
+        {
+            throw std::bad_alloc();
+        }
+        base_ = static_cast<uint8_t *>(region);
+#else
+        base_ = new uint8_t[stride_ * kBankCount]();
+#endif
+    }
+
+    BankArena::~BankArena()
+    {
+#ifdef BANKARENA_MMAP
+        munmap(base_, stride_ * kBankCount);
+#else
+        delete[] base_;
+#endif
+    }
+
+    BankArena::BankArena(const BankArena &other) : BankArena()
+    {
+        for (int bank = 1; bank < kBankCount; ++bank)
+        {
+            const Slot &from = other.slots_[bank];
+            if (!from.path.empty())
+            {
+                slots_[bank] = Slot{State::Pending, from.path};
+            }
+            else if (from.state == State::Ready)
+            {
+                const uint8_t *image = other.slot(static_cast<uint8_t>(bank));
+                load(static_cast<uint8_t>(bank), std::vector<uint8_t>(image, image + kBankSize));
+            }
+        }
+    }
+
+    void BankArena::clearSlot(const uint8_t bank)
+    {
+#ifdef BANKARENA_MMAP
+        mmap(slot(bank), stride_, PROT_READ, MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED, -1, 0);
+#else
+        std::fill_n(slot(bank), stride_, 0x00);
+#endif
+    }
+
+    void BankArena::load(const uint8_t bank, const std::vector<uint8_t> &image)
+    {
+        if (bank == 0)
+        {
+            return;
+        }
+
+        std::lock_guard lock(mutex_);
+        clearSlot(bank);
+        const size_t n = std::min(image.size(), kBankSize);
+#ifdef BANKARENA_MMAP
+        mprotect(slot(bank), stride_, PROT_READ | PROT_WRITE);
+        std::copy_n(image.begin(), n, slot(bank));
+        mprotect(slot(bank), stride_, PROT_READ);
+#else
+        std::copy_n(image.begin(), n, slot(bank));
+#endif
+        slots_[bank] = Slot{State::Ready, {}};
+    }
+
+    bool BankArena::loadFile(const uint8_t bank, const std::string &path)
+    {
+        if (bank == 0 || !std::ifstream(path, std::ios::binary).is_open())
+        {
+            return false;
+        }
+
+        std::lock_guard lock(mutex_);
+        clearSlot(bank);
+        slots_[bank] = Slot{State::Pending, path};
+        return true;
+    }
+
+    const uint8_t *BankArena::bank(const uint8_t bank)
+    {
+        std::lock_guard lock(mutex_);
+        switch (slots_[bank].state)
+        {
+            case State::Empty:
+                return nullptr;
+            case State::Pending:
+                mapFile(bank);
+                slots_[bank].state = State::Ready;
+                break;
+            case State::Ready:
+                break;
+        }
+        return slot(bank);
+    }
+
+    void BankArena::mapFile(const uint8_t bank)
+    {
+        // A file that has gone away since loadFile() leaves the slot zero.
+#ifdef BANKARENA_MMAP
+        const int fd = open(slots_[bank].path.c_str(), O_RDONLY);
+        if (fd < 0)
+        {
+            return;
+        }
+        struct stat info{};
+        const size_t size = fstat(fd, &info) == 0 ? static_cast<size_t>(info.st_size) : 0;
+        const size_t length = std::min(size, kBankSize);
+        if (length > 0)
+        {
+            // Only the pages the file covers; the rest of the slot stays zero.
+            // The tail of the last page past end of file reads as zero too.
+            const size_t mapped = roundUp(length, hostPageSize());
+            if (mmap(slot(bank), mapped, PROT_READ, MAP_PRIVATE | MAP_FIXED, fd, 0) == MAP_FAILED)
+            {
+                clearSlot(bank);
+                const std::vector<uint8_t> image = readFile(slots_[bank].path);
+                mprotect(slot(bank), stride_, PROT_READ | PROT_WRITE);
+                std::copy_n(image.begin(), std::min(image.size(), kBankSize), slot(bank));
+                mprotect(slot(bank), stride_, PROT_READ);
+            }
+        }
+        close(fd);
+#else
+        const std::vector<uint8_t> image = readFile(slots_[bank].path);
+        std::copy_n(image.begin(), std::min(image.size(), kBankSize), slot(bank));
+#endif
+    }
+} // namespace Computer
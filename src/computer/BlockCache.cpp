@@ -0,0 +1,211 @@
+#include "BlockCache.h"
+
+#include "CPU6502Instructions.h"
+
+namespace Computer
+{
+    namespace
+    {
+        bool inModuleWindow(const uint16_t address)
+        {
+            return address >= Memory::kModuleWindowStart && address <= Memory::kModuleWindowEnd;
+        }
+
+        size_t slotIndex(const uint16_t pc, const uint8_t bank)
+        {
+            // Banked blocks share PCs; spread them over different slots.
+            return (pc + bank * 0x3B1u) & (BlockCache::kSlotCount - 1);
+        }
+
+        bool isLoadStorePair(const uint8_t lda, const uint8_t sta)
+        {
+            switch ((lda << 8) | sta)
+            {
+#define CPU6502_LOAD_STORE_CASE(load, store) case (load << 8) | store:
+                CPU6502_FUSED_LOAD_STORE(CPU6502_LOAD_STORE_CASE)
+#undef CPU6502_LOAD_STORE_CASE
+                return true;
+            default:
+                return false;
+            }
+        }
+
+        // The idiom starting with insn[0], given the records left in the block.
+        BlockCache::Fusion idiomAt(const BlockCache::Instruction *insn, const int remaining)
+        {
+            using Fusion = BlockCache::Fusion;
+            if (remaining >= 4 && insn[0].opcode == 0xAD && insn[1].opcode == 0x91 &&
+                insn[2].opcode == 0xC8 && insn[3].opcode == 0xD0)
+            {
+                return Fusion::SectorCopy;
+            }
+            if (remaining < 2)
+            {
+                return Fusion::None;
+            }
+            const uint8_t first = insn[0].opcode;
+            const uint8_t second = insn[1].opcode;
+            if ((first == 0xCA || first == 0x88) && second == 0xD0)
+            {
+                return Fusion::CountdownBranch;
+            }
+            if (first == 0xC9 && (second == 0xF0 || second == 0xD0))
+            {
+                return Fusion::CompareBranch;
+            }
+            if (first == 0xE6 && second == 0xD0)
+            {
+                return Fusion::IncrementBranch;
+            }
+            if (isLoadStorePair(first, second))
+            {
+                return Fusion::LoadStore;
+            }
+            return Fusion::None;
+        }
+    } // namespace
+
+    const char *BlockCache::fusionName(const Fusion fusion)
+    {
+        switch (fusion)
+        {
+        case Fusion::CountdownBranch: return "DEX/DEY+BNE";
+        case Fusion::LoadStore: return "LDA+STA";
+        case Fusion::CompareBranch: return "CMP#+BEQ/BNE";
+        case Fusion::IncrementBranch: return "INC zp+BNE";
+        case Fusion::SectorCopy: return "LDA/STA(zp),Y/INY/BNE";
+        case Fusion::None: break;
+        }
+        return "none";
+    }
+
+    BlockCache::BlockCache() : slots_(kSlotCount)
+    {
+    }
+
+    BlockCache::Block &BlockCache::lookup(const Memory &mem, const uint16_t pc)
+    {
+        const bool windowed = inModuleWindow(pc);
+        const uint8_t bank = windowed ? mem.currentBank() : 0;
+        Block &slot = slots_[slotIndex(pc, bank)];
+
+        if (slot.count != 0 && slot.pc == pc && slot.bank == bank && slot.windowed == windowed &&
+            slot.epoch == mem.romEpoch() && slot.isCurrent(mem))
+        {
+            return slot;
+        }
+
+        decode(mem, pc, bank, slot);
+        if (slot.count != 0)
+        {
+            return slot;
+        }
+
+        decodeUncached(mem, pc);
+        return scratch_;
+    }
+
+    void BlockCache::clear()
+    {
+        for (Block &slot : slots_)
+        {
+            slot.count = 0;
+        }
+    }
+
+    void BlockCache::dropTranslations()
+    {
+        for (Block &slot : slots_)
+        {
+            slot.native = nullptr;
+        }
+    }
+
+    void BlockCache::decode(const Memory &mem, const uint16_t pc, const uint8_t bank, Block &block)
+    {
+        ++decode_count_;
+        block.pc = pc;
+        block.bank = bank;
+        block.count = 0;
+        block.windowed = inModuleWindow(pc);
+        block.rom = mem.isRomAddress(pc);
+        block.generation = mem.pageGeneration(pc >> 8);
+        block.epoch = mem.romEpoch();
+        block.executions = 0;
+        block.native = nullptr;
+
+        const uint8_t page = pc >> 8;
+        // A plain RAM/ROM page is read straight from its backing bytes; in a
+        // device page every byte has to be checked and read through the bus.
+        const uint8_t *const code = mem.codePage(page);
+        auto cacheable = [&](const uint16_t at) { return code || mem.isCodeCacheable(at); };
+        auto fetch = [&](const uint16_t at) { return code ? code[at & 0xFF] : mem.read(at); };
+
+        uint16_t address = pc;
+        while (block.count < kMaxInstructions)
+        {
+            // Every byte of the instruction must be plain memory in this page;
+            // otherwise the block ends before it.
+            if ((address >> 8) != page || !cacheable(address))
+            {
+                break;
+            }
+            const uint8_t opcode = fetch(address);
+            const uint8_t length = Isa::kInstructionLength[opcode];
+            const uint16_t last = static_cast<uint16_t>(address + length - 1);
+            if ((last >> 8) != page || !cacheable(last))
+            {
+                break;
+            }
+
+            Instruction &insn = block.instructions[block.count++];
+            insn.opcode = opcode;
+            insn.length = length;
+            insn.operands[0] = length > 1 ? fetch(static_cast<uint16_t>(address + 1)) : 0;
+            insn.operands[1] = length > 2 ? fetch(static_cast<uint16_t>(address + 2)) : 0;
+
+            if (Isa::endsBlock(opcode))
+            {
+                break;
+            }
+            address = static_cast<uint16_t>(address + length);
+        }
+        fuse(block);
+    }
+
+    void BlockCache::fuse(Block &block)
+    {
+        // Greedy and non-overlapping, longest idiom first.
+        for (int i = 0; i < block.count;)
+        {
+            Instruction *insn = &block.instructions[i];
+            const Fusion fusion = idiomAt(insn, block.count - i);
+            const uint8_t records = kFusionLength[static_cast<size_t>(fusion)];
+            insn->fusion = fusion;
+            insn->fused_length = 0;
+            for (uint8_t r = 0; r < records; ++r)
+            {
+                insn->fused_length = static_cast<uint8_t>(insn->fused_length + insn[r].length);
+                if (r > 0)
+                {
+                    insn[r].fusion = Fusion::None;
+                }
+            }
+            i += records;
+        }
+    }
+
+    void BlockCache::decodeUncached(const Memory &mem, const uint16_t pc)
+    {
+        // Fetch exactly the bytes the interpreter would, in the same order.
+        Instruction &insn = scratch_.instructions[0];
+        insn.opcode = mem.read(pc);
+        insn.length = Isa::kInstructionLength[insn.opcode];
+        insn.operands[0] = insn.length > 1 ? mem.read(static_cast<uint16_t>(pc + 1)) : 0;
+        insn.operands[1] = insn.length > 2 ? mem.read(static_cast<uint16_t>(pc + 2)) : 0;
+        insn.fusion = Fusion::None;
+        scratch_.pc = pc;
+        scratch_.count = 1;
+        scratch_.transient = true;
+    }
+} // namespace Computer
@@ -14,11 +14,21 @@ namespace Computer
         image_path_ = image_path;
     }
 
+    void BlockDevice::freezeImage()
+    {
+        frozen_ = true;
+    }
+
     bool BlockDevice::isBlockAddress(const uint16_t address)
     {
         return address >= kRegLbaLo && address <= kRegData;
     }
 
+    bool BlockDevice::readHasSideEffects(const uint16_t address) const
+    {
+        return address == kRegData;
+    }
+
     uint8_t BlockDevice::read(const uint16_t address)
     {
         switch (address)
@@ -85,6 +95,13 @@ namespace Computer
         // sectors past the current end-of-file are well-defined.
         buffer_.fill(0x00);
 
+        if (const auto written = overlay_.find(lba_); written != overlay_.end())
+        {
+            buffer_ = *written->second;
+            status_ = kStatusReady;
+            return;
+        }
+
         std::ifstream image(image_path_, std::ios::binary);
         if (!image.is_open())
         {
@@ -109,6 +126,13 @@ namespace Computer
 
     void BlockDevice::writeSector()
     {
+        if (frozen_)
+        {
+            overlay_[lba_] = std::make_shared<const Sector>(buffer_);
+            status_ = kStatusReady;
+            return;
+        }
+
         // Open read/write without truncating so other sectors survive; create the
         // image on first use. fstream won't create a missing file in in|out mode,
         // so fall back to a create pass when the open fails.
@@ -0,0 +1,1131 @@
+#include "BlockJit.h"
+
+#ifdef CPU6502_JIT
+
+#include <array>
+#include <cstddef>
+#include <cstring>
+#include <functional>
+#include <initializer_list>
+#include <map>
+#include <vector>
+
+#include <sys/mman.h>
+
+#include "CPU6502Instructions.h"
+
+namespace Computer
+{
+    namespace
+    {
+        using Step = bool (*)(JitFrame *frame, const BlockCache::Instruction *insn);
+
+        // One replayed instruction; mirrors the body of runCycles()' replay
+        // loop. Returns whether the translation may run the next record.
+        template <class Op, class Mode, unsigned Cycles>
+        bool step(JitFrame *frame, const BlockCache::Instruction *insn)
+        {
+            Isa::DecodedContext &ctx = *frame->ctx;
+            const uint16_t next = static_cast<uint16_t>(ctx.reg.PC + insn->length);
+            ctx.operands = insn->operands.data();
+            ctx.reg.PC++;
+            ctx.cycles++;
+            Isa::execute<Op, Mode, Cycles>(ctx);
+            return ctx.reg.PC == next && !frame->attention->load(std::memory_order_relaxed) && ctx.cycles < frame->end &&
+                   frame->block->isCurrent(*frame->mem);
+        }
+
+#define CPU6502_JIT_STEP_ENTRY(opcode, op, mode, cycles) &step<Isa::op, Isa::mode, cycles>,
+        constexpr std::array<Step, 256> kSteps = {{CPU6502_OPCODE_TABLE(CPU6502_JIT_STEP_ENTRY)}};
+#undef CPU6502_JIT_STEP_ENTRY
+
+        // Bus accesses the inline fast paths leave to Memory: device pages,
+        // ROM writes and unmapped pages.
+        uint32_t slowRead(JitFrame *frame, const uint32_t address)
+        {
+            return frame->ctx->read(static_cast<uint16_t>(address));
+        }
+
+        void slowWrite(JitFrame *frame, const uint32_t address, const uint32_t value)
+        {
+            frame->ctx->write(static_cast<uint16_t>(address), static_cast<uint8_t>(value));
+        }
+
+        uint32_t slowPointer(JitFrame *frame, const uint32_t zp)
+        {
+            return Isa::zeroPagePointer(*frame->ctx, static_cast<uint8_t>(zp));
+        }
+
+        // -------------------------------------------------------------------
+        // What an opcode compiles to. Classified from CPU6502_OPCODE_TABLE so
+        // the cycle counts and page penalties are the interpreter's own.
+        // -------------------------------------------------------------------
+
+        enum class Kind : uint8_t
+        {
+            Step,       ///< Call the interpreter's body
+            Load,       ///< LDA/LDX/LDY
+            Store,      ///< STA/STX/STY/STZ
+            Logic,      ///< AND/ORA/EOR
+            Adc,
+            Sbc,
+            Compare,    ///< CMP/CPX/CPY
+            IncDec,     ///< INC/DEC memory or A
+            Count,      ///< INX/INY/DEX/DEY
+            Transfer,   ///< TAX/TAY/TXA/TYA/TSX/TXS
+            Flag,       ///< CLC/SEC/CLI/SEI/CLD/SED/CLV
+            Nop,
+            Branch,     ///< Bxx on a status flag
+            Bra,
+            Jmp,
+            Jsr,
+            Rts,
+        };
+
+        enum class Field : uint8_t { A, X, Y, SP, None };
+
+        struct NativeOp
+        {
+            Kind kind = Kind::Step;
+            Field reg = Field::None;    ///< Register read or written
+            Field dest = Field::None;   ///< Transfer destination
+            uint8_t alu = 0;            ///< x86 "op r8, r/m8" opcode (Logic)
+            int8_t delta = 0;           ///< IncDec/Count: +1 or -1
+            uint8_t flag = 0;           ///< Flag/Branch: status bit
+            bool set = false;           ///< Flag/Branch: value
+        };
+
+        template <class Op> constexpr NativeOp kNativeOp{};
+        template <> constexpr NativeOp kNativeOp<Isa::Lda>{.kind = Kind::Load, .reg = Field::A};
+        template <> constexpr NativeOp kNativeOp<Isa::Ldx>{.kind = Kind::Load, .reg = Field::X};
+        template <> constexpr NativeOp kNativeOp<Isa::Ldy>{.kind = Kind::Load, .reg = Field::Y};
+        template <> constexpr NativeOp kNativeOp<Isa::Sta>{.kind = Kind::Store, .reg = Field::A};
+        template <> constexpr NativeOp kNativeOp<Isa::Stx>{.kind = Kind::Store, .reg = Field::X};
+        template <> constexpr NativeOp kNativeOp<Isa::Sty>{.kind = Kind::Store, .reg = Field::Y};
+        template <> constexpr NativeOp kNativeOp<Isa::Stz>{.kind = Kind::Store};
+        template <> constexpr NativeOp kNativeOp<Isa::And>{.kind = Kind::Logic, .alu = 0x22};
+        template <> constexpr NativeOp kNativeOp<Isa::Ora>{.kind = Kind::Logic, .alu = 0x0A};
+        template <> constexpr NativeOp kNativeOp<Isa::Eor>{.kind = Kind::Logic, .alu = 0x32};
+        template <> constexpr NativeOp kNativeOp<Isa::Adc>{.kind = Kind::Adc};
+        template <> constexpr NativeOp kNativeOp<Isa::Sbc>{.kind = Kind::Sbc};
+        template <> constexpr NativeOp kNativeOp<Isa::Cmp>{.kind = Kind::Compare, .reg = Field::A};
+        template <> constexpr NativeOp kNativeOp<Isa::Cpx>{.kind = Kind::Compare, .reg = Field::X};
+        template <> constexpr NativeOp kNativeOp<Isa::Cpy>{.kind = Kind::Compare, .reg = Field::Y};
+        template <> constexpr NativeOp kNativeOp<Isa::Inc>{.kind = Kind::IncDec, .delta = 1};
+        template <> constexpr NativeOp kNativeOp<Isa::Dec>{.kind = Kind::IncDec, .delta = -1};
+        template <> constexpr NativeOp kNativeOp<Isa::Inx>{.kind = Kind::Count, .reg = Field::X, .delta = 1};
+        template <> constexpr NativeOp kNativeOp<Isa::Iny>{.kind = Kind::Count, .reg = Field::Y, .delta = 1};
+        template <> constexpr NativeOp kNativeOp<Isa::Dex>{.kind = Kind::Count, .reg = Field::X, .delta = -1};
+        template <> constexpr NativeOp kNativeOp<Isa::Dey>{.kind = Kind::Count, .reg = Field::Y, .delta = -1};
+        template <> constexpr NativeOp kNativeOp<Isa::Tax>{.kind = Kind::Transfer, .reg = Field::A, .dest = Field::X};
+        template <> constexpr NativeOp kNativeOp<Isa::Tay>{.kind = Kind::Transfer, .reg = Field::A, .dest = Field::Y};
+        template <> constexpr NativeOp kNativeOp<Isa::Txa>{.kind = Kind::Transfer, .reg = Field::X, .dest = Field::A};
+        template <> constexpr NativeOp kNativeOp<Isa::Tya>{.kind = Kind::Transfer, .reg = Field::Y, .dest = Field::A};
+        template <> constexpr NativeOp kNativeOp<Isa::Tsx>{.kind = Kind::Transfer, .reg = Field::SP, .dest = Field::X};
+        template <> constexpr NativeOp kNativeOp<Isa::Txs>{.kind = Kind::Transfer, .reg = Field::X, .dest = Field::SP};
+        template <uint8_t Flag, bool Value>
+        constexpr NativeOp kNativeOp<Isa::FlagOp<Flag, Value>>{.kind = Kind::Flag, .flag = Flag, .set = Value};
+        template <> constexpr NativeOp kNativeOp<Isa::Nop>{.kind = Kind::Nop};
+        template <uint8_t Flag, bool Set>
+        constexpr NativeOp kNativeOp<Isa::Branch<Flag, Set>>{.kind = Kind::Branch, .flag = Flag, .set = Set};
+        template <> constexpr NativeOp kNativeOp<Isa::Bra>{.kind = Kind::Bra};
+        template <> constexpr NativeOp kNativeOp<Isa::Jmp>{.kind = Kind::Jmp};
+        template <> constexpr NativeOp kNativeOp<Isa::Jsr>{.kind = Kind::Jsr};
+        template <> constexpr NativeOp kNativeOp<Isa::Rts>{.kind = Kind::Rts};
+
+        enum class ModeKind : uint8_t
+        {
+            Other,      ///< Only reached through a step call
+            Implied,
+            Accumulator,
+            Immediate,
+            ZeroPage,
+            ZeroPageX,
+            ZeroPageY,
+            Absolute,
+            AbsoluteX,
+            AbsoluteY,
+            IndirectIndexed,
+            ZeroPageIndirect,
+            Relative,
+        };
+
+        template <class Mode> constexpr ModeKind kModeKind = ModeKind::Other;
+        template <> constexpr ModeKind kModeKind<Isa::Implied> = ModeKind::Implied;
+        template <> constexpr ModeKind kModeKind<Isa::Accumulator> = ModeKind::Accumulator;
+        template <> constexpr ModeKind kModeKind<Isa::Immediate> = ModeKind::Immediate;
+        template <> constexpr ModeKind kModeKind<Isa::ZeroPage> = ModeKind::ZeroPage;
+        template <> constexpr ModeKind kModeKind<Isa::ZeroPageX> = ModeKind::ZeroPageX;
+        template <> constexpr ModeKind kModeKind<Isa::ZeroPageY> = ModeKind::ZeroPageY;
+        template <> constexpr ModeKind kModeKind<Isa::Absolute> = ModeKind::Absolute;
+        template <> constexpr ModeKind kModeKind<Isa::AbsoluteX> = ModeKind::AbsoluteX;
+        template <> constexpr ModeKind kModeKind<Isa::AbsoluteY> = ModeKind::AbsoluteY;
+        template <> constexpr ModeKind kModeKind<Isa::IndirectIndexed> = ModeKind::IndirectIndexed;
+        template <> constexpr ModeKind kModeKind<Isa::ZeroPageIndirect> = ModeKind::ZeroPageIndirect;
+        template <> constexpr ModeKind kModeKind<Isa::Relative> = ModeKind::Relative;
+
+        struct Native
+        {
+            NativeOp op;
+            ModeKind mode;
+            uint8_t cycles;     ///< Table cycles plus the opcode fetch
+            bool penalty;       ///< +1 cycle on an indexed page cross
+        };
+
+#define CPU6502_JIT_NATIVE_ENTRY(opcode, op, mode, cycles) \
+        Native{kNativeOp<Isa::op>, kModeKind<Isa::mode>, 1 + (cycles), Isa::op::kPagePenalty},
+        constexpr std::array<Native, 256> kNative = {{CPU6502_OPCODE_TABLE(CPU6502_JIT_NATIVE_ENTRY)}};
+#undef CPU6502_JIT_NATIVE_ENTRY
+
+        [[nodiscard]] constexpr bool readsMemory(const ModeKind mode)
+        {
+            return mode >= ModeKind::ZeroPage && mode <= ModeKind::ZeroPageIndirect;
+        }
+
+        /// Whether @p n compiles to inline code (the rest are step calls).
+        [[nodiscard]] constexpr bool isNative(const Native &n)
+        {
+#ifdef CPU6502_PACKED_FLAGS
+            // Inline bodies write the LazyFlags fields directly.
+            (void)n;
+            return false;
+#else
+            switch (n.op.kind)
+            {
+                case Kind::Load:
+                case Kind::Logic:
+                case Kind::Adc:
+                case Kind::Sbc:
+                case Kind::Compare:
+                    return n.mode == ModeKind::Immediate || readsMemory(n.mode);
+                case Kind::Store:
+                    return readsMemory(n.mode);
+                case Kind::IncDec:
+                    return n.mode == ModeKind::Accumulator || n.mode == ModeKind::ZeroPage ||
+                           n.mode == ModeKind::Absolute;
+                case Kind::Count:
+                case Kind::Transfer:
+                case Kind::Flag:
+                case Kind::Nop:
+                case Kind::Rts:
+                    return n.mode == ModeKind::Implied;
+                case Kind::Branch:
+                case Kind::Bra:
+                    return n.mode == ModeKind::Relative;
+                case Kind::Jmp:
+                case Kind::Jsr:
+                    return n.mode == ModeKind::Absolute;
+                case Kind::Step:
+                    return false;
+            }
+            return false;
+#endif
+        }
+
+        // -------------------------------------------------------------------
+        // A small x86-64 assembler: just the encodings the translator uses.
+        // -------------------------------------------------------------------
+
+        enum Reg : uint8_t
+        {
+            kRax, kRcx, kRdx, kRbx, kRsp, kRbp, kRsi, kRdi,
+            kR8, kR9, kR10, kR11, kR12, kR13, kR14, kR15,
+        };
+        constexpr uint8_t kNoIndex = 0xFF;
+
+        /// [base + index << scale + disp]
+        struct Address
+        {
+            uint8_t base;
+            int32_t disp = 0;
+            uint8_t index = kNoIndex;
+            uint8_t scale = 0;
+        };
+
+        enum Cond : uint8_t
+        {
+            kOverflow = 0x0, kBelow = 0x2, kAboveEqual = 0x3, kEqual = 0x4, kNotEqual = 0x5, kAbove = 0x7,
+            kSign = 0x8, kNotSign = 0x9,
+        };
+
+        class Assembler
+        {
+        public:
+            using Label = size_t;
+
+            [[nodiscard]] const std::vector<uint8_t> &code() const { return code_; }
+
+            Label label()
+            {
+                labels_.push_back(kUnbound);
+                return labels_.size() - 1;
+            }
+            void bind(const Label l) { labels_[l] = code_.size(); }
+
+            /// Patch every jump; all labels must be bound.
+            void finish()
+            {
+                for (const auto &[at, l] : fixups_)
+                {
+                    const int32_t rel = static_cast<int32_t>(labels_[l] - (at + 4));
+                    std::memcpy(code_.data() + at, &rel, sizeof(rel));
+                }
+            }
+
+            void byte(const uint8_t b) { code_.push_back(b); }
+            void bytes(const std::initializer_list<uint8_t> list) { code_.insert(code_.end(), list); }
+            void imm16(const uint16_t v) { bytes({static_cast<uint8_t>(v), static_cast<uint8_t>(v >> 8)}); }
+            void imm32(const uint32_t v)
+            {
+                for (int i = 0; i < 4; ++i)
+                {
+                    byte(static_cast<uint8_t>(v >> (8 * i)));
+                }
+            }
+            void imm64(const uint64_t v)
+            {
+                imm32(static_cast<uint32_t>(v));
+                imm32(static_cast<uint32_t>(v >> 32));
+            }
+
+            /// opcode with a ModRM memory operand; @p reg is the register or
+            /// the /digit extension. A 0x66 prefix may lead @p opcode as long
+            /// as no REX byte is needed (context fields, based on rbx).
+            void mem(const bool wide, const std::initializer_list<uint8_t> opcode, const uint8_t reg, const Address &m)
+            {
+                rex(wide, reg, m.index, m.base);
+                bytes(opcode);
+                const uint8_t base = m.base & 7;
+                const uint8_t mod = (m.disp == 0 && base != 5) ? 0 : (m.disp >= -128 && m.disp <= 127) ? 1 : 2;
+                if (m.index == kNoIndex && base != 4)
+                {
+                    byte(static_cast<uint8_t>(mod << 6 | (reg & 7) << 3 | base));
+                }
+                else
+                {
+                    const uint8_t index = m.index == kNoIndex ? 4 : (m.index & 7);
+                    byte(static_cast<uint8_t>(mod << 6 | (reg & 7) << 3 | 4));
+                    byte(static_cast<uint8_t>(m.scale << 6 | index << 3 | base));
+                }
+                if (mod == 1)
+                {
+                    byte(static_cast<uint8_t>(m.disp));
+                }
+                else if (mod == 2)
+                {
+                    imm32(static_cast<uint32_t>(m.disp));
+                }
+            }
+
+            /// opcode with a ModRM register operand @p rm.
+            void reg(const bool wide, const std::initializer_list<uint8_t> opcode, const uint8_t reg, const uint8_t rm)
+            {
+                rex(wide, reg, kNoIndex, rm);
+                bytes(opcode);
+                byte(static_cast<uint8_t>(0xC0 | (reg & 7) << 3 | (rm & 7)));
+            }
+
+            void movImm32(const uint8_t r, const uint32_t v)
+            {
+                rex(false, 0, kNoIndex, r);
+                byte(static_cast<uint8_t>(0xB8 | (r & 7)));
+                imm32(v);
+            }
+            void movImm64(const uint8_t r, const uint64_t v)
+            {
+                rex(true, 0, kNoIndex, r);
+                byte(static_cast<uint8_t>(0xB8 | (r & 7)));
+                imm64(v);
+            }
+            void push(const uint8_t r)
+            {
+                rex(false, 0, kNoIndex, r);
+                byte(static_cast<uint8_t>(0x50 | (r & 7)));
+            }
+            void pop(const uint8_t r)
+            {
+                rex(false, 0, kNoIndex, r);
+                byte(static_cast<uint8_t>(0x58 | (r & 7)));
+            }
+            void call(const void *target)
+            {
+                movImm64(kRax, reinterpret_cast<uint64_t>(target));
+                bytes({0xFF, 0xD0});                            // call rax
+            }
+            void jmp(const Label l)
+            {
+                byte(0xE9);
+                rel32(l);
+            }
+            void jcc(const Cond cc, const Label l)
+            {
+                bytes({0x0F, static_cast<uint8_t>(0x80 | cc)});
+                rel32(l);
+            }
+
+        private:
+            static constexpr size_t kUnbound = ~size_t{0};
+
+            void rex(const bool wide, const uint8_t reg, const uint8_t index, const uint8_t base)
+            {
+                const uint8_t rex = 0x40 | (wide ? 8 : 0) | (reg & 8 ? 4 : 0) |
+                                    (index != kNoIndex && (index & 8) ? 2 : 0) | (base & 8 ? 1 : 0);
+                if (rex != 0x40)
+                {
+                    byte(rex);
+                }
+            }
+            void rel32(const Label l)
+            {
+                fixups_.emplace_back(code_.size(), l);
+                imm32(0);
+            }
+
+            std::vector<uint8_t> code_;
+            std::vector<size_t> labels_;
+            std::vector<std::pair<size_t, Label>> fixups_;
+        };
+
+        // Translations test the attention latch with a plain byte compare.
+        static_assert(sizeof(std::atomic<bool>) == 1 && std::atomic<bool>::is_always_lock_free);
+
+        // Pinned host registers while a translation runs (all callee-saved,
+        // so they survive the step and slow-path calls).
+        constexpr uint8_t kCtx = kRbx;          ///< Isa::DecodedContext *
+        constexpr uint8_t kAttention = kRbp;    ///< const std::atomic<bool> *
+        constexpr uint8_t kCycles = kR12;       ///< ctx.cycles, written back at exits and calls
+        constexpr uint8_t kEnd = kR13;          ///< frame->end
+        constexpr uint8_t kFrame = kR14;        ///< JitFrame *
+        constexpr uint8_t kMem = kR15;          ///< const Memory *
+
+        /**
+         * Emits one block. Native instructions keep the cycle count in a
+         * register and the 6502 registers in the context; after each one the
+         * code applies the replay loop's stop conditions and leaves through an
+         * exit stub that stores the PC the interpreter would have.
+         */
+        class Translator
+        {
+        public:
+            Translator(const BlockCache::Block &block, const BlockJit::Layout &layout)
+                : block_(block), layout_(layout), epilogue_(a_.label())
+            {
+            }
+
+            std::vector<uint8_t> run()
+            {
+                prologue();
+                uint16_t pc = block_.pc;
+                bool open = true;
+                for (uint8_t i = 0; i < block_.count; ++i)
+                {
+                    const BlockCache::Instruction &insn = block_.instructions[i];
+                    const auto next = static_cast<uint16_t>(pc + insn.length);
+                    const Native &n = kNative[insn.opcode];
+                    const Assembler::Label resume = a_.label();
+                    if (isNative(n))
+                    {
+                        open = instruction(insn, n, pc, next, resume);
+                    }
+                    else
+                    {
+                        stepCall(insn, pc);
+                        open = i + 1 < block_.count;
+                        if (!open)
+                        {
+                            a_.jmp(epilogue_);
+                        }
+                    }
+                    a_.bind(resume);
+                    pc = next;
+                }
+                if (open)
+                {
+                    a_.jmp(exitTo(pc));
+                }
+
+                for (const auto &stub : cold_)
+                {
+                    stub();
+                }
+                for (const auto &[target, l] : exits_)
+                {
+                    a_.bind(l);
+                    a_.mem(false, {0x66, 0xC7}, 0, ctx(layout_.pc));   // mov word [PC], target
+                    a_.imm16(target);
+                    a_.jmp(epilogue_);
+                }
+                epilogue();
+                a_.finish();
+                return a_.code();
+            }
+
+        private:
+            // --- Frame -------------------------------------------------------
+
+            void prologue()
+            {
+                for (const uint8_t r : {kRbx, kRbp, kR12, kR13, kR14, kR15})
+                {
+                    a_.push(r);
+                }
+                a_.bytes({0x48, 0x83, 0xEC, 0x08});                     // sub rsp, 8 (realign)
+                a_.reg(true, {0x89}, kRdi, kFrame);                      // mov r14, rdi
+                a_.mem(true, {0x8B}, kCtx, {kFrame, static_cast<int32_t>(offsetof(JitFrame, ctx))});
+                a_.mem(true, {0x8B}, kMem, {kFrame, static_cast<int32_t>(offsetof(JitFrame, mem))});
+                a_.mem(true, {0x8B}, kEnd, {kFrame, static_cast<int32_t>(offsetof(JitFrame, end))});
+                a_.mem(true, {0x8B}, kAttention, {kFrame, static_cast<int32_t>(offsetof(JitFrame, attention))});
+                a_.mem(true, {0x8B}, kCycles, {kCtx, layout_.cycles});
+            }
+
+            void epilogue()
+            {
+                a_.bind(epilogue_);
+                a_.mem(true, {0x89}, kCycles, {kCtx, layout_.cycles});
+                a_.bytes({0x48, 0x83, 0xC4, 0x08});                     // add rsp, 8
+                for (const uint8_t r : {kR15, kR14, kR13, kR12, kRbp, kRbx})
+                {
+                    a_.pop(r);
+                }
+                a_.byte(0xC3);                                           // ret
+            }
+
+            Assembler::Label exitTo(const uint16_t pc)
+            {
+                const auto found = exits_.find(pc);
+                if (found != exits_.end())
+                {
+                    return found->second;
+                }
+                return exits_.emplace(pc, a_.label()).first->second;
+            }
+
+            [[nodiscard]] int32_t field(const Field f) const
+            {
+                switch (f)
+                {
+                    case Field::A: return layout_.a;
+                    case Field::X: return layout_.x;
+                    case Field::Y: return layout_.y;
+                    case Field::SP: return layout_.sp;
+                    case Field::None: break;
+                }
+                return layout_.a;
+            }
+            [[nodiscard]] Address ctx(const int32_t offset) const { return {kCtx, offset}; }
+            [[nodiscard]] Address mem(const int32_t offset) const { return {kMem, offset}; }
+
+            // --- Interpreter fallback ----------------------------------------
+
+            /// Run @p insn through its step; leave when it says stop.
+            void stepCall(const BlockCache::Instruction &insn, const uint16_t pc)
+            {
+                a_.mem(true, {0x89}, kCycles, ctx(layout_.cycles));
+                a_.mem(false, {0x66, 0xC7}, 0, ctx(layout_.pc));         // mov word [PC], pc
+                a_.imm16(pc);
+                a_.reg(true, {0x89}, kFrame, kRdi);                      // mov rdi, r14
+                a_.movImm64(kRsi, reinterpret_cast<uint64_t>(&insn));
+                a_.call(reinterpret_cast<const void *>(kSteps[insn.opcode]));
+                a_.mem(true, {0x8B}, kCycles, ctx(layout_.cycles));
+                a_.bytes({0x84, 0xC0});                                  // test al, al
+                a_.jcc(kEqual, epilogue_);
+            }
+
+            // --- Bus access ---------------------------------------------------
+
+            /// Out-of-line call to @p helper with esi = @p arg (already set up
+            /// by @p setup), then back to @p resume.
+            void slowCall(const Assembler::Label slow, const Assembler::Label resume, const void *helper,
+                          std::function<void()> setup, const bool result)
+            {
+                cold_.emplace_back([this, slow, resume, helper, setup = std::move(setup), result]()
+                {
+                    a_.bind(slow);
+                    a_.reg(true, {0x89}, kFrame, kRdi);                  // mov rdi, r14
+                    setup();
+                    a_.call(helper);
+                    if (result)
+                    {
+                        a_.reg(false, {0x0F, 0xB6}, kRax, kRax);         // movzx eax, al
+                    }
+                    a_.jmp(resume);
+                });
+            }
+
+            /// eax = byte at the constant @p address.
+            void readConstant(const uint16_t address)
+            {
+                const Assembler::Label slow = a_.label();
+                const Assembler::Label resume = a_.label();
+                a_.mem(true, {0x8B}, kRax, mem(layout_.read_pages + (address >> 8) * 8));
+                a_.reg(true, {0x85}, kRax, kRax);                        // test rax, rax
+                a_.jcc(kEqual, slow);
+                a_.mem(false, {0x0F, 0xB6}, kRax, {kRax, address & 0xFF});
+                a_.bind(resume);
+                slowCall(slow, resume, reinterpret_cast<const void *>(&slowRead),
+                         [this, address]() { a_.movImm32(kRsi, address); }, true);
+            }
+
+            /// eax = byte at the address in ecx (rcx, rdx, rsi, rdi clobbered).
+            void readDynamic()
+            {
+                const Assembler::Label slow = a_.label();
+                const Assembler::Label resume = a_.label();
+                a_.reg(false, {0x89}, kRcx, kRdx);                       // mov edx, ecx
+                a_.reg(false, {0xC1}, 5, kRdx);                          // shr edx, 8
+                a_.byte(8);
+                a_.mem(true, {0x8B}, kRax, {kMem, layout_.read_pages, kRdx, 3});
+                a_.reg(true, {0x85}, kRax, kRax);
+                a_.jcc(kEqual, slow);
+                a_.reg(false, {0x0F, 0xB6}, kRdx, kRcx);                 // movzx edx, cl
+                a_.mem(false, {0x0F, 0xB6}, kRax, {kRax, 0, kRdx, 0});
+                a_.bind(resume);
+                slowCall(slow, resume, reinterpret_cast<const void *>(&slowRead),
+                         [this]() { a_.reg(false, {0x89}, kRcx, kRsi); }, true);
+            }
+
+            /// Store dl at the constant @p address, as Memory::write() does.
+            void writeConstant(const uint16_t address)
+            {
+                const Assembler::Label slow = a_.label();
+                const Assembler::Label done = a_.label();
+                const int32_t page = address >> 8;
+                const Address cell{kRax, address & 0xFF};
+                a_.mem(true, {0x8B}, kRax, mem(layout_.write_pages + page * 8));
+                a_.reg(true, {0x85}, kRax, kRax);
+                a_.jcc(kEqual, slow);
+                a_.mem(false, {0x38}, kRdx, cell);                       // cmp [cell], dl
+                a_.jcc(kEqual, done);
+                a_.mem(false, {0x88}, kRdx, cell);                       // mov [cell], dl
+                a_.mem(false, {0xFF}, 0, mem(layout_.page_generation + page * 4));   // inc dword
+                a_.mem(true, {0xFF}, 0, mem(layout_.side_effects));                  // inc qword
+                a_.bind(done);
+                slowCall(slow, done, reinterpret_cast<const void *>(&slowWrite),
+                         [this, address]() { a_.movImm32(kRsi, address); }, false);
+            }
+
+            /// Store dl at the address in ecx.
+            void writeDynamic()
+            {
+                const Assembler::Label slow = a_.label();
+                const Assembler::Label done = a_.label();
+                const Address cell{kRax, 0, kRdi, 0};
+                a_.reg(false, {0x89}, kRcx, kRsi);                       // mov esi, ecx
+                a_.reg(false, {0xC1}, 5, kRsi);                          // shr esi, 8
+                a_.byte(8);
+                a_.mem(true, {0x8B}, kRax, {kMem, layout_.write_pages, kRsi, 3});
+                a_.reg(true, {0x85}, kRax, kRax);
+                a_.jcc(kEqual, slow);
+                a_.reg(false, {0x0F, 0xB6}, kRdi, kRcx);                 // movzx edi, cl
+                a_.mem(false, {0x38}, kRdx, cell);
+                a_.jcc(kEqual, done);
+                a_.mem(false, {0x88}, kRdx, cell);
+                a_.mem(false, {0xFF}, 0, {kMem, layout_.page_generation, kRsi, 2});
+                a_.mem(true, {0xFF}, 0, mem(layout_.side_effects));
+                a_.bind(done);
+                slowCall(slow, done, reinterpret_cast<const void *>(&slowWrite),
+                         [this]() { a_.reg(false, {0x89}, kRcx, kRsi); }, false);
+            }
+
+            /// ecx = the little-endian pointer at zero-page @p zp (wrapping).
+            void zeroPagePointer(const uint8_t zp)
+            {
+                const Assembler::Label slow = a_.label();
+                const Assembler::Label resume = a_.label();
+                a_.mem(true, {0x8B}, kRax, mem(layout_.read_pages));
+                a_.reg(true, {0x85}, kRax, kRax);
+                a_.jcc(kEqual, slow);
+                a_.mem(false, {0x0F, 0xB6}, kRcx, {kRax, zp});
+                a_.mem(false, {0x0F, 0xB6}, kRdx, {kRax, static_cast<uint8_t>(zp + 1)});
+                a_.reg(false, {0xC1}, 4, kRdx);                          // shl edx, 8
+                a_.byte(8);
+                a_.reg(false, {0x09}, kRdx, kRcx);                       // or ecx, edx
+                a_.bind(resume);
+                cold_.emplace_back([this, slow, resume, zp]()
+                {
+                    a_.bind(slow);
+                    a_.reg(true, {0x89}, kFrame, kRdi);
+                    a_.movImm32(kRsi, zp);
+                    a_.call(reinterpret_cast<const void *>(&slowPointer));
+                    a_.reg(false, {0x89}, kRax, kRcx);                   // mov ecx, eax
+                    a_.jmp(resume);
+                });
+            }
+
+            /// Add the page-cross cycle after a compare that clears CF exactly
+            /// when indexing leaves the page.
+            void penaltyFromCarry()
+            {
+                a_.byte(0xF5);                                           // cmc
+                a_.reg(true, {0x83}, 2, kCycles);                        // adc r12, 0
+                a_.byte(0);
+            }
+
+            /// Effective address of a memory operand. Returns true with ecx
+            /// set for computed addresses, false with @p address for constant
+            /// ones.
+            bool effectiveAddress(const Native &n, const BlockCache::Instruction &insn, uint16_t &address)
+            {
+                const uint8_t zp = insn.operands[0];
+                const auto absolute = static_cast<uint16_t>(insn.operands[0] | insn.operands[1] << 8);
+                switch (n.mode)
+                {
+                    case ModeKind::ZeroPage:
+                        address = zp;
+                        return false;
+                    case ModeKind::Absolute:
+                        address = absolute;
+                        return false;
+                    case ModeKind::ZeroPageX:
+                    case ModeKind::ZeroPageY:
+                        a_.mem(false, {0x0F, 0xB6}, kRcx,
+                               ctx(n.mode == ModeKind::ZeroPageX ? layout_.x : layout_.y));
+                        a_.reg(false, {0x81}, 0, kRcx);                  // add ecx, zp
+                        a_.imm32(zp);
+                        a_.reg(false, {0x0F, 0xB6}, kRcx, kRcx);         // movzx ecx, cl
+                        return true;
+                    case ModeKind::AbsoluteX:
+                    case ModeKind::AbsoluteY:
+                        a_.mem(false, {0x0F, 0xB6}, kRcx,
+                               ctx(n.mode == ModeKind::AbsoluteX ? layout_.x : layout_.y));
+                        if (n.penalty)
+                        {
+                            a_.reg(false, {0x81}, 7, kRcx);              // cmp ecx, 0x100 - low
+                            a_.imm32(0x100u - (absolute & 0xFF));
+                            penaltyFromCarry();
+                        }
+                        a_.reg(false, {0x81}, 0, kRcx);                  // add ecx, absolute
+                        a_.imm32(absolute);
+                        a_.reg(false, {0x0F, 0xB7}, kRcx, kRcx);         // movzx ecx, cx
+                        return true;
+                    case ModeKind::IndirectIndexed:
+                        zeroPagePointer(zp);
+                        a_.mem(false, {0x0F, 0xB6}, kRdx, ctx(layout_.y));
+                        if (n.penalty)
+                        {
+                            a_.reg(false, {0x0F, 0xB6}, kRsi, kRcx);     // movzx esi, cl
+                            a_.reg(false, {0x01}, kRdx, kRsi);           // add esi, edx
+                            a_.reg(false, {0x81}, 7, kRsi);              // cmp esi, 0x100
+                            a_.imm32(0x100);
+                            penaltyFromCarry();
+                        }
+                        a_.reg(false, {0x01}, kRdx, kRcx);               // add ecx, edx
+                        a_.reg(false, {0x0F, 0xB7}, kRcx, kRcx);
+                        return true;
+                    case ModeKind::ZeroPageIndirect:
+                        zeroPagePointer(zp);
+                        return true;
+                    default:
+                        address = 0;
+                        return false;
+                }
+            }
+
+            /// eax = the operand of a read instruction.
+            void loadOperand(const Native &n, const BlockCache::Instruction &insn)
+            {
+                if (n.mode == ModeKind::Immediate)
+                {
+                    a_.movImm32(kRax, insn.operands[0]);
+                    return;
+                }
+                uint16_t address = 0;
+                if (effectiveAddress(n, insn, address))
+                {
+                    readDynamic();
+                }
+                else
+                {
+                    readConstant(address);
+                }
+            }
+
+            /// N and Z from the byte register @p r (al, cl or dl).
+            void setNZ(const uint8_t r)
+            {
+                a_.mem(false, {0x88}, r, ctx(layout_.n_source));
+                a_.mem(false, {0x88}, r, ctx(layout_.z_source));
+            }
+
+            // --- Instructions --------------------------------------------------
+
+            /// What the replay loop checks after a record that keeps going.
+            void checkpoint(const uint16_t next, const unsigned cycles, const bool memory, const bool store)
+            {
+                a_.reg(true, {0x81}, 0, kCycles);                        // add r12, cycles
+                a_.imm32(cycles);
+                a_.reg(true, {0x39}, kEnd, kCycles);                     // cmp r12, r13
+                a_.jcc(kAboveEqual, exitTo(next));
+                if (memory)
+                {
+                    a_.mem(false, {0x80}, 7, {kAttention});              // cmp byte [rbp], 0
+                    a_.byte(0);
+                    a_.jcc(kNotEqual, exitTo(next));
+                }
+                if (store && !block_.rom)
+                {
+                    a_.mem(false, {0x81}, 7, mem(layout_.page_generation + (block_.pc >> 8) * 4));
+                    a_.imm32(block_.generation);
+                    a_.jcc(kNotEqual, exitTo(next));
+                }
+                if (store && block_.windowed)
+                {
+                    a_.mem(false, {0x80}, 7, mem(layout_.current_bank));
+                    a_.byte(block_.bank);
+                    a_.jcc(kNotEqual, exitTo(next));
+                }
+            }
+
+            /// Push dl onto the 6502 stack.
+            void push()
+            {
+                a_.mem(false, {0x0F, 0xB6}, kRcx, ctx(layout_.sp));
+                a_.reg(false, {0x81}, 1, kRcx);                          // or ecx, 0x100
+                a_.imm32(0x100);
+                writeDynamic();
+                a_.mem(false, {0xFE}, 1, ctx(layout_.sp));               // dec byte [SP]
+            }
+
+            /// al = byte pulled from the 6502 stack.
+            void pull()
+            {
+                a_.mem(false, {0xFE}, 0, ctx(layout_.sp));               // inc byte [SP]
+                a_.mem(false, {0x0F, 0xB6}, kRcx, ctx(layout_.sp));
+                a_.reg(false, {0x81}, 1, kRcx);
+                a_.imm32(0x100);
+                readDynamic();
+            }
+
+            /// Emit @p insn inline. Returns whether execution can fall
+            /// through to the next record.
+            bool instruction(const BlockCache::Instruction &insn, const Native &n, const uint16_t pc,
+                             const uint16_t next, const Assembler::Label resume)
+            {
+                const NativeOp &op = n.op;
+                const bool memory = readsMemory(n.mode);
+                switch (op.kind)
+                {
+                    case Kind::Load:
+                        loadOperand(n, insn);
+                        a_.mem(false, {0x88}, kRax, ctx(field(op.reg)));
+                        setNZ(kRax);
+                        checkpoint(next, n.cycles, memory, false);
+                        return true;
+
+                    case Kind::Store:
+                    {
+                        uint16_t address = 0;
+                        const bool dynamic = effectiveAddress(n, insn, address);
+                        if (op.reg == Field::None)
+                        {
+                            a_.reg(false, {0x31}, kRdx, kRdx);           // xor edx, edx
+                        }
+                        else
+                        {
+                            a_.mem(false, {0x0F, 0xB6}, kRdx, ctx(field(op.reg)));
+                        }
+                        if (dynamic)
+                        {
+                            writeDynamic();
+                        }
+                        else
+                        {
+                            writeConstant(address);
+                        }
+                        checkpoint(next, n.cycles, true, true);
+                        return true;
+                    }
+
+                    case Kind::Logic:
+                        loadOperand(n, insn);
+                        a_.mem(false, {op.alu}, kRax, ctx(layout_.a));   // op al, [A]
+                        a_.mem(false, {0x88}, kRax, ctx(layout_.a));
+                        setNZ(kRax);
+                        checkpoint(next, n.cycles, memory, false);
+                        return true;
+
+                    case Kind::Adc:
+                    case Kind::Sbc:
+                    {
+                        // Decimal mode goes through the interpreter's BCD code.
+                        const Assembler::Label decimal = a_.label();
+                        a_.mem(false, {0xF6}, 0, ctx(layout_.p));        // test byte [P], D
+                        a_.byte(CPU6502::kDecimal);
+                        a_.jcc(kNotEqual, decimal);
+                        cold_.emplace_back([this, decimal, resume, &insn, pc]()
+                        {
+                            a_.bind(decimal);
+                            stepCall(insn, pc);
+                            a_.jmp(resume);
+                        });
+
+                        loadOperand(n, insn);
+                        a_.mem(false, {0x0F, 0xB6}, kRcx, ctx(layout_.a));
+                        a_.mem(false, {0x8A}, kRdx, ctx(layout_.carry)); // mov dl, [C]
+                        if (op.kind == Kind::Adc)
+                        {
+                            a_.reg(false, {0x80}, 0, kRdx);              // add dl, 0xFF: CF = C
+                            a_.byte(0xFF);
+                            a_.reg(false, {0x10}, kRax, kRcx);           // adc cl, al
+                            a_.mem(false, {0x0F, 0x92}, 0, ctx(layout_.carry));       // setc
+                        }
+                        else
+                        {
+                            a_.reg(false, {0x80}, 7, kRdx);              // cmp dl, 1: CF = !C
+                            a_.byte(1);
+                            a_.reg(false, {0x18}, kRax, kRcx);           // sbb cl, al
+                            a_.mem(false, {0x0F, 0x93}, 0, ctx(layout_.carry));       // setnc
+                        }
+                        a_.mem(false, {0x0F, 0x90}, 0, ctx(layout_.overflow));        // seto
+                        a_.mem(false, {0x88}, kRcx, ctx(layout_.a));
+                        setNZ(kRcx);
+                        checkpoint(next, n.cycles, memory, false);
+                        return true;
+                    }
+
+                    case Kind::Compare:
+                        loadOperand(n, insn);
+                        a_.mem(false, {0x8A}, kRdx, ctx(field(op.reg)));
+                        a_.reg(false, {0x38}, kRax, kRdx);               // cmp dl, al
+                        a_.mem(false, {0x0F, 0x93}, 0, ctx(layout_.carry));           // setae
+                        a_.reg(false, {0x28}, kRax, kRdx);               // sub dl, al
+                        setNZ(kRdx);
+                        checkpoint(next, n.cycles, memory, false);
+                        return true;
+
+                    case Kind::IncDec:
+                    {
+                        const uint8_t ext = op.delta > 0 ? 0 : 1;        // inc / dec
+                        if (n.mode == ModeKind::Accumulator)
+                        {
+                            a_.mem(false, {0xFE}, ext, ctx(layout_.a));
+                            a_.mem(false, {0x8A}, kRdx, ctx(layout_.a));
+                            setNZ(kRdx);
+                            checkpoint(next, n.cycles, false, false);
+                            return true;
+                        }
+                        uint16_t address = 0;
+                        effectiveAddress(n, insn, address);
+                        readConstant(address);
+                        a_.reg(false, {0xFE}, ext, kRax);
+                        a_.reg(false, {0x89}, kRax, kRdx);               // mov edx, eax
+                        setNZ(kRdx);
+                        writeConstant(address);
+                        checkpoint(next, n.cycles, true, true);
+                        return true;
+                    }
+
+                    case Kind::Count:
+                        a_.mem(false, {0xFE}, op.delta > 0 ? 0 : 1, ctx(field(op.reg)));
+                        a_.mem(false, {0x8A}, kRdx, ctx(field(op.reg)));
+                        setNZ(kRdx);
+                        checkpoint(next, n.cycles, false, false);
+                        return true;
+
+                    case Kind::Transfer:
+                        a_.mem(false, {0x8A}, kRdx, ctx(field(op.reg)));
+                        a_.mem(false, {0x88}, kRdx, ctx(field(op.dest)));
+                        if (op.dest != Field::SP)
+                        {
+                            setNZ(kRdx);
+                        }
+                        checkpoint(next, n.cycles, false, false);
+                        return true;
+
+                    case Kind::Flag:
+                        if (op.flag == CPU6502::kCarry || op.flag == CPU6502::kOverflow)
+                        {
+                            a_.mem(false, {0xC6}, 0,
+                                   ctx(op.flag == CPU6502::kCarry ? layout_.carry : layout_.overflow));
+                            a_.byte(op.set ? 1 : 0);
+                        }
+                        else
+                        {
+                            a_.mem(false, {0x80}, op.set ? 1 : 4, ctx(layout_.p));    // or / and
+                            a_.byte(static_cast<uint8_t>(op.set ? op.flag : ~op.flag));
+                        }
+                        checkpoint(next, n.cycles, false, false);
+                        return true;
+
+                    case Kind::Nop:
+                        checkpoint(next, n.cycles, false, false);
+                        return true;
+
+                    case Kind::Branch:
+                    {
+                        const uint16_t target = Isa::branchTarget(next, insn.operands[0]);
+                        const Assembler::Label taken = a_.label();
+                        branchTest(op, taken);
+                        checkpoint(next, n.cycles, false, false);
+                        const unsigned taken_cycles = n.cycles + 1 + (Isa::pageCrossed(next, target) ? 1 : 0);
+                        cold_.emplace_back([this, taken, taken_cycles, target]()
+                        {
+                            a_.bind(taken);
+                            a_.reg(true, {0x81}, 0, kCycles);
+                            a_.imm32(taken_cycles);
+                            a_.jmp(exitTo(target));
+                        });
+                        return true;
+                    }
+
+                    case Kind::Bra:
+                    {
+                        const uint16_t target = Isa::branchTarget(next, insn.operands[0]);
+                        a_.reg(true, {0x81}, 0, kCycles);
+                        a_.imm32(n.cycles + (Isa::pageCrossed(next, target) ? 1 : 0));
+                        a_.jmp(exitTo(target));
+                        return false;
+                    }
+
+                    case Kind::Jmp:
+                        a_.reg(true, {0x81}, 0, kCycles);
+                        a_.imm32(n.cycles);
+                        a_.jmp(exitTo(static_cast<uint16_t>(insn.operands[0] | insn.operands[1] << 8)));
+                        return false;
+
+                    case Kind::Jsr:
+                    {
+                        // Pushes the address of its own last byte.
+                        const auto last = static_cast<uint16_t>(next - 1);
+                        a_.movImm32(kRdx, last >> 8);
+                        push();
+                        a_.movImm32(kRdx, last & 0xFF);
+                        push();
+                        a_.reg(true, {0x81}, 0, kCycles);
+                        a_.imm32(n.cycles);
+                        a_.jmp(exitTo(static_cast<uint16_t>(insn.operands[0] | insn.operands[1] << 8)));
+                        return false;
+                    }
+
+                    case Kind::Rts:
+                        pull();
+                        a_.mem(false, {0x88}, kRax, ctx(layout_.pc));
+                        pull();
+                        a_.mem(false, {0x88}, kRax, ctx(layout_.pc + 1));
+                        a_.mem(false, {0x66, 0xFF}, 0, ctx(layout_.pc));  // inc word [PC]
+                        a_.reg(true, {0x81}, 0, kCycles);
+                        a_.imm32(n.cycles);
+                        a_.jmp(epilogue_);
+                        return false;
+
+                    case Kind::Step:
+                        break;
+                }
+                return true;
+            }
+
+            /// Jump to @p taken when the branch condition of @p op holds.
+            void branchTest(const NativeOp &op, const Assembler::Label taken)
+            {
+                switch (op.flag)
+                {
+                    case CPU6502::kNegative:
+                        a_.mem(false, {0x80}, 7, ctx(layout_.n_source));  // cmp byte [N], 0
+                        a_.byte(0);
+                        a_.jcc(op.set ? kSign : kNotSign, taken);
+                        break;
+                    case CPU6502::kZero:
+                        a_.mem(false, {0x80}, 7, ctx(layout_.z_source));
+                        a_.byte(0);
+                        a_.jcc(op.set ? kEqual : kNotEqual, taken);
+                        break;
+                    default:
+                        a_.mem(false, {0x80}, 7,
+                               ctx(op.flag == CPU6502::kCarry ? layout_.carry : layout_.overflow));
+                        a_.byte(0);
+                        a_.jcc(op.set ? kNotEqual : kEqual, taken);
+                        break;
+                }
+            }
+
+            const BlockCache::Block &block_;
+            const BlockJit::Layout &layout_;
+            Assembler a_;
+            Assembler::Label epilogue_;
+            std::map<uint16_t, Assembler::Label> exits_;
+            std::vector<std::function<void()>> cold_;
+        };
+
+        template <class T, class U>
+        int32_t offsetIn(const T *base, const U *member)
+        {
+            return static_cast<int32_t>(reinterpret_cast<const char *>(member) - reinterpret_cast<const char *>(base));
+        }
+    } // namespace
+
+    BlockJit::BlockJit()
+    {
+        void *arena = mmap(nullptr, kArenaSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        arena_ = arena == MAP_FAILED ? nullptr : static_cast<uint8_t *>(arena);
+        if (arena_)
+        {
+            mprotect(arena_, kArenaSize, PROT_READ | PROT_EXEC);
+        }
+    }
+
+    BlockJit::~BlockJit()
+    {
+        if (arena_)
+        {
+            munmap(arena_, kArenaSize);
+        }
+    }
+
+    BlockJit::Layout BlockJit::layoutOf(const JitFrame &frame)
+    {
+        const Isa::DecodedContext &ctx = *frame.ctx;
+        const Memory &mem = *frame.mem;
+        Layout layout;
+        layout.a = offsetIn(&ctx, &ctx.reg.A);
+        layout.x = offsetIn(&ctx, &ctx.reg.X);
+        layout.y = offsetIn(&ctx, &ctx.reg.Y);
+        layout.sp = offsetIn(&ctx, &ctx.reg.SP);
+        layout.p = offsetIn(&ctx, &ctx.reg.P);
+        layout.pc = offsetIn(&ctx, &ctx.reg.PC);
+        layout.cycles = offsetIn(&ctx, &ctx.cycles);
+#ifndef CPU6502_PACKED_FLAGS
+        layout.n_source = offsetIn(&ctx, &ctx.flags.n_source);
+        layout.z_source = offsetIn(&ctx, &ctx.flags.z_source);
+        layout.carry = offsetIn(&ctx, &ctx.flags.carry);
+        layout.overflow = offsetIn(&ctx, &ctx.flags.overflow);
+#endif
+        layout.read_pages = offsetIn(&mem, mem.read_pages_.data());
+        layout.write_pages = offsetIn(&mem, mem.write_pages_.data());
+        layout.page_generation = offsetIn(&mem, mem.page_generation_.data());
+        layout.side_effects = offsetIn(&mem, &mem.side_effects_);
+        layout.current_bank = offsetIn(&mem, &mem.current_bank_);
+        return layout;
+    }
+
+    BlockCache::NativeCode BlockJit::translate(const BlockCache::Block &block, const JitFrame &frame)
+    {
+        if (!arena_)
+        {
+            return nullptr;
+        }
+        if (!layout_)
+        {
+            layout_ = layoutOf(frame);
+        }
+
+        const std::vector<uint8_t> code = Translator(block, *layout_).run();
+        if (used_ + code.size() > kArenaSize)
+        {
+            return nullptr;
+        }
+        mprotect(arena_, kArenaSize, PROT_READ | PROT_WRITE);
+        uint8_t *const entry = arena_ + used_;
+        std::memcpy(entry, code.data(), code.size());
+        used_ += code.size();
+        mprotect(arena_, kArenaSize, PROT_READ | PROT_EXEC);
+        ++translation_count_;
+        return reinterpret_cast<BlockCache::NativeCode>(entry);
+    }
+
+    void BlockJit::reset()
+    {
+        used_ = 0;
+    }
+} // namespace Computer
+
+#endif // CPU6502_JIT
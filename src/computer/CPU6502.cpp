@@ -1,11 +1,110 @@
 #include "CPU6502.h"
 
+#include <array>
+#include <iomanip>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "CPU6502Instructions.h"
+#include "RomTranslation.h"
+
 namespace Computer {
 
+namespace {
+
+using Handler = void (*)(Isa::StepContext &);
+
+// One fully specialized body per opcode, generated from the opcode table.
+#define CPU6502_DISPATCH_ENTRY(opcode, op, mode, cycles) &Isa::execute<Isa::op, Isa::mode, cycles, Isa::StepContext>,
+constexpr std::array<Handler, 256> kDispatch = {{CPU6502_OPCODE_TABLE(CPU6502_DISPATCH_ENTRY)}};
+#undef CPU6502_DISPATCH_ENTRY
+
+#ifndef CPU6502_NO_FUSION
+// Upper bound on the cycles of any fused idiom, page-cross and taken-branch
+// cycles included. A fused step only runs when this much budget is left, so
+// the budget check between its parts could never have ended the batch.
+constexpr uint64_t kFusedCycleBound = 32;
+
+// What a fused step checks between its parts.
+struct FusedRun
+{
+    const Memory &mem;
+    const BlockCache::Block &block;
+    const std::atomic<bool> &attention;
+};
+
+// Parts that only touch registers cannot raise attention or modify the block.
+template <uint8_t Opcode>
+constexpr bool kRegisterOnly = std::is_same_v<typename Isa::OpcodeEntry<Opcode>::AddressingMode, Isa::Implied> ||
+                               std::is_same_v<typename Isa::OpcodeEntry<Opcode>::AddressingMode, Isa::Immediate>;
+
+// Replay the records of an idiom back to back, stopping after a part where
+// the one-record replay would have stopped. Branches only ever come last.
+template <uint8_t Opcode, uint8_t... Rest>
+inline bool replayFused(Isa::DecodedContext &ctx, const FusedRun &run, const BlockCache::Instruction *insn)
+{
+    ctx.operands = insn->operands.data();
+    ctx.reg.PC++;
+    ctx.cycles++;
+    Isa::executeOpcode<Opcode>(ctx);
+    if constexpr (sizeof...(Rest) == 0)
+    {
+        return true;
+    }
+    else
+    {
+        if constexpr (!kRegisterOnly<Opcode>)
+        {
+            if (run.attention.load(std::memory_order_relaxed) || !run.block.isCurrent(run.mem))
+            {
+                return false;
+            }
+        }
+        return replayFused<Rest...>(ctx, run, insn + 1);
+    }
+}
+
+// Run the idiom tagged on insn; false if it stopped part-way.
+bool runFused(Isa::DecodedContext &ctx, const FusedRun &run, const BlockCache::Instruction *insn)
+{
+    using Fusion = BlockCache::Fusion;
+    switch (insn->fusion)
+    {
+    case Fusion::CountdownBranch:
+        return insn->opcode == 0xCA ? replayFused<0xCA, 0xD0>(ctx, run, insn)
+                                    : replayFused<0x88, 0xD0>(ctx, run, insn);
+    case Fusion::CompareBranch:
+        return insn[1].opcode == 0xF0 ? replayFused<0xC9, 0xF0>(ctx, run, insn)
+                                      : replayFused<0xC9, 0xD0>(ctx, run, insn);
+    case Fusion::IncrementBranch:
+        return replayFused<0xE6, 0xD0>(ctx, run, insn);
+    case Fusion::SectorCopy:
+        return replayFused<0xAD, 0x91, 0xC8, 0xD0>(ctx, run, insn);
+    case Fusion::LoadStore:
+        switch ((insn[0].opcode << 8) | insn[1].opcode)
+        {
+#define CPU6502_LOAD_STORE_CASE(load, store) \
+        case (load << 8) | store: return replayFused<load, store>(ctx, run, insn);
+            CPU6502_FUSED_LOAD_STORE(CPU6502_LOAD_STORE_CASE)
+#undef CPU6502_LOAD_STORE_CASE
+        }
+        break;
+    case Fusion::None:
+        break;
+    }
+    return false;  // not reached: BlockCache only tags the idioms above
+}
+#endif // CPU6502_NO_FUSION
+
+} // namespace
+
 CPU6502::CPU6502(Memory &memory) : mem_(memory), cycles_(0)
 {
     reset();
+#ifdef CPU6502_MAP_DISPATCH
     initializeInstructionHandlers();
+#endif
 }
 
 void CPU6502::reset()
@@ -19,6 +118,17 @@ void CPU6502::reset()
     // Load reset vector from $FFFC/$FFFD
     reg.PC = mem_.readWord(0xFFFC);
     cycles_ = 0;
+    wake(true);
+}
+
+void CPU6502::copyStateFrom(const CPU6502 &other)
+{
+    reg = other.reg;
+    cycles_ = other.cycles_;
+    idle_cycles_ = other.idle_cycles_;
+    nmi_pending_.store(other.nmi_pending_.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    irq_line_.store(other.irq_line_.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    run_state_.store(other.runState(), std::memory_order_release);
 }
 
 void CPU6502::setFlag(const StatusFlags flag, const bool value)
@@ -46,6 +156,10 @@ void CPU6502::updateZeroNegativeFlags(const uint8_t value)
 uint8_t CPU6502::readByte()
 {
     cycles_++;
+    if (const uint8_t *code = mem_.codePage(reg.PC >> 8))
+    {
+        return code[reg.PC++ & 0xFF];
+    }
     return mem_.read(reg.PC++);
 }
 
@@ -73,2316 +187,423 @@ uint8_t CPU6502::pullByte()
 
 void CPU6502::requestNmi()
 {
-    nmi_pending_ = true;
+    nmi_pending_.store(true, std::memory_order_relaxed);
+    attention_.store(true, std::memory_order_relaxed);
+    wake(false);
 }
 
 void CPU6502::setIrqLine(const bool asserted)
 {
-    irq_line_ = asserted;
-}
-
-void CPU6502::serviceInterrupt(const uint16_t vector)
-{
-    // Hardware interrupt sequence: push PC, push status with B clear (bit 4),
-    // set I, clear D (65C02 behavior), then vector through the handler address.
-    pushStack16(reg.PC);
-    pushByte((reg.P & ~kBreak) | kUnused);
-    setFlag(kInterrupt, true);
-    setFlag(kDecimal, false);
-    reg.PC = mem_.readWord(vector);
-    cycles_ += 7;
+    if (irq_line_.exchange(asserted, std::memory_order_relaxed) != asserted)
+    {
+        attention_.store(true, std::memory_order_relaxed);
+    }
+    if (asserted)
+    {
+        wake(false);
+    }
 }
 
-bool CPU6502::executeSingleInstruction()
+void CPU6502::halt(const Isa::Halt request)
 {
-    // Service pending hardware interrupts between instructions: NMI is
-    // non-maskable; IRQ only when the I flag is clear. Each counts as one step.
-    if (nmi_pending_)
+    std::lock_guard lock(wake_mutex_);
+    if (request == Isa::Halt::Stop)
     {
-        nmi_pending_ = false;
-        serviceInterrupt(0xFFFA);
-        return true;
+        run_state_.store(RunState::Stopped, std::memory_order_release);
     }
-    if (irq_line_ && !getFlag(kInterrupt))
+    else if (!nmi_pending_.load(std::memory_order_relaxed) && !irq_line_.load(std::memory_order_relaxed))
     {
-        serviceInterrupt(0xFFFE);
-        return true;
+        run_state_.store(RunState::Waiting, std::memory_order_release);
     }
+}
 
-    const uint8_t opcode = readByte();
-
-    const auto it = handlers_.find(opcode);
-    if (it != handlers_.end()) {
-        it->second();
-        return true;
-    } else {
-        // Unknown opcode encountered
-        return false;
+void CPU6502::wake(const bool from_stop)
+{
+    {
+        std::lock_guard lock(wake_mutex_);
+        const RunState state = run_state_.load(std::memory_order_relaxed);
+        if (state == RunState::Running || (state == RunState::Stopped && !from_stop))
+        {
+            return;
+        }
+        run_state_.store(RunState::Running, std::memory_order_release);
     }
+    wake_.notify_all();
 }
 
-void CPU6502::printStatus() const
+bool CPU6502::waitWhileHalted(const std::chrono::microseconds timeout)
 {
-    // Status updates are now handled by the UI framework
-    // The MainWindow's updateCpuStatusSidebar() method reads CPU registers directly
+    std::unique_lock lock(wake_mutex_);
+    return wake_.wait_for(lock, timeout, [this] { return !isHalted(); });
 }
 
-uint64_t CPU6502::getCycles() const
+void CPU6502::raiseAttention()
 {
-    return cycles_;
+    attention_.store(true, std::memory_order_relaxed);
 }
 
-uint8_t CPU6502::getCurrentByte() const
+bool CPU6502::executeSingleInstruction()
 {
-    return mem_.read(reg.PC);
+    if (mem_.hasWatches())
+    {
+        return executeWatched();
+    }
+    return executeInstruction();
 }
 
-// Addressing calculation functions
-std::pair<uint16_t, bool> CPU6502::calculateAddress(const bool use_one_byte, const uint8_t offset)
+bool CPU6502::executeWatched()
 {
-    uint16_t address = 0;
-    bool page_crossed = false;
+    const uint16_t pc = reg.PC;
+    const uint64_t cycles = cycles_;
+    const bool executes = !isHalted() && !nmi_pending_.load(std::memory_order_relaxed) &&
+                          !(irq_line_.load(std::memory_order_relaxed) && !getFlag(kInterrupt));
 
-    if (use_one_byte)
-    {
-        // Zero page addressing
-        address = (mem_.read(reg.PC) + offset) & 0xFF;
-    } else
+    // Host accesses since the last instruction are not the guest's.
+    std::vector<WatchAccess> &log = mem_.watchLog();
+    log.clear();
+    const uint8_t *const page = mem_.codePage(pc >> 8);
+    const uint8_t opcode = page ? page[pc & 0xFF] : 0x00;
+    if (executes && mem_.isExecuteWatched(pc))
     {
-        // Absolute addressing
-        const uint16_t base_address = mem_.readWord(reg.PC);
-        address = base_address + offset;
+        reportWatch({kWatchExecute, pc, pc, opcode, cycles});
+    }
 
-        // Check for page boundary crossing
-        if (offset != 0)
+    const bool ok = executeInstruction();
+
+    // Reads of the instruction's own bytes are fetches, not data reads.
+    const uint8_t length = executes ? Isa::kInstructionLength[opcode] : 0;
+    // Taken out first: the handler may change the watches.
+    const std::vector<WatchAccess> accesses = std::exchange(log, {});
+    for (const WatchAccess &access : accesses)
+    {
+        const bool fetch = access.kind == kWatchRead && static_cast<uint16_t>(access.address - pc) < length;
+        if (!fetch)
         {
-            page_crossed = checkPageBoundaryCrossed(base_address, address);
+            reportWatch({access.kind, pc, access.address, access.value, cycles});
         }
-
-        // Validate address
-        validateAddress(address);
     }
-
-    return std::make_pair(address, page_crossed);
+    return ok;
 }
 
-uint16_t CPU6502::calculateAddressSimple(const bool use_one_byte, const uint8_t offset)
+void CPU6502::reportWatch(const WatchHit &hit)
 {
-    // Wrapper for backward compatibility - returns just the address
-    auto [address, page_crossed] = calculateAddress(use_one_byte, offset);
-    return address;
-}
-
-std::pair<uint16_t, bool> CPU6502::calculateRelativeAddress(const uint8_t offset)
-{
-    // Calculate the new PC after the branch
-    const uint16_t current_pc = reg.PC; // PC already points to instruction after branch
-
-    // Convert signed offset (if > 127, it's negative)
-    const int8_t signed_offset = (offset < 0x80) ? offset : offset - 0x100;
-
-    // Calculate target address
-    uint16_t target_pc = current_pc + signed_offset;
-
-    // Check if we crossed a page boundary
-    bool page_crossed = checkPageBoundaryCrossed(current_pc, target_pc);
-
-    return std::make_pair(target_pc, page_crossed);
+    attention_.store(true, std::memory_order_relaxed);
+    if (watch_handler_)
+    {
+        watch_handler_(hit);
+    }
 }
 
-std::pair<uint16_t, uint8_t> CPU6502::calculateIndexedAddress(const uint8_t offset)
+uint64_t CPU6502::runWatched(const uint64_t budget)
 {
-    // This is for indexed indirect addressing (zp,X)
-    // No additional cycles for page boundary crossing in this mode
-    uint8_t addcycle = 0;
-
-    // Get the zero page address from PC and add offset
-    const uint8_t zp_addr = mem_.read(reg.PC);
-    const uint8_t zp_final = (zp_addr + offset) & 0xFF;
-
-    // Read the 16-bit address from (zp+X) and (zp+X+1)
-    uint16_t address = mem_.read(zp_final) | (mem_.read((zp_final + 1) & 0xFF) << 8);
-
-    // Validate address
-    validateAddress(address);
-
-    return std::make_pair(address, addcycle);
+    const uint64_t start = cycles_;
+    attention_.store(false, std::memory_order_relaxed);
+    idle_ = false;
+    while (cycles_ - start < budget && !attention_.load(std::memory_order_relaxed))
+    {
+        if (isHalted())
+        {
+            idle_cycles_ += budget - (cycles_ - start);
+            cycles_ = start + budget;
+            idle_ = true;
+            break;
+        }
+        if (!executeWatched())
+        {
+            break;
+        }
+    }
+    return cycles_ - start;
 }
 
-std::pair<uint16_t, uint8_t> CPU6502::calculateIndirectAddress(const uint8_t offset)
+bool CPU6502::executeInstruction()
 {
-    // This holds any additional cycle timing due to page boundary crossing
-    uint8_t addcycle = 0;
-
-    // Get the zero page address from PC
-    const uint8_t zp_addr = mem_.read(reg.PC) & 0xFF;
+    Isa::StepContext ctx{{mem_, reg, cycles_}};
 
-    // Read the 16-bit base address from (zp) and (zp+1)
-    const uint16_t base_address = mem_.read(zp_addr) | (mem_.read((zp_addr + 1) & 0xFF) << 8);
-
-    // Calculate final address by adding offset
-    uint16_t address = base_address + offset;
-
-    // Check if we crossed a page boundary
-    if (checkPageBoundaryCrossed(base_address, address))
+    if (isHalted())
     {
-        addcycle = 1;
+        cycles_++;  // the clock runs on; nothing executes
+        return true;
     }
 
-    // Validate address
-    validateAddress(address);
-
-    return std::make_pair(address, addcycle);
-}
+    // Service pending hardware interrupts between instructions: NMI is
+    // non-maskable; IRQ only when the I flag is clear. Each counts as one step.
+    if (nmi_pending_.load(std::memory_order_relaxed) && nmi_pending_.exchange(false, std::memory_order_relaxed))
+    {
+        Isa::interrupt(ctx, 0xFFFA);
+        return true;
+    }
+    if (irq_line_.load(std::memory_order_relaxed) && !getFlag(kInterrupt))
+    {
+        Isa::interrupt(ctx, 0xFFFE);
+        return true;
+    }
 
-bool CPU6502::checkPageBoundaryCrossed(const uint16_t base_addr, const uint16_t final_addr)
-{
-    // Check if addresses are on different pages (different high bytes)
-    return (base_addr & 0xFF00) != (final_addr & 0xFF00);
-}
+    // Fetch from the page's backing bytes unless PC is in a device page.
+    const uint8_t *const page = mem_.codePage(reg.PC >> 8);
+    const uint8_t offset = reg.PC & 0xFF;
+    const uint8_t opcode = page ? page[offset] : mem_.read(reg.PC);
+    reg.PC++;
+    cycles_++;
+    if (page && offset + Isa::kInstructionLength[opcode] <= 0x100)
+    {
+        ctx.code = page + offset + 1;
+    }
 
-bool CPU6502::validateAddress(const uint16_t address)
-{
-    if (address > 0xFFFF)
+#ifdef CPU6502_MAP_DISPATCH
+    const auto it = handlers_.find(opcode);
+    if (it == handlers_.end())
     {
-        // Invalid address accessed
+        // Unknown opcode encountered
         return false;
     }
+    it->second(ctx);
+#else
+    kDispatch[opcode](ctx);
+#endif
+    if (ctx.halt != Isa::Halt::None)
+    {
+        halt(ctx.halt);
+    }
     return true;
 }
 
-uint16_t CPU6502::calculateZeroPageIndirectAddress()
-{
-    // 65C02 (zp) mode: a single zero-page operand byte names a pointer held at
-    // zp and zp+1 (the +1 wraps within zero page). The operand is NOT consumed
-    // here; the caller's base handler advances PC past it (pc_offset = 1).
-    const uint8_t zp_addr = mem_.read(reg.PC);
-    const uint16_t target_addr =
-        mem_.read(zp_addr) | (mem_.read((zp_addr + 1) & 0xFF) << 8);
-
-    validateAddress(target_addr);
-    return target_addr;
-}
-
-uint16_t CPU6502::calculateAbsoluteIndexedIndirectAddress()
+uint64_t CPU6502::runCycles(const uint64_t budget)
 {
-    // Read 16-bit absolute address from instruction stream
-    const uint16_t base_addr = readWord();
-
-    // Add X register to base address (no page boundary check needed for 65C02)
-    const uint16_t indexed_addr = (base_addr + reg.X) & 0xFFFF;
-
-    // Read the actual target address from the indexed address
-    const uint16_t target_addr = mem_.readWord(indexed_addr);
-
-    validateAddress(target_addr);
-    return target_addr;
-}
+    if (mem_.hasWatches())
+    {
+        return runWatched(budget);
+    }
 
-// ALU helper functions
-uint8_t CPU6502::addValues(const uint8_t val1, const uint8_t val2)
-{
-    const int carry_in = getFlag(kCarry) ? 1 : 0;
+    Isa::DecodedContext ctx{{mem_, reg, cycles_}};
+    ctx.setStatus(reg.P);  // status flags may be held unpacked for the batch
+    const uint64_t start = ctx.cycles;
+    const uint64_t end = start + budget;
+    attention_.store(false, std::memory_order_relaxed);
+    idle_ = false;
+    idle_probe_.side_effects = ~uint64_t{0};  // the host may have changed device state
 
-    if (getFlag(kDecimal))
+    while (ctx.cycles < end)
     {
-        // 65C02 BCD add — a faithful port of the documented hardware algorithm
-        // (http://www.6502.org/tutorials/decimal_mode.html, appendix B), so the
-        // result/flags match a real W65C02S even for invalid BCD inputs
-        // (validated against the Klaus2m5/amb5l decimal test, cputype=65C02).
-        // N and Z are set from the final result by the caller; C and V here.
-        bool carry = carry_in != 0;
-        int t = (val1 & 0x0F) + (val2 & 0x0F) + (carry ? 1 : 0);
-        uint8_t a = static_cast<uint8_t>(t);
-        int x = 0;
-        if (a >= 0x0A)                       // low nibble decimal-adjusts
+        // WAI and STP end their block, so a halt is seen here, before the
+        // next instruction.
+        if (ctx.halt != Isa::Halt::None)
         {
-            x = 1;
-            a = static_cast<uint8_t>(a + 5 + 1) & 0x0F;   // adc #5 (compare set carry)
-            carry = true;                                  // sec
+            halt(ctx.halt);
+            ctx.halt = Isa::Halt::None;
         }
-        else
+        if (isHalted())
         {
-            carry = false;
+            // Nothing runs until an interrupt or reset wakes the CPU; the
+            // clock still does.
+            idle_cycles_ += end - ctx.cycles;
+            ctx.cycles = end;
+            idle_ = true;
+            break;
         }
-        a |= (val1 & 0xF0);
-        const uint8_t hi_operand = x ? ((val2 & 0xF0) | 0x0F) : (val2 & 0xF0);
-        const uint8_t a_before = a;
-        t = a + hi_operand + (carry ? 1 : 0);
-        a = static_cast<uint8_t>(t);
-        carry = t > 0xFF;
-
-        // V is the overflow of this high-nibble add, before the +$60 adjust.
-        setFlag(kOverflow, ((~(a_before ^ hi_operand) & (a_before ^ a)) & 0x80) != 0);
 
-        if (carry || a >= 0xA0)              // high nibble decimal-adjusts (+$60)
+        // Load before the (locked) exchange: this runs at every block boundary.
+        if (nmi_pending_.load(std::memory_order_relaxed) && nmi_pending_.exchange(false, std::memory_order_relaxed))
         {
-            a = static_cast<uint8_t>(a + 0x5F + 1);
-            carry = true;
+            Isa::interrupt(ctx, 0xFFFA);
         }
-        setFlag(kCarry, carry);
-        return a;
-    }
-
-    // Binary mode: A + M + C.
-    // V is set when both operands have the same sign but the result's sign
-    // differs (signed overflow): ~(val1^val2) & (val1^result) & $80.
-    const uint16_t result = val1 + val2 + carry_in;
-    const uint8_t res8 = result & 0xFF;
-    setFlag(kCarry, (result > 0xFF));
-    setFlag(kOverflow, ((~(val1 ^ val2) & (val1 ^ res8)) & 0x80) != 0);
-    return res8;
-}
-
-uint8_t CPU6502::subtractValues(const uint8_t val1, const uint8_t val2)
-{
-    const int carry_in = getFlag(kCarry) ? 1 : 0;
-
-    // Carry and overflow derive from the binary subtraction in BOTH decimal and
-    // binary modes (this matches real 6502/65C02 SBC behaviour). Carry is set
-    // when there is no borrow; V on signed overflow:
-    // (val1^val2) & (val1^result) & $80.
-    const int bin = val1 - val2 - (1 - carry_in);
-    const uint8_t res8 = static_cast<uint8_t>(bin);
-    setFlag(kCarry, bin >= 0);
-    setFlag(kOverflow, (((val1 ^ val2) & (val1 ^ res8)) & 0x80) != 0);
-
-    if (getFlag(kDecimal))
-    {
-        // 65C02 BCD subtract — faithful port of the documented hardware
-        // algorithm (matches a real W65C02S for invalid BCD too). On the 65C02,
-        // SBC takes V and C from the binary subtraction above; only the
-        // accumulator result is decimal-adjusted here (N and Z come from it).
-        bool dcarry = carry_in != 0;
-        int t = (val1 & 0x0F) - (val2 & 0x0F) - (dcarry ? 0 : 1);
-        uint8_t a = static_cast<uint8_t>(t);
-        int x = 0;
-        if (t < 0)                           // low nibble borrowed
+        else if (irq_line_.load(std::memory_order_relaxed) && !ctx.flag(kInterrupt))
         {
-            x = 1;
-            a &= 0x0F;
-            dcarry = false;                  // clc
+            Isa::interrupt(ctx, 0xFFFE);
         }
         else
         {
-            dcarry = true;
+            // Idle loop: back at the probe's PC with the same registers and
+            // flags and no side effect in between, so every further pass is
+            // identical until something outside the CPU changes. Skip whole
+            // passes up to the end of the batch.
+            const uint64_t side_effects = mem_.sideEffectCount();
+            IdleProbe &probe = idle_probe_;
+            if (side_effects != probe.side_effects || ctx.cycles - probe.cycles > kIdleWindow)
+            {
+                probe = {ctx.cycles, side_effects, ctx.reg.PC, ctx.reg.A, ctx.reg.X, ctx.reg.Y, ctx.reg.SP};
+            }
+            else if (ctx.reg.PC == probe.pc && ctx.reg.A == probe.a && ctx.reg.X == probe.x &&
+                     ctx.reg.Y == probe.y && ctx.reg.SP == probe.sp && ctx.cycles != probe.cycles)
+            {
+                // Flags are only packed for candidates; the first match
+                // records them and the next pass must match them too.
+                const uint8_t status = ctx.status();
+                uint64_t skipped = 0;
+                if (probe.has_status && status == probe.p)
+                {
+                    const uint64_t period = ctx.cycles - probe.cycles;
+                    skipped = (end - ctx.cycles) / period * period;
+                    ctx.cycles += skipped;
+                    idle_cycles_ += skipped;
+                    idle_ = true;
+                }
+                probe.cycles = ctx.cycles;
+                probe.p = status;
+                probe.has_status = true;
+                if (skipped != 0)
+                {
+                    // Back to the loop test: a skip that lands on the end of
+                    // the batch must not replay another pass past it.
+                    continue;
+                }
+            }
+
+            if (rom_translations_)
+            {
+                // Blocks translated from the ROM images at build time.
+                AotFrame frame{&ctx, &mem_, end, &attention_};
+                if (const TranslatedBlock code = rom_translations_->find(mem_, ctx.reg.PC, frame))
+                {
+                    code(frame);
+                    if (attention_.load(std::memory_order_relaxed))
+                    {
+                        break;
+                    }
+                    continue;
+                }
+            }
+
+            // Replay a predecoded run. It stops early when control leaves the
+            // straight line (taken branch), a store hits the block's own page,
+            // a device asks for attention or the budget is spent.
+            BlockCache::Block &block = blocks_.lookup(mem_, ctx.reg.PC);
+#ifdef CPU6502_JIT
+            JitFrame frame{&ctx, &mem_, &block, end, &attention_};
+            if (!block.native && !block.transient && ++block.executions >= BlockJit::kHotThreshold)
+            {
+                block.native = jit_.translate(block, frame);
+                if (!block.native)
+                {
+                    // Arena full: start over with only the current block.
+                    blocks_.dropTranslations();
+                    jit_.reset();
+                    block.native = jit_.translate(block, frame);
+                }
+            }
+            if (block.native)
+            {
+                block.native(&frame);
+                if (attention_.load(std::memory_order_relaxed))
+                {
+                    break;
+                }
+                continue;
+            }
+#endif
+            for (uint8_t i = 0; i < block.count; ++i)
+            {
+                const BlockCache::Instruction &insn = block.instructions[i];
+#ifndef CPU6502_NO_FUSION
+                if (insn.fusion != BlockCache::Fusion::None)
+                {
+                    FusionStats &stats = fusion_stats_[static_cast<size_t>(insn.fusion)];
+                    if (ctx.cycles + kFusedCycleBound < end)
+                    {
+                        ++stats.fused;
+                        const uint16_t next = static_cast<uint16_t>(ctx.reg.PC + insn.fused_length);
+                        if (!runFused(ctx, FusedRun{mem_, block, attention_}, &insn) ||
+                            ctx.reg.PC != next || attention_.load(std::memory_order_relaxed) || !block.isCurrent(mem_))
+                        {
+                            break;
+                        }
+                        i += BlockCache::kFusionLength[static_cast<size_t>(insn.fusion)] - 1;
+                        continue;
+                    }
+                    ++stats.unfused;
+                }
+#endif
+                const uint16_t next = static_cast<uint16_t>(ctx.reg.PC + insn.length);
+                ctx.operands = insn.operands.data();
+                ctx.reg.PC++;
+                ctx.cycles++;
+
+                // Every opcode body is inlined into this switch, so the
+                // registers stay in locals across the whole batch.
+                switch (insn.opcode)
+                {
+#define CPU6502_SWITCH_CASE(opcode, op, mode, cycles) \
+                case opcode: Isa::execute<Isa::op, Isa::mode, cycles>(ctx); break;
+                    CPU6502_OPCODE_TABLE(CPU6502_SWITCH_CASE)
+#undef CPU6502_SWITCH_CASE
+                }
+
+                if (ctx.reg.PC != next || attention_.load(std::memory_order_relaxed) || ctx.cycles >= end ||
+                    !block.isCurrent(mem_))
+                {
+                    break;
+                }
+            }
         }
-        a |= (val1 & 0xF0);
-        const uint8_t hi_operand = x ? ((val2 & 0xF0) | 0x0F) : (val2 & 0xF0);
-        t = a - hi_operand - (dcarry ? 0 : 1);
-        a = static_cast<uint8_t>(t);
-        dcarry = (t >= 0);
-        if (!dcarry)                         // sbc #$5F  (-$60)
-        {
-            t = a - 0x5F - 1;
-            a = static_cast<uint8_t>(t);
-            dcarry = (t >= 0);
-        }
-        if (x != 0)                          // extra -6 when the low nibble borrowed
+
+        if (attention_.load(std::memory_order_relaxed))
         {
-            // The hardware does `cpx #0` (which always sets carry) before this
-            // SBC, so there is never a borrow-in here.
-            a = static_cast<uint8_t>(a - 6);
+            break;
         }
-        return a;
     }
 
-    return res8;
-}
-
-void CPU6502::compareValues(const uint8_t val1, const uint8_t val2)
-{
-    // CMP/CPX/CPY compute (val1 - val2) and set flags from the result.
-    // N must come from bit 7 of the 8-bit difference, NOT from val1 itself,
-    // otherwise CMP-then-BMI/BPL idioms (e.g. EhBASIC's FP exponent alignment)
-    // branch the wrong way.
-    const uint8_t diff = static_cast<uint8_t>(val1 - val2);
-    setFlag(kCarry, (val1 >= val2));
-    setFlag(kZero, (val1 == val2));
-    setFlag(kNegative, (diff & 0x80) != 0);
-}
-
-// Stack helper functions
-void CPU6502::pushStack16(const uint16_t value)
-{
-    // Push the high byte first (6502 pushes MSB first)
-    pushByte((value >> 8) & 0xFF);
-
-    // Push the low byte second
-    pushByte(value & 0xFF);
-}
-
-uint16_t CPU6502::popStack16()
-{
-    // Pull low byte first (6502 pulls LSB first)
-    const uint8_t low_byte = pullByte();
-
-    // Pull high byte second
-    const uint8_t high_byte = pullByte();
-
-    return (high_byte << 8) | low_byte;
-}
-
-// ADC instruction family handlers
-void CPU6502::handleAdcImmediate()
-{
-    handleAdcBase(reg.PC, 1, 2);
-}
-
-void CPU6502::handleAdcZeroPage()
-{
-    const uint16_t address = calculateAddressSimple(true, 0);
-    handleAdcBase(address, 1, 3);
-}
-
-void CPU6502::handleAdcZeroPageX()
-{
-    const uint16_t address = calculateAddressSimple(true, reg.X);
-    handleAdcBase(address, 1, 4);
-}
-
-void CPU6502::handleAdcAbsolute()
-{
-    const uint16_t address = calculateAddressSimple(false, 0);
-    handleAdcBase(address, 2, 4);
-}
-
-void CPU6502::handleAdcAbsoluteX()
-{
-    auto [address, page_crossed] = calculateAddress(false, reg.X);
-    const uint8_t cycles = 4 + (page_crossed ? 1 : 0);
-    handleAdcBase(address, 2, cycles);
-}
-
-void CPU6502::handleAdcAbsoluteY()
-{
-    auto [address, page_crossed] = calculateAddress(false, reg.Y);
-    const uint8_t cycles = 4 + (page_crossed ? 1 : 0);
-    handleAdcBase(address, 2, cycles);
-}
-
-void CPU6502::handleAdcIndexedIndirect()
-{
-    auto [address, cycle] = calculateIndexedAddress(reg.X);
-    handleAdcBase(address, 1, 6);
-}
-
-void CPU6502::handleAdcIndirectIndexed()
-{
-    auto [address, cycle] = calculateIndirectAddress(reg.Y);
-    const uint8_t cycles = 5 + cycle;
-    handleAdcBase(address, 1, cycles);
-}
-
-void CPU6502::handleAdcBase(const uint16_t address, const uint8_t pc_offset, const uint8_t cycles)
-{
-    const uint8_t val = mem_.read(address);
-    reg.A = addValues(reg.A, val);
-    updateZeroNegativeFlags(reg.A);
-    reg.PC += pc_offset;
-    cycles_ += cycles;
-}
-
-// AND instruction family handlers
-void CPU6502::handleAndImmediate()
-{
-    handleAndBase(reg.PC, 1, 2);
-}
-
-void CPU6502::handleAndZeroPage()
-{
-    const uint16_t address = calculateAddressSimple(true, 0);
-    handleAndBase(address, 1, 3);
-}
-
-void CPU6502::handleAndZeroPageX()
-{
-    const uint16_t address = calculateAddressSimple(true, reg.X);
-    handleAndBase(address, 1, 4);
-}
-
-void CPU6502::handleAndAbsolute()
-{
-    const uint16_t address = calculateAddressSimple(false, 0);
-    handleAndBase(address, 2, 4);
-}
-
-void CPU6502::handleAndAbsoluteX()
-{
-    auto [address, page_crossed] = calculateAddress(false, reg.X);
-    const uint8_t cycles = 4 + (page_crossed ? 1 : 0);
-    handleAndBase(address, 2, cycles);
-}
-
-void CPU6502::handleAndAbsoluteY()
-{
-    auto [address, page_crossed] = calculateAddress(false, reg.Y);
-    const uint8_t cycles = 4 + (page_crossed ? 1 : 0);
-    handleAndBase(address, 2, cycles);
-}
-
-void CPU6502::handleAndIndexedIndirect()
-{
-    auto [address, cycle] = calculateIndexedAddress(reg.X);
-    handleAndBase(address, 1, 6);
-}
-
-void CPU6502::handleAndIndirectIndexed()
-{
-    auto [address, cycle] = calculateIndirectAddress(reg.Y);
-    const uint8_t cycles = 5 + cycle;
-    handleAndBase(address, 1, cycles);
-}
-
-void CPU6502::handleAndBase(const uint16_t address, const uint8_t pc_offset, const uint8_t cycles)
-{
-    const uint8_t val = mem_.read(address);
-    reg.A &= val;
-    updateZeroNegativeFlags(reg.A);
-    reg.PC += pc_offset;
-    cycles_ += cycles;
-}
-
-// ASL instruction family handlers
-void CPU6502::handleAslAccumulator()
-{
-    // Take the high bit of accumulator and set it to Carry flag
-    setFlag(kCarry, (reg.A & 0x80) != 0);
-
-    // Rotate the value to the left << one place. Bit 0 is set to 0
-    reg.A = (reg.A << 1) & 0xFE;
-
-    // Update flags
-    updateZeroNegativeFlags(reg.A);
-
-    // Update cycle counter
-    cycles_ += 2;
-}
-
-void CPU6502::handleAslZeroPage()
-{
-    const uint16_t address = calculateAddressSimple(true, 0);
-    handleAslBase(address, 1, 5);
-}
-
-void CPU6502::handleAslZeroPageX()
-{
-    const uint16_t address = calculateAddressSimple(true, reg.X);
-    handleAslBase(address, 1, 6);
-}
-
-void CPU6502::handleAslAbsolute()
-{
-    const uint16_t address = calculateAddressSimple(false, 0);
-    handleAslBase(address, 2, 6);
-}
-
-void CPU6502::handleAslAbsoluteX()
-{
-    auto [address, page_crossed] = calculateAddress(false, reg.X);
-    handleAslBase(address, 2, 7);
+    if (ctx.halt != Isa::Halt::None)
+    {
+        halt(ctx.halt);  // halted by the batch's last instruction
+    }
+    reg = ctx.reg;
+    reg.P = ctx.status();
+    cycles_ = ctx.cycles;
+    return cycles_ - start;
 }
 
-void CPU6502::handleAslBase(const uint16_t address, const uint8_t pc_offset, const uint8_t cycles)
+const char *CPU6502::dispatchCoreName()
 {
-    uint8_t val = mem_.read(address);
-
-    // Take the high bit of value and set it to Carry flag
-    setFlag(kCarry, (val & 0x80) != 0);
-
-    // Rotate the value to the left << one place. Bit 0 is set to 0
-    val = (val << 1) & 0xFE;
-
-    // Write the value back to memory
-    mem_.write(address, val);
-
-    // Update flags
-    updateZeroNegativeFlags(val);
-
-    // Update program and cycle counters
-    reg.PC += pc_offset;
-    cycles_ += cycles;
+#if defined(CPU6502_MAP_DISPATCH) && defined(CPU6502_JIT)
+    return "map+jit";
+#elif defined(CPU6502_MAP_DISPATCH)
+    return "map";
+#elif defined(CPU6502_JIT)
+    return "table+jit";
+#else
+    return "table";
+#endif
 }
 
-// Branch instruction handlers
-void CPU6502::handleBra()
+void CPU6502::printStatus() const
 {
-    // BRA rel - $80: Branch always
-    const uint8_t offset = readByte();
-    auto [target_pc, page_crossed] = calculateRelativeAddress(offset);
-
-    reg.PC = target_pc;
-    cycles_ += 2 + (page_crossed ? 1 : 0);
+    // Status updates are now handled by the UI framework
+    // The MainWindow's updateCpuStatusSidebar() method reads CPU registers directly
 }
 
-void CPU6502::handleBcc()
+void CPU6502::printFusionReport(std::ostream &out) const
 {
-    // Branch if Carry Clear
-    const uint8_t offset = readByte();
-
-    if (!getFlag(kCarry))
+    for (size_t i = 1; i < BlockCache::kFusionCount; ++i)
     {
-        auto [target_pc, page_crossed] = calculateRelativeAddress(offset);
-        reg.PC = target_pc;
-        cycles_ += 3 + (page_crossed ? 1 : 0);
-    }
-    else
-    {
-        cycles_ += 2;
+        const auto fusion = static_cast<BlockCache::Fusion>(i);
+        const FusionStats &stats = fusion_stats_[i];
+        const uint64_t total = stats.fused + stats.unfused;
+        const double rate = total ? 100.0 * static_cast<double>(stats.fused) / static_cast<double>(total) : 0.0;
+        out << "  " << std::left << std::setw(24) << BlockCache::fusionName(fusion) << std::right
+            << " fused=" << stats.fused << " unfused=" << stats.unfused
+            << " hit=" << std::fixed << std::setprecision(1) << rate << "%"
+            << " records-saved=" << stats.fused * (BlockCache::kFusionLength[i] - 1) << "\n";
     }
 }
 
-void CPU6502::handleBcs()
+uint64_t CPU6502::getCycles() const
 {
-    // Branch if Carry Set
-    const uint8_t offset = readByte();
-
-    if (getFlag(kCarry))
-    {
-        auto [target_pc, page_crossed] = calculateRelativeAddress(offset);
-        reg.PC = target_pc;
-        cycles_ += 3 + (page_crossed ? 1 : 0);
-    }
-    else
-    {
-        cycles_ += 2;
-    }
+    return cycles_;
 }
 
-void CPU6502::handleBeq()
+uint8_t CPU6502::getCurrentByte() const
 {
-    // Branch if Equal (Zero Set)
-    const uint8_t offset = readByte();
-
-    if (getFlag(kZero))
-    {
-        auto [target_pc, page_crossed] = calculateRelativeAddress(offset);
-        reg.PC = target_pc;
-        cycles_ += 3 + (page_crossed ? 1 : 0);
-    }
-    else
-    {
-        cycles_ += 2;
-    }
+    return mem_.read(reg.PC);
 }
 
-void CPU6502::handleBmi()
+#ifdef CPU6502_MAP_DISPATCH
+void CPU6502::initializeInstructionHandlers()
 {
-    // Branch if Minus (Negative Set)
-    const uint8_t offset = readByte();
-
-    if (getFlag(kNegative))
-    {
-        auto [target_pc, page_crossed] = calculateRelativeAddress(offset);
-        reg.PC = target_pc;
-        cycles_ += 3 + (page_crossed ? 1 : 0);
-    }
-    else
-    {
-        cycles_ += 2;
-    }
-}
-
-void CPU6502::handleBne()
-{
-    // Branch if Not Equal (Zero Clear)
-    const uint8_t offset = readByte();
-
-    if (!getFlag(kZero))
-    {
-        auto [target_pc, page_crossed] = calculateRelativeAddress(offset);
-        reg.PC = target_pc;
-        cycles_ += 3 + (page_crossed ? 1 : 0);
-    }
-    else
-    {
-        cycles_ += 2;
-    }
-}
-
-void CPU6502::handleBpl()
-{
-    // Branch if Plus (Negative Clear)
-    const uint8_t offset = readByte();
-
-    if (!getFlag(kNegative))
-    {
-        auto [target_pc, page_crossed] = calculateRelativeAddress(offset);
-        reg.PC = target_pc;
-        cycles_ += 3 + (page_crossed ? 1 : 0);
-    }
-    else
-    {
-        cycles_ += 2;
-    }
-}
-
-void CPU6502::handleBvc()
-{
-    // Branch if Overflow Clear
-    const uint8_t offset = readByte();
-
-    if (!getFlag(kOverflow))
-    {
-        auto [target_pc, page_crossed] = calculateRelativeAddress(offset);
-        reg.PC = target_pc;
-        cycles_ += 3 + (page_crossed ? 1 : 0);
-    }
-    else
-    {
-        cycles_ += 2;
-    }
-}
-
-void CPU6502::handleBvs()
-{
-    // Branch if Overflow Set
-    const uint8_t offset = readByte();
-
-    if (getFlag(kOverflow))
-    {
-        auto [target_pc, page_crossed] = calculateRelativeAddress(offset);
-        reg.PC = target_pc;
-        cycles_ += 3 + (page_crossed ? 1 : 0);
-    }
-    else
-    {
-        cycles_ += 2;
-    }
-}
-
-void CPU6502::handleBrk()
-{
-    // BRK pushes the address of the BRK opcode + 2 (it skips a signature byte).
-    // The opcode fetch already advanced PC by 1, so add 1 more to reach BRK+2.
-    reg.PC += 1;
-
-    // Set break flag (B is set in the status pushed by BRK)
-    setFlag(kBreak, true);
-
-    // Store the pc on the stack
-    pushStack16(reg.PC);
-
-    // Store the processor flags on the stack
-    pushByte(reg.P);
-
-    // Set the interrupt flag; the 65C02 also clears decimal mode on BRK
-    // (the NMOS 6502 does not). Matches serviceInterrupt() for IRQ/NMI.
-    setFlag(kInterrupt, true);
-    setFlag(kDecimal, false);
-
-    // Load the pc with the interrupt vector contents at $FFFE/$FFFF
-    reg.PC = mem_.readWord(0xFFFE);
-
-    // BRK takes 7 cycles
-    cycles_ += 7;
-}
-
-// Flag manipulation instruction handlers
-void CPU6502::handleClc()
-{
-    // Clear Carry flag
-    setFlag(kCarry, false);
-    cycles_ += 2;
-}
-
-void CPU6502::handleCld()
-{
-    // Clear Decimal flag
-    setFlag(kDecimal, false);
-    cycles_ += 2;
-}
-
-void CPU6502::handleCli()
-{
-    // Clear Interrupt flag
-    setFlag(kInterrupt, false);
-    cycles_ += 2;
-}
-
-void CPU6502::handleClv()
-{
-    // Clear Overflow flag
-    setFlag(kOverflow, false);
-    cycles_ += 2;
-}
-
-void CPU6502::handleSec()
-{
-    // Set Carry flag
-    setFlag(kCarry, true);
-    cycles_ += 2;
-}
-
-void CPU6502::handleSed()
-{
-    // Set Decimal flag
-    setFlag(kDecimal, true);
-    cycles_ += 2;
-}
-
-void CPU6502::handleSei()
-{
-    // Set Interrupt flag
-    setFlag(kInterrupt, true);
-    cycles_ += 2;
-}
-
-// Stack instruction handlers
-void CPU6502::handlePha()
-{
-    // Push Accumulator onto stack
-    pushByte(reg.A);
-    cycles_ += 2;
-}
-
-void CPU6502::handlePhp()
-{
-    // Push Processor status onto stack
-    pushByte(reg.P | kBreak | kUnused); // Break and unused flags are set when pushed
-    cycles_ += 2;
-}
-
-void CPU6502::handlePla()
-{
-    // Pull Accumulator from stack
-    reg.A = pullByte();
-    updateZeroNegativeFlags(reg.A);
-    cycles_ += 3;
-}
-
-void CPU6502::handlePlp()
-{
-    // Pull Processor status from stack
-    reg.P = pullByte() & ~(kBreak | kUnused); // Clear break and unused flags when pulled
-    reg.P |= kUnused; // Unused flag is always set
-    cycles_ += 3;
-}
-
-void CPU6502::handlePhx()
-{
-    // Push X Register onto stack
-    pushByte(reg.X);
-    cycles_ += 3;
-}
-
-void CPU6502::handlePlx()
-{
-    // Pull X Register from stack
-    reg.X = pullByte();
-    updateZeroNegativeFlags(reg.X);
-    cycles_ += 4;
-}
-
-void CPU6502::handlePhy()
-{
-    // Push Y Register onto stack
-    pushByte(reg.Y);
-    cycles_ += 3;
-}
-
-void CPU6502::handlePly()
-{
-    // Pull Y Register from stack
-    reg.Y = pullByte();
-    updateZeroNegativeFlags(reg.Y);
-    cycles_ += 4;
-}
-
-// Transfer instruction handlers
-void CPU6502::handleTax()
-{
-    // Transfer Accumulator to X
-    reg.X = reg.A;
-    updateZeroNegativeFlags(reg.X);
-    cycles_ += 2;
-}
-
-void CPU6502::handleTay()
-{
-    // Transfer Accumulator to Y
-    reg.Y = reg.A;
-    updateZeroNegativeFlags(reg.Y);
-    cycles_ += 2;
-}
-
-void CPU6502::handleTsx()
-{
-    // Transfer Stack Pointer to X
-    reg.X = reg.SP;
-    updateZeroNegativeFlags(reg.X);
-    cycles_ += 2;
-}
-
-void CPU6502::handleTxa()
-{
-    // Transfer X to Accumulator
-    reg.A = reg.X;
-    updateZeroNegativeFlags(reg.A);
-    cycles_ += 2;
-}
-
-void CPU6502::handleTxs()
-{
-    // Transfer X to Stack Pointer (no flags affected)
-    reg.SP = reg.X;
-    cycles_ += 2;
-}
-
-void CPU6502::handleTya()
-{
-    // Transfer Y to Accumulator
-    reg.A = reg.Y;
-    updateZeroNegativeFlags(reg.A);
-    cycles_ += 2;
-}
-
-void CPU6502::handleNop()
-{
-    cycles_ += 2;
-}
-
-// LDA instruction family handlers
-void CPU6502::handleLdaImmediate()
-{
-    handleLdaBase(reg.PC, 1, 2);
-}
-
-void CPU6502::handleLdaZeroPage()
-{
-    const uint16_t address = calculateAddressSimple(true, 0);
-    handleLdaBase(address, 1, 3);
-}
-
-void CPU6502::handleLdaZeroPageX()
-{
-    const uint16_t address = calculateAddressSimple(true, reg.X);
-    handleLdaBase(address, 1, 4);
-}
-
-void CPU6502::handleLdaAbsolute()
-{
-    const uint16_t address = calculateAddressSimple(false, 0);
-    handleLdaBase(address, 2, 4);
-}
-
-void CPU6502::handleLdaAbsoluteX()
-{
-    auto [address, page_crossed] = calculateAddress(false, reg.X);
-    const uint8_t cycles = 4 + (page_crossed ? 1 : 0);
-    handleLdaBase(address, 2, cycles);
-}
-
-void CPU6502::handleLdaAbsoluteY()
-{
-    auto [address, page_crossed] = calculateAddress(false, reg.Y);
-    const uint8_t cycles = 4 + (page_crossed ? 1 : 0);
-    handleLdaBase(address, 2, cycles);
-}
-
-void CPU6502::handleLdaIndexedIndirect()
-{
-    auto [address, cycle] = calculateIndexedAddress(reg.X);
-    handleLdaBase(address, 1, 6);
-}
-
-void CPU6502::handleLdaIndirectIndexed()
-{
-    auto [address, cycle] = calculateIndirectAddress(reg.Y);
-    const uint8_t cycles = 5 + cycle;
-    handleLdaBase(address, 1, cycles);
-}
-
-void CPU6502::handleLdaBase(const uint16_t address, const uint8_t pc_offset, const uint8_t cycles)
-{
-    const uint8_t val = mem_.read(address);
-    reg.A = val;
-    updateZeroNegativeFlags(reg.A);
-    reg.PC += pc_offset;
-    cycles_ += cycles;
-}
-
-// JMP instruction handlers
-void CPU6502::handleJmpAbsolute()
-{
-    handleJmpBase(readWord(), 3);
-}
-
-void CPU6502::handleJmpIndirect()
-{
-    // 65C02 reads the pointer linearly (no NMOS $xxFF page-wrap bug) in 6 cycles.
-    const uint16_t indirect_addr = readWord();
-    const uint16_t target_addr = mem_.readWord(indirect_addr);
-    handleJmpBase(target_addr, 6);
-}
-
-void CPU6502::handleJmpBase(const uint16_t address, const uint8_t cycles)
-{
-    reg.PC = address;
-    cycles_ += cycles;
-}
-
-// STA instruction family handlers
-void CPU6502::handleStaZeroPage()
-{
-    const uint16_t address = calculateAddressSimple(true, 0);
-    handleStaBase(address, 1, 3);
-}
-
-void CPU6502::handleStaZeroPageX()
-{
-    const uint16_t address = calculateAddressSimple(true, reg.X);
-    handleStaBase(address, 1, 4);
-}
-
-void CPU6502::handleStaAbsolute()
-{
-    const uint16_t address = calculateAddressSimple(false, 0);
-    handleStaBase(address, 2, 4);
-}
-
-void CPU6502::handleStaAbsoluteX()
-{
-    auto [address, page_crossed] = calculateAddress(false, reg.X);
-    handleStaBase(address, 2, 5); // STA always takes extra cycle for indexed addressing
-}
-
-void CPU6502::handleStaAbsoluteY()
-{
-    auto [address, page_crossed] = calculateAddress(false, reg.Y);
-    handleStaBase(address, 2, 5); // STA always takes extra cycle for indexed addressing
-}
-
-void CPU6502::handleStaIndexedIndirect()
-{
-    auto [address, cycle] = calculateIndexedAddress(reg.X);
-    handleStaBase(address, 1, 6);
-}
-
-void CPU6502::handleStaIndirectIndexed()
-{
-    auto [address, cycle] = calculateIndirectAddress(reg.Y);
-    handleStaBase(address, 1, 6); // STA always takes 6 cycles for this mode
-}
-
-void CPU6502::handleStaBase(const uint16_t address, const uint8_t pc_offset, const uint8_t cycles)
-{
-    mem_.write(address, reg.A);
-    reg.PC += pc_offset;
-    cycles_ += cycles;
-}
-
-// JSR instruction handler
-void CPU6502::handleJsr()
-{
-    // Calculate return address before reading target (PC currently points to low byte of target)
-    const uint16_t return_address = reg.PC + 1; // Address of last byte of JSR instruction
-
-    // Read target address (this advances PC by 2)
-    const uint16_t target_address = readWord();
-
-    // Push return address onto stack (6502 pushes PC+2 from start of JSR)
-    pushStack16(return_address);
-
-    // Jump to target address
-    reg.PC = target_address;
-    cycles_ += 6;
-}
-
-// RTS instruction handler
-void CPU6502::handleRts()
-{
-    // Pull return address from stack
-    const uint16_t return_address = popStack16();
-
-    // Set PC to return address + 1
-    reg.PC = return_address + 1;
-    cycles_ += 6;
-}
-
-// RTI instruction handler
-void CPU6502::handleRti()
-{
-    // Pull processor status from stack
-    reg.P = pullByte() & ~(kBreak | kUnused); // Clear break and unused flags when pulled
-    reg.P |= kUnused; // Unused flag is always set
-
-    // Pull return address from stack
-    reg.PC = popStack16();
-
-    cycles_ += 6;
-}
-
-// LDX instruction family handlers
-void CPU6502::handleLdxImmediate()
-{
-    handleLdxBase(reg.PC, 1, 2);
-}
-
-void CPU6502::handleLdxZeroPage()
-{
-    const uint16_t address = calculateAddressSimple(true, 0);
-    handleLdxBase(address, 1, 3);
-}
-
-void CPU6502::handleLdxZeroPageY()
-{
-    const uint16_t address = calculateAddressSimple(true, reg.Y);
-    handleLdxBase(address, 1, 4);
-}
-
-void CPU6502::handleLdxAbsolute()
-{
-    const uint16_t address = calculateAddressSimple(false, 0);
-    handleLdxBase(address, 2, 4);
-}
-
-void CPU6502::handleLdxAbsoluteY()
-{
-    auto [address, page_crossed] = calculateAddress(false, reg.Y);
-    const uint8_t cycles = 4 + (page_crossed ? 1 : 0);
-    handleLdxBase(address, 2, cycles);
-}
-
-void CPU6502::handleLdxBase(const uint16_t address, const uint8_t pc_offset, const uint8_t cycles)
-{
-    const uint8_t val = mem_.read(address);
-    reg.X = val;
-    updateZeroNegativeFlags(reg.X);
-    reg.PC += pc_offset;
-    cycles_ += cycles;
-}
-
-// LDY instruction family handlers
-void CPU6502::handleLdyImmediate()
-{
-    handleLdyBase(reg.PC, 1, 2);
-}
-
-void CPU6502::handleLdyZeroPage()
-{
-    const uint16_t address = calculateAddressSimple(true, 0);
-    handleLdyBase(address, 1, 3);
-}
-
-void CPU6502::handleLdyZeroPageX()
-{
-    const uint16_t address = calculateAddressSimple(true, reg.X);
-    handleLdyBase(address, 1, 4);
-}
-
-void CPU6502::handleLdyAbsolute()
-{
-    const uint16_t address = calculateAddressSimple(false, 0);
-    handleLdyBase(address, 2, 4);
-}
-
-void CPU6502::handleLdyAbsoluteX()
-{
-    auto [address, page_crossed] = calculateAddress(false, reg.X);
-    const uint8_t cycles = 4 + (page_crossed ? 1 : 0);
-    handleLdyBase(address, 2, cycles);
-}
-
-void CPU6502::handleLdyBase(const uint16_t address, const uint8_t pc_offset, const uint8_t cycles)
-{
-    const uint8_t val = mem_.read(address);
-    reg.Y = val;
-    updateZeroNegativeFlags(reg.Y);
-    reg.PC += pc_offset;
-    cycles_ += cycles;
-}
-
-// STX instruction family handlers
-void CPU6502::handleStxZeroPage()
-{
-    const uint16_t address = calculateAddressSimple(true, 0);
-    handleStxBase(address, 1, 3);
-}
-
-void CPU6502::handleStxZeroPageY()
-{
-    const uint16_t address = calculateAddressSimple(true, reg.Y);
-    handleStxBase(address, 1, 4);
-}
-
-void CPU6502::handleStxAbsolute()
-{
-    const uint16_t address = calculateAddressSimple(false, 0);
-    handleStxBase(address, 2, 4);
-}
-
-void CPU6502::handleStxBase(const uint16_t address, const uint8_t pc_offset, const uint8_t cycles)
-{
-    mem_.write(address, reg.X);
-    reg.PC += pc_offset;
-    cycles_ += cycles;
-}
-
-// STY instruction family handlers
-void CPU6502::handleStyZeroPage()
-{
-    const uint16_t address = calculateAddressSimple(true, 0);
-    handleStyBase(address, 1, 3);
-}
-
-void CPU6502::handleStyZeroPageX()
-{
-    const uint16_t address = calculateAddressSimple(true, reg.X);
-    handleStyBase(address, 1, 4);
-}
-
-void CPU6502::handleStyAbsolute()
-{
-    const uint16_t address = calculateAddressSimple(false, 0);
-    handleStyBase(address, 2, 4);
-}
-
-void CPU6502::handleStyBase(const uint16_t address, const uint8_t pc_offset, const uint8_t cycles)
-{
-    mem_.write(address, reg.Y);
-    reg.PC += pc_offset;
-    cycles_ += cycles;
-}
-
-// CMP instruction family handlers
-void CPU6502::handleCmpImmediate()
-{
-    handleCmpBase(reg.PC, 1, 2);
-}
-
-void CPU6502::handleCmpZeroPage()
-{
-    const uint16_t address = calculateAddressSimple(true, 0);
-    handleCmpBase(address, 1, 3);
-}
-
-void CPU6502::handleCmpZeroPageX()
-{
-    const uint16_t address = calculateAddressSimple(true, reg.X);
-    handleCmpBase(address, 1, 4);
-}
-
-void CPU6502::handleCmpAbsolute()
-{
-    const uint16_t address = calculateAddressSimple(false, 0);
-    handleCmpBase(address, 2, 4);
-}
-
-void CPU6502::handleCmpAbsoluteX()
-{
-    auto [address, page_crossed] = calculateAddress(false, reg.X);
-    const uint8_t cycles = 4 + (page_crossed ? 1 : 0);
-    handleCmpBase(address, 2, cycles);
-}
-
-void CPU6502::handleCmpAbsoluteY()
-{
-    auto [address, page_crossed] = calculateAddress(false, reg.Y);
-    const uint8_t cycles = 4 + (page_crossed ? 1 : 0);
-    handleCmpBase(address, 2, cycles);
-}
-
-void CPU6502::handleCmpIndexedIndirect()
-{
-    auto [address, cycle] = calculateIndexedAddress(reg.X);
-    handleCmpBase(address, 1, 6);
-}
-
-void CPU6502::handleCmpIndirectIndexed()
-{
-    auto [address, cycle] = calculateIndirectAddress(reg.Y);
-    const uint8_t cycles = 5 + cycle;
-    handleCmpBase(address, 1, cycles);
-}
-
-void CPU6502::handleCmpBase(const uint16_t address, const uint8_t pc_offset, const uint8_t cycles)
-{
-    const uint8_t val = mem_.read(address);
-    compareValues(reg.A, val);
-    reg.PC += pc_offset;
-    cycles_ += cycles;
-}
-
-// CPX instruction family handlers
-void CPU6502::handleCpxImmediate()
-{
-    handleCpxBase(reg.PC, 1, 2);
-}
-
-void CPU6502::handleCpxZeroPage()
-{
-    const uint16_t address = calculateAddressSimple(true, 0);
-    handleCpxBase(address, 1, 3);
-}
-
-void CPU6502::handleCpxAbsolute()
-{
-    const uint16_t address = calculateAddressSimple(false, 0);
-    handleCpxBase(address, 2, 4);
-}
-
-void CPU6502::handleCpxBase(const uint16_t address, const uint8_t pc_offset, const uint8_t cycles)
-{
-    const uint8_t val = mem_.read(address);
-    compareValues(reg.X, val);
-    reg.PC += pc_offset;
-    cycles_ += cycles;
-}
-
-// CPY instruction family handlers
-void CPU6502::handleCpyImmediate()
-{
-    handleCpyBase(reg.PC, 1, 2);
-}
-
-void CPU6502::handleCpyZeroPage()
-{
-    const uint16_t address = calculateAddressSimple(true, 0);
-    handleCpyBase(address, 1, 3);
-}
-
-void CPU6502::handleCpyAbsolute()
-{
-    const uint16_t address = calculateAddressSimple(false, 0);
-    handleCpyBase(address, 2, 4);
-}
-
-void CPU6502::handleCpyBase(const uint16_t address, const uint8_t pc_offset, const uint8_t cycles)
-{
-    const uint8_t val = mem_.read(address);
-    compareValues(reg.Y, val);
-    reg.PC += pc_offset;
-    cycles_ += cycles;
-}
-
-// SBC instruction family handlers
-void CPU6502::handleSbcImmediate()
-{
-    handleSbcBase(reg.PC, 1, 2);
-}
-
-void CPU6502::handleSbcZeroPage()
-{
-    const uint16_t address = calculateAddressSimple(true, 0);
-    handleSbcBase(address, 1, 3);
-}
-
-void CPU6502::handleSbcZeroPageX()
-{
-    const uint16_t address = calculateAddressSimple(true, reg.X);
-    handleSbcBase(address, 1, 4);
-}
-
-void CPU6502::handleSbcAbsolute()
-{
-    const uint16_t address = calculateAddressSimple(false, 0);
-    handleSbcBase(address, 2, 4);
-}
-
-void CPU6502::handleSbcAbsoluteX()
-{
-    auto [address, page_crossed] = calculateAddress(false, reg.X);
-    const uint8_t cycles = 4 + (page_crossed ? 1 : 0);
-    handleSbcBase(address, 2, cycles);
-}
-
-void CPU6502::handleSbcAbsoluteY()
-{
-    auto [address, page_crossed] = calculateAddress(false, reg.Y);
-    const uint8_t cycles = 4 + (page_crossed ? 1 : 0);
-    handleSbcBase(address, 2, cycles);
-}
-
-void CPU6502::handleSbcIndexedIndirect()
-{
-    auto [address, cycle] = calculateIndexedAddress(reg.X);
-    handleSbcBase(address, 1, 6);
-}
-
-void CPU6502::handleSbcIndirectIndexed()
-{
-    auto [address, cycle] = calculateIndirectAddress(reg.Y);
-    const uint8_t cycles = 5 + cycle;
-    handleSbcBase(address, 1, cycles);
-}
-
-void CPU6502::handleSbcBase(const uint16_t address, const uint8_t pc_offset, const uint8_t cycles)
-{
-    const uint8_t val = mem_.read(address);
-    reg.A = subtractValues(reg.A, val);
-    updateZeroNegativeFlags(reg.A);
-    reg.PC += pc_offset;
-    cycles_ += cycles;
-}
-
-// EOR instruction family handlers
-void CPU6502::handleEorImmediate()
-{
-    handleEorBase(reg.PC, 1, 2);
-}
-
-void CPU6502::handleEorZeroPage()
-{
-    const uint16_t address = calculateAddressSimple(true, 0);
-    handleEorBase(address, 1, 3);
-}
-
-void CPU6502::handleEorZeroPageX()
-{
-    const uint16_t address = calculateAddressSimple(true, reg.X);
-    handleEorBase(address, 1, 4);
-}
-
-void CPU6502::handleEorAbsolute()
-{
-    const uint16_t address = calculateAddressSimple(false, 0);
-    handleEorBase(address, 2, 4);
-}
-
-void CPU6502::handleEorAbsoluteX()
-{
-    auto [address, page_crossed] = calculateAddress(false, reg.X);
-    const uint8_t cycles = 4 + (page_crossed ? 1 : 0);
-    handleEorBase(address, 2, cycles);
-}
-
-void CPU6502::handleEorAbsoluteY()
-{
-    auto [address, page_crossed] = calculateAddress(false, reg.Y);
-    const uint8_t cycles = 4 + (page_crossed ? 1 : 0);
-    handleEorBase(address, 2, cycles);
-}
-
-void CPU6502::handleEorIndexedIndirect()
-{
-    auto [address, cycle] = calculateIndexedAddress(reg.X);
-    handleEorBase(address, 1, 6);
-}
-
-void CPU6502::handleEorIndirectIndexed()
-{
-    auto [address, cycle] = calculateIndirectAddress(reg.Y);
-    const uint8_t cycles = 5 + cycle;
-    handleEorBase(address, 1, cycles);
-}
-
-void CPU6502::handleEorBase(const uint16_t address, const uint8_t pc_offset, const uint8_t cycles)
-{
-    const uint8_t val = mem_.read(address);
-    reg.A ^= val;  // Exclusive OR operation
-    updateZeroNegativeFlags(reg.A);
-    reg.PC += pc_offset;
-    cycles_ += cycles;
-}
-
-// ORA instruction family handlers
-void CPU6502::handleOraImmediate()
-{
-    handleOraBase(reg.PC, 1, 2);
-}
-
-void CPU6502::handleOraZeroPage()
-{
-    const uint16_t address = calculateAddressSimple(true, 0);
-    handleOraBase(address, 1, 3);
-}
-
-void CPU6502::handleOraZeroPageX()
-{
-    const uint16_t address = calculateAddressSimple(true, reg.X);
-    handleOraBase(address, 1, 4);
-}
-
-void CPU6502::handleOraAbsolute()
-{
-    const uint16_t address = calculateAddressSimple(false, 0);
-    handleOraBase(address, 2, 4);
-}
-
-void CPU6502::handleOraAbsoluteX()
-{
-    auto [address, page_crossed] = calculateAddress(false, reg.X);
-    const uint8_t cycles = 4 + (page_crossed ? 1 : 0);
-    handleOraBase(address, 2, cycles);
-}
-
-void CPU6502::handleOraAbsoluteY()
-{
-    auto [address, page_crossed] = calculateAddress(false, reg.Y);
-    const uint8_t cycles = 4 + (page_crossed ? 1 : 0);
-    handleOraBase(address, 2, cycles);
-}
-
-void CPU6502::handleOraIndexedIndirect()
-{
-    auto [address, cycle] = calculateIndexedAddress(reg.X);
-    handleOraBase(address, 1, 6);
-}
-
-void CPU6502::handleOraIndirectIndexed()
-{
-    auto [address, cycle] = calculateIndirectAddress(reg.Y);
-    const uint8_t cycles = 5 + cycle;
-    handleOraBase(address, 1, cycles);
-}
-
-void CPU6502::handleOraBase(const uint16_t address, const uint8_t pc_offset, const uint8_t cycles)
-{
-    const uint8_t val = mem_.read(address);
-    reg.A |= val;  // Logical OR operation
-    updateZeroNegativeFlags(reg.A);
-    reg.PC += pc_offset;
-    cycles_ += cycles;
-}
-
-// BIT instruction family handlers
-void CPU6502::handleBitZeroPage()
-{
-    const uint16_t address = calculateAddressSimple(true, 0);
-    handleBitBase(address, 1, 3);
-}
-
-void CPU6502::handleBitAbsolute()
-{
-    const uint16_t address = calculateAddressSimple(false, 0);
-    handleBitBase(address, 2, 4);
-}
-
-    void CPU6502::handleBitImmediate()
-{
-    // BIT # - $89: Bit test immediate (only affects zero flag)
-    const uint8_t val = readByte();
-    const uint8_t result = reg.A & val;
-
-    // Only zero flag is affected in immediate mode
-    setFlag(kZero, result == 0);
-
-    cycles_ += 2;
-}
-
-    void CPU6502::handleBitZeroPageX()
-{
-    // BIT zp,X - $34: Bit test zero page,X
-    const uint16_t address = calculateAddressSimple(true, reg.X);
-    handleBitBase(address, 1, 4);
-}
-
-    void CPU6502::handleBitAbsoluteX()
-{
-    // BIT abs,X - $3C: Bit test absolute,X
-    auto [address, page_crossed] = calculateAddress(false, reg.X);
-    const uint8_t cycles = 4 + (page_crossed ? 1 : 0);
-    handleBitBase(address, 2, cycles);
-}
-
-void CPU6502::handleBitBase(const uint16_t address, const uint8_t pc_offset, const uint8_t cycles)
-{
-    const uint8_t val = mem_.read(address);
-    const uint8_t result = reg.A & val;
-
-    // Set zero flag based on AND result
-    setFlag(kZero, result == 0);
-
-    // Transfer bit 7 of memory to negative flag
-    setFlag(kNegative, (val & 0x80) != 0);
-
-    // Transfer bit 6 of memory to overflow flag
-    setFlag(kOverflow, (val & 0x40) != 0);
-
-    reg.PC += pc_offset;
-    cycles_ += cycles;
-}
-
-// LSR instruction family handlers
-void CPU6502::handleLsrAccumulator()
-{
-    // Set carry flag to bit 0 of accumulator
-    setFlag(kCarry, (reg.A & 0x01) != 0);
-
-    // Shift right by one bit
-    reg.A = reg.A >> 1;
-
-    // Update flags
-    updateZeroNegativeFlags(reg.A);
-
-    cycles_ += 2;
-}
-
-void CPU6502::handleLsrZeroPage()
-{
-    const uint16_t address = calculateAddressSimple(true, 0);
-    handleLsrBase(address, 1, 5);
-}
-
-void CPU6502::handleLsrZeroPageX()
-{
-    const uint16_t address = calculateAddressSimple(true, reg.X);
-    handleLsrBase(address, 1, 6);
-}
-
-void CPU6502::handleLsrAbsolute()
-{
-    const uint16_t address = calculateAddressSimple(false, 0);
-    handleLsrBase(address, 2, 6);
-}
-
-void CPU6502::handleLsrAbsoluteX()
-{
-    auto [address, page_crossed] = calculateAddress(false, reg.X);
-    handleLsrBase(address, 2, 7);
-}
-
-void CPU6502::handleLsrBase(const uint16_t address, const uint8_t pc_offset, const uint8_t cycles)
-{
-    uint8_t val = mem_.read(address);
-
-    // Set carry flag to bit 0 of value
-    setFlag(kCarry, (val & 0x01) != 0);
-
-    // Shift right by one bit
-    val = val >> 1;
-
-    // Write back to memory
-    mem_.write(address, val);
-
-    // Update flags
-    updateZeroNegativeFlags(val);
-
-    reg.PC += pc_offset;
-    cycles_ += cycles;
-}
-
-// ROL instruction family handlers
-void CPU6502::handleRolAccumulator()
-{
-    const bool old_carry = getFlag(kCarry);
-
-    // Set carry flag to bit 7 of accumulator
-    setFlag(kCarry, (reg.A & 0x80) != 0);
-
-    // Rotate left, with old carry becoming bit 0
-    reg.A = (reg.A << 1) | (old_carry ? 1 : 0);
-
-    // Update flags
-    updateZeroNegativeFlags(reg.A);
-
-    cycles_ += 2;
-}
-
-void CPU6502::handleRolZeroPage()
-{
-    const uint16_t address = calculateAddressSimple(true, 0);
-    handleRolBase(address, 1, 5);
-}
-
-void CPU6502::handleRolZeroPageX()
-{
-    const uint16_t address = calculateAddressSimple(true, reg.X);
-    handleRolBase(address, 1, 6);
-}
-
-void CPU6502::handleRolAbsolute()
-{
-    const uint16_t address = calculateAddressSimple(false, 0);
-    handleRolBase(address, 2, 6);
-}
-
-void CPU6502::handleRolAbsoluteX()
-{
-    auto [address, page_crossed] = calculateAddress(false, reg.X);
-    handleRolBase(address, 2, 7);
-}
-
-void CPU6502::handleRolBase(const uint16_t address, const uint8_t pc_offset, const uint8_t cycles)
-{
-    uint8_t val = mem_.read(address);
-    const bool old_carry = getFlag(kCarry);
-
-    // Set carry flag to bit 7 of value
-    setFlag(kCarry, (val & 0x80) != 0);
-
-    // Rotate left, with old carry becoming bit 0
-    val = (val << 1) | (old_carry ? 1 : 0);
-
-    // Write back to memory
-    mem_.write(address, val);
-
-    // Update flags
-    updateZeroNegativeFlags(val);
-
-    reg.PC += pc_offset;
-    cycles_ += cycles;
-}
-
-// ROR instruction family handlers
-void CPU6502::handleRorAccumulator()
-{
-    const bool old_carry = getFlag(kCarry);
-
-    // Set carry flag to bit 0 of accumulator
-    setFlag(kCarry, (reg.A & 0x01) != 0);
-
-    // Rotate right, with old carry becoming bit 7
-    reg.A = (reg.A >> 1) | (old_carry ? 0x80 : 0);
-
-    // Update flags
-    updateZeroNegativeFlags(reg.A);
-
-    cycles_ += 2;
-}
-
-void CPU6502::handleRorZeroPage()
-{
-    const uint16_t address = calculateAddressSimple(true, 0);
-    handleRorBase(address, 1, 5);
-}
-
-void CPU6502::handleRorZeroPageX()
-{
-    const uint16_t address = calculateAddressSimple(true, reg.X);
-    handleRorBase(address, 1, 6);
-}
-
-void CPU6502::handleRorAbsolute()
-{
-    const uint16_t address = calculateAddressSimple(false, 0);
-    handleRorBase(address, 2, 6);
-}
-
-void CPU6502::handleRorAbsoluteX()
-{
-    auto [address, page_crossed] = calculateAddress(false, reg.X);
-    handleRorBase(address, 2, 7);
-}
-
-void CPU6502::handleRorBase(const uint16_t address, const uint8_t pc_offset, const uint8_t cycles)
-{
-    uint8_t val = mem_.read(address);
-    const bool old_carry = getFlag(kCarry);
-
-    // Set carry flag to bit 0 of value
-    setFlag(kCarry, (val & 0x01) != 0);
-
-    // Rotate right, with old carry becoming bit 7
-    val = (val >> 1) | (old_carry ? 0x80 : 0);
-
-    // Write back to memory
-    mem_.write(address, val);
-
-    // Update flags
-    updateZeroNegativeFlags(val);
-
-    reg.PC += pc_offset;
-    cycles_ += cycles;
-}
-
-// INC instruction family handlers
-void CPU6502::handleIncZeroPage()
-{
-    const uint16_t address = calculateAddressSimple(true, 0);
-    handleIncBase(address, 1, 5);
-}
-
-void CPU6502::handleIncZeroPageX()
-{
-    const uint16_t address = calculateAddressSimple(true, reg.X);
-    handleIncBase(address, 1, 6);
-}
-
-void CPU6502::handleIncAbsolute()
-{
-    const uint16_t address = calculateAddressSimple(false, 0);
-    handleIncBase(address, 2, 6);
-}
-
-void CPU6502::handleIncAbsoluteX()
-{
-    auto [address, page_crossed] = calculateAddress(false, reg.X);
-    handleIncBase(address, 2, 7);
-}
-
-void CPU6502::handleIncBase(const uint16_t address, const uint8_t pc_offset, const uint8_t cycles)
-{
-    uint8_t val = mem_.read(address);
-    val++;
-    mem_.write(address, val);
-    updateZeroNegativeFlags(val);
-    reg.PC += pc_offset;
-    cycles_ += cycles;
-}
-
-// DEC instruction family handlers
-void CPU6502::handleDecZeroPage()
-{
-    const uint16_t address = calculateAddressSimple(true, 0);
-    handleDecBase(address, 1, 5);
-}
-
-void CPU6502::handleDecZeroPageX()
-{
-    const uint16_t address = calculateAddressSimple(true, reg.X);
-    handleDecBase(address, 1, 6);
-}
-
-void CPU6502::handleDecAbsolute()
-{
-    const uint16_t address = calculateAddressSimple(false, 0);
-    handleDecBase(address, 2, 6);
-}
-
-void CPU6502::handleDecAbsoluteX()
-{
-    auto [address, page_crossed] = calculateAddress(false, reg.X);
-    handleDecBase(address, 2, 7);
-}
-
-void CPU6502::handleDecBase(const uint16_t address, const uint8_t pc_offset, const uint8_t cycles)
-{
-    uint8_t val = mem_.read(address);
-    val--;
-    mem_.write(address, val);
-    updateZeroNegativeFlags(val);
-    reg.PC += pc_offset;
-    cycles_ += cycles;
-}
-
-// Register increment/decrement handlers
-void CPU6502::handleInx()
-{
-    reg.X++;
-    updateZeroNegativeFlags(reg.X);
-    cycles_ += 2;
-}
-
-void CPU6502::handleIny()
-{
-    reg.Y++;
-    updateZeroNegativeFlags(reg.Y);
-    cycles_ += 2;
-}
-
-void CPU6502::handleDex()
-{
-    reg.X--;
-    updateZeroNegativeFlags(reg.X);
-    cycles_ += 2;
-}
-
-void CPU6502::handleDey()
-{
-    reg.Y--;
-    updateZeroNegativeFlags(reg.Y);
-    cycles_ += 2;
-}
-
-void CPU6502::handleIncAccumulator()
-{
-    // INC A - $1A: Increment accumulator
-    reg.A++;
-    updateZeroNegativeFlags(reg.A);
-    cycles_ += 2;
-}
-
-void CPU6502::handleDecAccumulator()
-{
-    // DEC A - $3A: Decrement accumulator
-    reg.A--;
-    updateZeroNegativeFlags(reg.A);
-    cycles_ += 2;
-}
-
-// 65C02 zero-page indirect addressing modes — (zp), 5 cycles, 2-byte instruction.
-// These reuse the shared base handlers, which advance PC past the 1-byte
-// operand (pc_offset = 1) and set flags identically to the other modes.
-void CPU6502::handleAdcZeroPageIndirect()  // ADC (zp) - $72
-{
-    handleAdcBase(calculateZeroPageIndirectAddress(), 1, 5);
-}
-
-void CPU6502::handleAndZeroPageIndirect()  // AND (zp) - $32
-{
-    handleAndBase(calculateZeroPageIndirectAddress(), 1, 5);
-}
-
-void CPU6502::handleCmpZeroPageIndirect()  // CMP (zp) - $D2
-{
-    handleCmpBase(calculateZeroPageIndirectAddress(), 1, 5);
-}
-
-void CPU6502::handleEorZeroPageIndirect()  // EOR (zp) - $52
-{
-    handleEorBase(calculateZeroPageIndirectAddress(), 1, 5);
-}
-
-void CPU6502::handleLdaZeroPageIndirect()  // LDA (zp) - $B2
-{
-    handleLdaBase(calculateZeroPageIndirectAddress(), 1, 5);
-}
-
-void CPU6502::handleOraZeroPageIndirect()  // ORA (zp) - $12
-{
-    handleOraBase(calculateZeroPageIndirectAddress(), 1, 5);
-}
-
-void CPU6502::handleSbcZeroPageIndirect()  // SBC (zp) - $F2
-{
-    handleSbcBase(calculateZeroPageIndirectAddress(), 1, 5);
-}
-
-void CPU6502::handleStaZeroPageIndirect()  // STA (zp) - $92
-{
-    handleStaBase(calculateZeroPageIndirectAddress(), 1, 5);
-}
-
-// 65C02 Jump Absolute Indexed Indirect
-void CPU6502::handleJmpAbsoluteIndexedIndirect()
-{
-    // JMP (addr,X) - $7C: Jump absolute indexed indirect
-    const uint16_t target_addr = calculateAbsoluteIndexedIndirectAddress();
-    reg.PC = target_addr;
-    cycles_ += 6;  // 65C02 timing
-}
-
-// 65C02 Store Zero instructions
-void CPU6502::handleStzZeroPage()
-{
-    // STZ zp - $64: Store zero to zero page
-    const uint16_t address = calculateAddressSimple(true, 0);
-    handleStzBase(address, 1, 3);
-}
-
-void CPU6502::handleStzZeroPageX()
-{
-    // STZ zp,X - $74: Store zero to zero page,X
-    const uint16_t address = calculateAddressSimple(true, reg.X);
-    handleStzBase(address, 1, 4);
-}
-
-void CPU6502::handleStzAbsolute()
-{
-    // STZ abs - $9C: Store zero to absolute
-    const uint16_t address = calculateAddressSimple(false, 0);
-    handleStzBase(address, 2, 4);
-}
-
-void CPU6502::handleStzAbsoluteX()
-{
-    // STZ abs,X - $9E: Store zero to absolute,X
-    auto [address, page_crossed] = calculateAddress(false, reg.X);
-    handleStzBase(address, 2, 5);  // Always 5 cycles for STZ
-}
-
-void CPU6502::handleStzBase(const uint16_t address, const uint8_t pc_offset, const uint8_t cycles)
-{
-    mem_.write(address, 0x00);  // Store zero
-    reg.PC += pc_offset;
-    cycles_ += cycles;
-}
-
-// 65C02 Test and Reset/Set Bits
-void CPU6502::handleTrbZeroPage()
-{
-    // TRB zp - $14: Test and reset bits zero page
-    const uint16_t address = calculateAddressSimple(true, 0);
-    handleTrbTsbBase(address, 1, 5, false);
-}
-
-void CPU6502::handleTrbAbsolute()
-{
-    // TRB abs - $1C: Test and reset bits absolute
-    const uint16_t address = calculateAddressSimple(false, 0);
-    handleTrbTsbBase(address, 2, 6, false);
-}
-
-void CPU6502::handleTsbZeroPage()
-{
-    // TSB zp - $04: Test and set bits zero page
-    const uint16_t address = calculateAddressSimple(true, 0);
-    handleTrbTsbBase(address, 1, 5, true);
-}
-
-void CPU6502::handleTsbAbsolute()
-{
-    // TSB abs - $0C: Test and set bits absolute
-    const uint16_t address = calculateAddressSimple(false, 0);
-    handleTrbTsbBase(address, 2, 6, true);
-}
-
-void CPU6502::handleTrbTsbBase(const uint16_t address, const uint8_t pc_offset, const uint8_t cycles, const bool is_set)
-{
-    uint8_t val = mem_.read(address);
-
-    // Test: Set zero flag if (A AND memory) == 0
-    setFlag(kZero, (reg.A & val) == 0);
-
-    if (is_set) {
-        // TSB: Set bits in memory where accumulator has 1 bits
-        val |= reg.A;
-    } else {
-        // TRB: Reset bits in memory where accumulator has 1 bits
-        val &= ~reg.A;
-    }
-
-    mem_.write(address, val);
-    reg.PC += pc_offset;
-    cycles_ += cycles;
-}
-
-// 65C02 Processor Control
-void CPU6502::handleStp()
-{
-    // STP - $DB: Stop processor
-    // In a real implementation, this would halt the CPU
-    // For our emulator, we'll just add cycles and continue
-    cycles_ += 3;
-
-    // TODO: In a full implementation, this should set a "stopped" flag
-    // that prevents further instruction execution until reset
-}
-
-void CPU6502::handleWai()
-{
-    // WAI - $CB: Wait for interrupt
-    // In a real implementation, this would wait for IRQ/NMI
-    // For our emulator, we'll just add cycles and continue
-    cycles_ += 3;
-
-    // TODO: In a full implementation, this should wait for an interrupt
-    // and only resume execution when IRQ or NMI occurs
-}
-
-// 65C02 (Rockwell/WDC) single-bit memory operations on zero page.
-// RMB/SMB reset/set bit n of a zero-page byte; no flags are affected.
-// BBR/BBS test bit n and branch (rel) if it is reset/set; no flags affected.
-void CPU6502::handleRmb(const uint8_t bit)  // RMBn zp - 5 cycles, 2 bytes
-{
-    const uint8_t addr = mem_.read(reg.PC);
-    reg.PC += 1;
-    const uint8_t val = mem_.read(addr);
-    mem_.write(addr, static_cast<uint8_t>(val & ~(1u << bit)));
-    cycles_ += 5;
-}
-
-void CPU6502::handleSmb(const uint8_t bit)  // SMBn zp - 5 cycles, 2 bytes
-{
-    const uint8_t addr = mem_.read(reg.PC);
-    reg.PC += 1;
-    const uint8_t val = mem_.read(addr);
-    mem_.write(addr, static_cast<uint8_t>(val | (1u << bit)));
-    cycles_ += 5;
-}
-
-void CPU6502::handleBbr(const uint8_t bit)  // BBRn zp,rel - 5 cycles, 3 bytes
-{
-    const uint8_t addr = mem_.read(reg.PC);
-    const uint8_t offset = mem_.read(reg.PC + 1);
-    reg.PC += 2;
-    cycles_ += 5;
-    if ((mem_.read(addr) & (1u << bit)) == 0)
-    {
-        auto [target_pc, page_crossed] = calculateRelativeAddress(offset);
-        reg.PC = target_pc;
-    }
-}
-
-void CPU6502::handleBbs(const uint8_t bit)  // BBSn zp,rel - 5 cycles, 3 bytes
-{
-    const uint8_t addr = mem_.read(reg.PC);
-    const uint8_t offset = mem_.read(reg.PC + 1);
-    reg.PC += 2;
-    cycles_ += 5;
-    if ((mem_.read(addr) & (1u << bit)) != 0)
-    {
-        auto [target_pc, page_crossed] = calculateRelativeAddress(offset);
-        reg.PC = target_pc;
-    }
-}
-
-void CPU6502::initializeInstructionHandlers()
-{
-    // System instructions
-    handlers_[0x00] = [this]() { handleBrk(); };
-    handlers_[0xEA] = [this]() { handleNop(); };
-    handlers_[0x20] = [this]() { handleJsr(); };
-    handlers_[0x60] = [this]() { handleRts(); };
-    handlers_[0x40] = [this]() { handleRti(); };
-    
-    // LDA instructions
-    handlers_[0xA9] = [this]() { handleLdaImmediate(); };
-    handlers_[0xA5] = [this]() { handleLdaZeroPage(); };
-    handlers_[0xB5] = [this]() { handleLdaZeroPageX(); };
-    handlers_[0xAD] = [this]() { handleLdaAbsolute(); };
-    handlers_[0xBD] = [this]() { handleLdaAbsoluteX(); };
-    handlers_[0xB9] = [this]() { handleLdaAbsoluteY(); };
-    handlers_[0xA1] = [this]() { handleLdaIndexedIndirect(); };
-    handlers_[0xB1] = [this]() { handleLdaIndirectIndexed(); };
-    
-    // STA instructions
-    handlers_[0x85] = [this]() { handleStaZeroPage(); };
-    handlers_[0x95] = [this]() { handleStaZeroPageX(); };
-    handlers_[0x8D] = [this]() { handleStaAbsolute(); };
-    handlers_[0x9D] = [this]() { handleStaAbsoluteX(); };
-    handlers_[0x99] = [this]() { handleStaAbsoluteY(); };
-    handlers_[0x81] = [this]() { handleStaIndexedIndirect(); };
-    handlers_[0x91] = [this]() { handleStaIndirectIndexed(); };
-    
-    // JMP instructions
-    handlers_[0x4C] = [this]() { handleJmpAbsolute(); };
-    handlers_[0x6C] = [this]() { handleJmpIndirect(); };
-    
-    // AND instructions
-    handlers_[0x29] = [this]() { handleAndImmediate(); };
-    handlers_[0x25] = [this]() { handleAndZeroPage(); };
-    handlers_[0x35] = [this]() { handleAndZeroPageX(); };
-    handlers_[0x2D] = [this]() { handleAndAbsolute(); };
-    handlers_[0x3D] = [this]() { handleAndAbsoluteX(); };
-    handlers_[0x39] = [this]() { handleAndAbsoluteY(); };
-    handlers_[0x21] = [this]() { handleAndIndexedIndirect(); };
-    handlers_[0x31] = [this]() { handleAndIndirectIndexed(); };
-    
-    // LDX instructions
-    handlers_[0xA2] = [this]() { handleLdxImmediate(); };
-    handlers_[0xA6] = [this]() { handleLdxZeroPage(); };
-    handlers_[0xB6] = [this]() { handleLdxZeroPageY(); };
-    handlers_[0xAE] = [this]() { handleLdxAbsolute(); };
-    handlers_[0xBE] = [this]() { handleLdxAbsoluteY(); };
-    
-    // LDY instructions
-    handlers_[0xA0] = [this]() { handleLdyImmediate(); };
-    handlers_[0xA4] = [this]() { handleLdyZeroPage(); };
-    handlers_[0xB4] = [this]() { handleLdyZeroPageX(); };
-    handlers_[0xAC] = [this]() { handleLdyAbsolute(); };
-    handlers_[0xBC] = [this]() { handleLdyAbsoluteX(); };
-    
-    // STX instructions
-    handlers_[0x86] = [this]() { handleStxZeroPage(); };
-    handlers_[0x96] = [this]() { handleStxZeroPageY(); };
-    handlers_[0x8E] = [this]() { handleStxAbsolute(); };
-    
-    // STY instructions
-    handlers_[0x84] = [this]() { handleStyZeroPage(); };
-    handlers_[0x94] = [this]() { handleStyZeroPageX(); };
-    handlers_[0x8C] = [this]() { handleStyAbsolute(); };
-    
-    // Branch instructions
-    handlers_[0x90] = [this]() { handleBcc(); };
-    handlers_[0xB0] = [this]() { handleBcs(); };
-    handlers_[0xF0] = [this]() { handleBeq(); };
-    handlers_[0x30] = [this]() { handleBmi(); };
-    handlers_[0xD0] = [this]() { handleBne(); };
-    handlers_[0x10] = [this]() { handleBpl(); };
-    handlers_[0x50] = [this]() { handleBvc(); };
-    handlers_[0x70] = [this]() { handleBvs(); };
-    
-    // ADC instructions
-    handlers_[0x69] = [this]() { handleAdcImmediate(); };
-    handlers_[0x65] = [this]() { handleAdcZeroPage(); };
-    handlers_[0x75] = [this]() { handleAdcZeroPageX(); };
-    handlers_[0x6D] = [this]() { handleAdcAbsolute(); };
-    handlers_[0x7D] = [this]() { handleAdcAbsoluteX(); };
-    handlers_[0x79] = [this]() { handleAdcAbsoluteY(); };
-    handlers_[0x61] = [this]() { handleAdcIndexedIndirect(); };
-    handlers_[0x71] = [this]() { handleAdcIndirectIndexed(); };
-    
-    // SBC instructions
-    handlers_[0xE9] = [this]() { handleSbcImmediate(); };
-    handlers_[0xE5] = [this]() { handleSbcZeroPage(); };
-    handlers_[0xF5] = [this]() { handleSbcZeroPageX(); };
-    handlers_[0xED] = [this]() { handleSbcAbsolute(); };
-    handlers_[0xFD] = [this]() { handleSbcAbsoluteX(); };
-    handlers_[0xF9] = [this]() { handleSbcAbsoluteY(); };
-    handlers_[0xE1] = [this]() { handleSbcIndexedIndirect(); };
-    handlers_[0xF1] = [this]() { handleSbcIndirectIndexed(); };
-    
-    // CMP instructions
-    handlers_[0xC9] = [this]() { handleCmpImmediate(); };
-    handlers_[0xC5] = [this]() { handleCmpZeroPage(); };
-    handlers_[0xD5] = [this]() { handleCmpZeroPageX(); };
-    handlers_[0xCD] = [this]() { handleCmpAbsolute(); };
-    handlers_[0xDD] = [this]() { handleCmpAbsoluteX(); };
-    handlers_[0xD9] = [this]() { handleCmpAbsoluteY(); };
-    handlers_[0xC1] = [this]() { handleCmpIndexedIndirect(); };
-    handlers_[0xD1] = [this]() { handleCmpIndirectIndexed(); };
-    
-    // CPX instructions
-    handlers_[0xE0] = [this]() { handleCpxImmediate(); };
-    handlers_[0xE4] = [this]() { handleCpxZeroPage(); };
-    handlers_[0xEC] = [this]() { handleCpxAbsolute(); };
-    
-    // CPY instructions
-    handlers_[0xC0] = [this]() { handleCpyImmediate(); };
-    handlers_[0xC4] = [this]() { handleCpyZeroPage(); };
-    handlers_[0xCC] = [this]() { handleCpyAbsolute(); };
-    
-    // EOR instructions
-    handlers_[0x49] = [this]() { handleEorImmediate(); };
-    handlers_[0x45] = [this]() { handleEorZeroPage(); };
-    handlers_[0x55] = [this]() { handleEorZeroPageX(); };
-    handlers_[0x4D] = [this]() { handleEorAbsolute(); };
-    handlers_[0x5D] = [this]() { handleEorAbsoluteX(); };
-    handlers_[0x59] = [this]() { handleEorAbsoluteY(); };
-    handlers_[0x41] = [this]() { handleEorIndexedIndirect(); };
-    handlers_[0x51] = [this]() { handleEorIndirectIndexed(); };
-    
-    // ORA instructions
-    handlers_[0x09] = [this]() { handleOraImmediate(); };
-    handlers_[0x05] = [this]() { handleOraZeroPage(); };
-    handlers_[0x15] = [this]() { handleOraZeroPageX(); };
-    handlers_[0x0D] = [this]() { handleOraAbsolute(); };
-    handlers_[0x1D] = [this]() { handleOraAbsoluteX(); };
-    handlers_[0x19] = [this]() { handleOraAbsoluteY(); };
-    handlers_[0x01] = [this]() { handleOraIndexedIndirect(); };
-    handlers_[0x11] = [this]() { handleOraIndirectIndexed(); };
-    
-    // BIT instructions
-    handlers_[0x24] = [this]() { handleBitZeroPage(); };
-    handlers_[0x2C] = [this]() { handleBitAbsolute(); };
-    
-    // ASL instructions
-    handlers_[0x0A] = [this]() { handleAslAccumulator(); };
-    handlers_[0x06] = [this]() { handleAslZeroPage(); };
-    handlers_[0x16] = [this]() { handleAslZeroPageX(); };
-    handlers_[0x0E] = [this]() { handleAslAbsolute(); };
-    handlers_[0x1E] = [this]() { handleAslAbsoluteX(); };
-    
-    // LSR instructions
-    handlers_[0x4A] = [this]() { handleLsrAccumulator(); };
-    handlers_[0x46] = [this]() { handleLsrZeroPage(); };
-    handlers_[0x56] = [this]() { handleLsrZeroPageX(); };
-    handlers_[0x4E] = [this]() { handleLsrAbsolute(); };
-    handlers_[0x5E] = [this]() { handleLsrAbsoluteX(); };
-    
-    // ROL instructions
-    handlers_[0x2A] = [this]() { handleRolAccumulator(); };
-    handlers_[0x26] = [this]() { handleRolZeroPage(); };
-    handlers_[0x36] = [this]() { handleRolZeroPageX(); };
-    handlers_[0x2E] = [this]() { handleRolAbsolute(); };
-    handlers_[0x3E] = [this]() { handleRolAbsoluteX(); };
-    
-    // ROR instructions
-    handlers_[0x6A] = [this]() { handleRorAccumulator(); };
-    handlers_[0x66] = [this]() { handleRorZeroPage(); };
-    handlers_[0x76] = [this]() { handleRorZeroPageX(); };
-    handlers_[0x6E] = [this]() { handleRorAbsolute(); };
-    handlers_[0x7E] = [this]() { handleRorAbsoluteX(); };
-    
-    // INC instructions
-    handlers_[0xE6] = [this]() { handleIncZeroPage(); };
-    handlers_[0xF6] = [this]() { handleIncZeroPageX(); };
-    handlers_[0xEE] = [this]() { handleIncAbsolute(); };
-    handlers_[0xFE] = [this]() { handleIncAbsoluteX(); };
-    
-    // DEC instructions
-    handlers_[0xC6] = [this]() { handleDecZeroPage(); };
-    handlers_[0xD6] = [this]() { handleDecZeroPageX(); };
-    handlers_[0xCE] = [this]() { handleDecAbsolute(); };
-    handlers_[0xDE] = [this]() { handleDecAbsoluteX(); };
-    
-    // Register inc/dec instructions
-    handlers_[0xE8] = [this]() { handleInx(); };
-    handlers_[0xC8] = [this]() { handleIny(); };
-    handlers_[0xCA] = [this]() { handleDex(); };
-    handlers_[0x88] = [this]() { handleDey(); };
-    
-    // Flag manipulation instructions
-    handlers_[0x18] = [this]() { handleClc(); };
-    handlers_[0xD8] = [this]() { handleCld(); };
-    handlers_[0x58] = [this]() { handleCli(); };
-    handlers_[0xB8] = [this]() { handleClv(); };
-    handlers_[0x38] = [this]() { handleSec(); };
-    handlers_[0xF8] = [this]() { handleSed(); };
-    handlers_[0x78] = [this]() { handleSei(); };
-    
-    // Stack instructions
-    handlers_[0x48] = [this]() { handlePha(); };
-    handlers_[0x08] = [this]() { handlePhp(); };
-    handlers_[0x68] = [this]() { handlePla(); };
-    handlers_[0x28] = [this]() { handlePlp(); };
-    handlers_[0xDA] = [this]() { handlePhx(); };
-    handlers_[0xFA] = [this]() { handlePlx(); };
-    handlers_[0x5A] = [this]() { handlePhy(); };
-    handlers_[0x7A] = [this]() { handlePly(); };
-    
-    // Transfer instructions
-    handlers_[0xAA] = [this]() { handleTax(); };
-    handlers_[0xA8] = [this]() { handleTay(); };
-    handlers_[0xBA] = [this]() { handleTsx(); };
-    handlers_[0x8A] = [this]() { handleTxa(); };
-    handlers_[0x9A] = [this]() { handleTxs(); };
-    handlers_[0x98] = [this]() { handleTya(); };
-
-    // ================================================================
-    // 65C02 NEW INSTRUCTIONS
-    // ================================================================
-
-    // 65C02 Accumulator increment/decrement
-    handlers_[0x1A] = [this]() { handleIncAccumulator(); };  // INC A
-    handlers_[0x3A] = [this]() { handleDecAccumulator(); };  // DEC A
-
-    // 65C02 Enhanced BIT instructions
-    handlers_[0x89] = [this]() { handleBitImmediate(); };    // BIT #
-    handlers_[0x34] = [this]() { handleBitZeroPageX(); };    // BIT zp,X
-    handlers_[0x3C] = [this]() { handleBitAbsoluteX(); };    // BIT abs,X
-
-    // 65C02 Branch Always
-    handlers_[0x80] = [this]() { handleBra(); };             // BRA rel
-
-    // 65C02 zero-page indirect addressing modes — (zp)
-    handlers_[0x72] = [this]() { handleAdcZeroPageIndirect(); };  // ADC (zp)
-    handlers_[0x32] = [this]() { handleAndZeroPageIndirect(); };  // AND (zp)
-    handlers_[0xD2] = [this]() { handleCmpZeroPageIndirect(); };  // CMP (zp)
-    handlers_[0x52] = [this]() { handleEorZeroPageIndirect(); };  // EOR (zp)
-    handlers_[0xB2] = [this]() { handleLdaZeroPageIndirect(); };  // LDA (zp)
-    handlers_[0x12] = [this]() { handleOraZeroPageIndirect(); };  // ORA (zp)
-    handlers_[0xF2] = [this]() { handleSbcZeroPageIndirect(); };  // SBC (zp)
-    handlers_[0x92] = [this]() { handleStaZeroPageIndirect(); };  // STA (zp)
-
-    // 65C02 Jump Absolute Indexed Indirect
-    handlers_[0x7C] = [this]() { handleJmpAbsoluteIndexedIndirect(); };  // JMP (addr,X)
-
-    // 65C02 Store Zero instructions
-    handlers_[0x64] = [this]() { handleStzZeroPage(); };     // STZ zp
-    handlers_[0x74] = [this]() { handleStzZeroPageX(); };    // STZ zp,X
-    handlers_[0x9C] = [this]() { handleStzAbsolute(); };     // STZ abs
-    handlers_[0x9E] = [this]() { handleStzAbsoluteX(); };    // STZ abs,X
-
-    // 65C02 Test and Reset/Set Bits
-    handlers_[0x14] = [this]() { handleTrbZeroPage(); };     // TRB zp
-    handlers_[0x1C] = [this]() { handleTrbAbsolute(); };     // TRB abs
-    handlers_[0x04] = [this]() { handleTsbZeroPage(); };     // TSB zp
-    handlers_[0x0C] = [this]() { handleTsbAbsolute(); };     // TSB abs
-
-    // 65C02 Processor Control
-    handlers_[0xDB] = [this]() { handleStp(); };             // STP - Stop processor
-    handlers_[0xCB] = [this]() { handleWai(); };             // WAI - Wait for interrupt
-
-    // 65C02 (Rockwell/WDC) bit ops: RMBn $07+n*$10, SMBn $87+n*$10,
-    // BBRn $0F+n*$10, BBSn $8F+n*$10, for n = 0..7.
-    for (uint8_t n = 0; n < 8; ++n)
-    {
-        handlers_[0x07 + n * 0x10] = [this, n]() { handleRmb(n); };
-        handlers_[0x87 + n * 0x10] = [this, n]() { handleSmb(n); };
-        handlers_[0x0F + n * 0x10] = [this, n]() { handleBbr(n); };
-        handlers_[0x8F + n * 0x10] = [this, n]() { handleBbs(n); };
-    }
-
-    // 65C02 undefined opcodes behave as deterministic multi-byte NOPs (unlike
-    // the NMOS undocumented instructions). Lengths/cycles per the WDC datasheet.
-    // 1-byte NOPs: the $x3 column (all 16) and the $xB column (minus $CB/$DB
-    // which are WAI/STP). handleNop already consumes no operand.
-    for (uint16_t op = 0x03; op <= 0xF3; op += 0x10)
-        handlers_[op] = [this]() { handleNop(); };
-    for (uint16_t op = 0x0B; op <= 0xFB; op += 0x10)
-        if (op != 0xCB && op != 0xDB)
-            handlers_[op] = [this]() { handleNop(); };
-    // 2-byte NOPs: consume one operand byte.
-    for (uint8_t op : {0x02, 0x22, 0x42, 0x62, 0x82, 0xC2, 0xE2, 0x44, 0x54, 0xD4, 0xF4})
-        handlers_[op] = [this]() { reg.PC += 1; cycles_ += 2; };
-    // 3-byte NOPs: consume two operand bytes.
-    for (uint8_t op : {0x5C, 0xDC, 0xFC})
-        handlers_[op] = [this]() { reg.PC += 2; cycles_ += 4; };
+#define CPU6502_MAP_ENTRY(opcode, op, mode, cycles) \
+    handlers_[opcode] = &Isa::execute<Isa::op, Isa::mode, cycles, Isa::StepContext>;
+    CPU6502_OPCODE_TABLE(CPU6502_MAP_ENTRY)
+#undef CPU6502_MAP_ENTRY
 }
-
+#endif
 
 } // namespace Computer
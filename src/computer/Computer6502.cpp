@@ -1,5 +1,7 @@
 #include "Computer6502.h"
 #include "MapFileParser.h"
+#include <algorithm>
+#include <chrono>
 #include <vector>
 #include <fstream>
 #include <iostream>
@@ -21,9 +23,18 @@ namespace Computer
         // interrupt is serviced.
         pia.setCpu(&cpu);
 
+        // File commands are rare: rather than checking for one after every
+        // batch, the PIA rings this when the guest starts one.
+        pia.setFileDoorbell([this]() { scheduleFileOperation(); });
+
         // Route the block-device registers ($FE24-$FE28) through memory. The
         // image is created on first write, so a missing disk.img is harmless.
         memory.setBlockDevice(&block_device);
+
+        // An event posted ahead of everything else ends the running batch
+        // early enough to fire on its cycle.
+        scheduler.setWakeup([this]() { cpu.raiseAttention(); });
+        rearmEvents(kJiffyCycles);
     }
 
     void Computer6502::showFatalError(const std::string& message)
@@ -149,28 +160,20 @@ namespace Computer
             vecsSegment->start
         );
 
-        // Module bank table: pre-load each module ROM into a switchable bank in
+        // Module bank table: install each module ROM as a switchable bank in
         // the $B000-$DFFF window (MODULE_BANK selects one; the kernel B: menu maps
-        // them on demand). Banks must match the kernel's MODULE_DIR: 1 = BASIC,
+        // them on demand). The files are mapped, not copied, the first time their
+        // bank is selected. Banks must match the kernel's MODULE_DIR: 1 = BASIC,
         // 2 = assembler. Add new modules here and in MODULE_DIR together.
         auto installBank = [this](uint8_t bank, const std::string &path, const char *name)
         {
-            std::ifstream file(path, std::ios::binary | std::ios::ate);
-            if (!file.is_open())
+            if (!memory.loadBankFile(bank, path))
             {
                 std::cout << "Warning: " << name << " ROM not found at " << path
                           << " - bank " << static_cast<int>(bank) << " will be empty\n";
                 return;
             }
-            std::streamsize size = file.tellg();
-            file.seekg(0, std::ios::beg);
-            std::vector<uint8_t> image(size);
-            if (file.read(reinterpret_cast<char *>(image.data()), size))
-            {
-                memory.loadBank(bank, image);
-                std::cout << name << " ROM installed as module bank "
-                          << static_cast<int>(bank) << " (" << size << " bytes)\n";
-            }
+            std::cout << name << " ROM installed as module bank " << static_cast<int>(bank) << "\n";
         };
 
         installBank(1, "../kernel/basic.rom", "BASIC");
@@ -199,8 +202,98 @@ namespace Computer
             }
         }
 
+        if (const size_t bound = bindRomTranslations(); bound > 0)
+        {
+            std::cout << "ROM translations: " << bound << " blocks bound\n";
+        }
+
         // Power-on reset
         reset_circuit.powerOnReset();
+        rearmEvents(cpu.getCycles() + kJiffyCycles);
+    }
+
+    size_t Computer6502::bindRomTranslations()
+    {
+        // Ahead-of-time translations linked in by the build (tools/romc). Only
+        // blocks whose bytes match the loaded images are used.
+        for (const RomTranslation *translation : RomTranslations::builtin())
+        {
+            rom_translations.add(*translation);
+        }
+        const size_t bound = rom_translations.bind(memory);
+        if (bound > 0)
+        {
+            cpu.setRomTranslations(&rom_translations);
+        }
+        return bound;
+    }
+
+    void Computer6502::scheduleFileOperation()
+    {
+        // Due at once: fires when the current batch or instruction ends.
+        scheduler.schedule(cpu.getCycles(), [this](uint64_t)
+        {
+            const auto job = [this]() { pia.processFileOperations(); };
+            if (file_job_runner_)
+            {
+                file_job_runner_(job);
+            }
+            else
+            {
+                job();
+            }
+        });
+    }
+
+    void Computer6502::armJiffyTimer(const uint64_t due)
+    {
+        // The interval timer runs in CPU cycles, so its rate is exact however
+        // fast the host runs the machine. Reposting from the due cycle (not
+        // the cycle the batch ended on) keeps the period from drifting.
+        jiffy_due_ = due;
+        scheduler.schedule(due, [this](const uint64_t when)
+        {
+            pia.pulseTimerIrq();
+            armJiffyTimer(when + kJiffyCycles);
+        });
+    }
+
+    void Computer6502::rearmEvents(const uint64_t jiffy_due)
+    {
+        scheduler.clear();
+        armJiffyTimer(jiffy_due);
+        if (pia.hasFileOperation())
+        {
+            scheduleFileOperation();
+        }
+    }
+
+    std::unique_ptr<Computer6502> Computer6502::fork()
+    {
+        auto child = std::make_unique<Computer6502>();
+
+        // Both machines keep their disk writes from here on.
+        block_device.freezeImage();
+        child->block_device = block_device;
+
+        // The screen lives in RAM, so the VIC state goes first and the RAM
+        // copy then lands in the child VIC's (already bound) screen.
+        child->video_chip.copyStateFrom(video_chip);
+        child->memory.copyStateFrom(memory);
+
+        child->pia = pia;
+        child->pia.setMemoryInterface(&child->memory);
+        child->pia.setCpu(&child->cpu);
+        child->pia.setFileDoorbell([target = child.get()]() { target->scheduleFileOperation(); });
+
+        child->cpu.copyStateFrom(cpu);
+        child->rearmEvents(jiffy_due_);   // and file work whose doorbell rang here
+        child->timing_circuit.setTargetFrequency(timing_circuit.getTargetFrequency());
+        if (rom_translations.boundCount() > 0)
+        {
+            child->bindRomTranslations();
+        }
+        return child;
     }
 
     void Computer6502::run(const int max_cycles)
@@ -208,19 +301,79 @@ namespace Computer
         // Starting execution
         for (int i = 0; i < max_cycles; ++i)
         {
+            if (cpu.isHalted())
+            {
+                const uint64_t now = cpu.getCycles();
+                const uint64_t due = scheduler.nextDue();
+                if (due != EventScheduler::kNever)
+                {
+                    // WAI/STP: the clock runs on, so idle up to the next event
+                    // (the jiffy IRQ that ends a WAI), within the steps left.
+                    const uint64_t idle = std::min<uint64_t>(due > now ? due - now : 0, max_cycles - i);
+                    if (idle > 0)
+                    {
+                        cpu.runCycles(idle);
+                        i += static_cast<int>(idle) - 1;
+                    }
+                    scheduler.runDue(cpu.getCycles());
+                    continue;
+                }
+
+                // Nothing scheduled: sleep until an interrupt or reset from
+                // another thread releases the CPU, for at most the time the
+                // remaining steps would take at 1 MHz.
+                if (!cpu.waitWhileHalted(std::chrono::microseconds(max_cycles - i)))
+                {
+                    break;
+                }
+            }
+
             if (!cpu.executeSingleInstruction())
             {
                 // Execution stopped due to unknown instruction
                 break;
             }
 
-            // Process any pending file operations
-            pia.processFileOperations();
+            // Due events, including file work the instruction rang for
+            if (scheduler.nextDue() <= cpu.getCycles())
+            {
+                scheduler.runDue(cpu.getCycles());
+            }
+        }
+    }
+
+    uint64_t Computer6502::runCycles(const uint64_t budget)
+    {
+        uint64_t executed = 0;
+        while (executed < budget)
+        {
+            // Run up to the next event; one that is already due fires first.
+            const uint64_t now = cpu.getCycles();
+            const uint64_t due = scheduler.nextDue();
+            const uint64_t slice = std::min(budget - executed, due > now ? due - now : 0);
+            if (slice > 0)
+            {
+                executed += cpu.runCycles(slice);
+            }
+
+            // Batch boundary: fire due events (file work included)
+            scheduler.runDue(cpu.getCycles());
         }
+        return executed;
+    }
+
+    uint64_t Computer6502::runSlice()
+    {
+        const uint64_t executed = runCycles(timing_circuit.sliceCycles());
+        timing_circuit.pace(executed);
+        return executed;
     }
 
     void Computer6502::reset()
     {
         reset_circuit.triggerReset();
+
+        // Events are keyed on the clock the reset just zeroed.
+        rearmEvents(cpu.getCycles() + kJiffyCycles);
     }
 }
@@ -0,0 +1,164 @@
+#include "EmulationThread.h"
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+
+namespace Computer
+{
+    namespace
+    {
+        /// Kernel variables the display's cursor follows.
+        constexpr uint16_t kCursorX = 0x0276;
+        constexpr uint16_t kCursorY = 0x0277;
+
+        /// How often a thread waiting on a host job checks for stop().
+        constexpr std::chrono::milliseconds kHostJobPoll{10};
+    } // namespace
+
+    EmulationThread::EmulationThread(Computer6502 &computer) : computer_(computer)
+    {
+    }
+
+    EmulationThread::~EmulationThread()
+    {
+        stop();
+    }
+
+    void EmulationThread::start()
+    {
+        if (thread_.joinable())
+        {
+            return;
+        }
+        if (host_executor_)
+        {
+            computer_.setFileJobRunner([this](const std::function<void()> &job) { runOnHost(job); });
+        }
+        stop_.store(false, std::memory_order_release);
+        thread_ = std::thread(&EmulationThread::run, this);
+    }
+
+    void EmulationThread::stop()
+    {
+        if (!thread_.joinable())
+        {
+            return;
+        }
+        stop_.store(true, std::memory_order_release);
+        thread_.join();
+        computer_.setFileJobRunner(nullptr);
+    }
+
+    void EmulationThread::requestFrequency(const uint32_t hz)
+    {
+        frequency_request_.store(hz, std::memory_order_release);
+    }
+
+    void EmulationThread::run()
+    {
+        // Time spent stopped is not owed to the machine.
+        computer_.getTimingCircuit()->restart();
+        while (!stop_.load(std::memory_order_acquire))
+        {
+            applyRequests();
+            computer_.runSlice();
+            publishChanges();
+        }
+    }
+
+    void EmulationThread::applyRequests()
+    {
+        uint8_t key = 0;
+        while (keys_.pop(key))
+        {
+            computer_.getPia()->addKeypress(key);
+        }
+        if (reset_requested_.exchange(false, std::memory_order_acq_rel))
+        {
+            computer_.reset();
+        }
+        if (nmi_requested_.exchange(false, std::memory_order_acq_rel))
+        {
+            computer_.getCpu()->requestNmi();
+        }
+        if (const uint32_t hz = frequency_request_.exchange(kNoRequest, std::memory_order_acq_rel); hz != kNoRequest)
+        {
+            computer_.getTimingCircuit()->setTargetFrequency(hz);
+        }
+    }
+
+    void EmulationThread::publish()
+    {
+        cursor_x_ = ~computer_.getMemory()->read(kCursorX);   // force a screen publish
+        publishChanges();
+    }
+
+    void EmulationThread::publishChanges()
+    {
+        VIC &vic = *computer_.getVideoChip();
+        Memory &memory = *computer_.getMemory();
+        const uint8_t cursor_x = memory.read(kCursorX);
+        const uint8_t cursor_y = memory.read(kCursorY);
+        if (vic.isDirty() || cursor_x != cursor_x_ || cursor_y != cursor_y_)
+        {
+            ScreenFrame frame;
+            const auto cells = vic.getScreenBuffer();
+            std::copy(cells.begin(), cells.end(), frame.cells.begin());
+            frame.cursor_x = cursor_x;
+            frame.cursor_y = cursor_y;
+            screen_.store(frame);
+            vic.clearDirty();
+            cursor_x_ = cursor_x;
+            cursor_y_ = cursor_y;
+        }
+
+        CPU6502 &cpu = *computer_.getCpu();
+        CpuSnapshot snapshot;
+        snapshot.pc = cpu.reg.PC;
+        snapshot.a = cpu.reg.A;
+        snapshot.x = cpu.reg.X;
+        snapshot.y = cpu.reg.Y;
+        snapshot.sp = cpu.reg.SP;
+        snapshot.p = cpu.reg.P;
+        snapshot.current_byte = cpu.getCurrentByte();
+        snapshot.halted = cpu.isHalted();
+        snapshot.cycles = cpu.getCycles();
+        snapshot.frequency = computer_.getTimingCircuit()->getActualFrequency();
+        registers_.store(snapshot);
+    }
+
+    void EmulationThread::runOnHost(const std::function<void()> &job)
+    {
+        // The machine is idle while the host runs the job, so the job may
+        // use it freely. Shared state, in case stop() gives up waiting and
+        // the host runs the job later.
+        struct Handoff
+        {
+            std::mutex mutex;
+            std::condition_variable done_signal;
+            bool done = false;
+        };
+        auto handoff = std::make_shared<Handoff>();
+        host_executor_([job, handoff]()
+        {
+            job();
+            {
+                std::lock_guard lock(handoff->mutex);
+                handoff->done = true;
+            }
+            handoff->done_signal.notify_all();
+        });
+
+        std::unique_lock lock(handoff->mutex);
+        while (!handoff->done_signal.wait_for(lock, kHostJobPoll, [&handoff]() { return handoff->done; }))
+        {
+            if (stop_.load(std::memory_order_acquire))
+            {
+                return;
+            }
+        }
+    }
+} // namespace Computer
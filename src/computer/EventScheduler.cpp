@@ -0,0 +1,64 @@
+#include "EventScheduler.h"
+
+#include <algorithm>
+
+namespace Computer
+{
+    EventScheduler::EventId EventScheduler::schedule(const uint64_t due, Callback callback)
+    {
+        const EventId id = next_id_++;
+        const bool earliest = due < nextDue();
+        heap_.push_back({due, id, std::move(callback)});
+        std::push_heap(heap_.begin(), heap_.end(), later);
+        if (earliest && wakeup_)
+        {
+            wakeup_();
+        }
+        return id;
+    }
+
+    bool EventScheduler::cancel(const EventId id)
+    {
+        const bool pending = std::any_of(heap_.begin(), heap_.end(),
+                                         [id](const Event &event) { return event.id == id; });
+        if (!pending || !cancelled_.insert(id).second)
+        {
+            return false;
+        }
+        dropCancelled();
+        return true;
+    }
+
+    size_t EventScheduler::runDue(const uint64_t now)
+    {
+        size_t fired = 0;
+        while (!heap_.empty() && heap_.front().due <= now)
+        {
+            std::pop_heap(heap_.begin(), heap_.end(), later);
+            Event event = std::move(heap_.back());
+            heap_.pop_back();
+            dropCancelled();
+
+            // The callback may post or cancel events, so the heap is settled
+            // before it runs.
+            event.callback(event.due);
+            ++fired;
+        }
+        return fired;
+    }
+
+    void EventScheduler::clear()
+    {
+        heap_.clear();
+        cancelled_.clear();
+    }
+
+    void EventScheduler::dropCancelled()
+    {
+        while (!heap_.empty() && cancelled_.erase(heap_.front().id) > 0)
+        {
+            std::pop_heap(heap_.begin(), heap_.end(), later);
+            heap_.pop_back();
+        }
+    }
+} // namespace Computer
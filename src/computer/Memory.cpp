@@ -1,107 +1,482 @@
 #include "Memory.h"
+#include "BankArena.h"
 #include "VIC.h"
 #include "PIA.h"
 #include "BlockDevice.h"
 
 #include <algorithm>
+#include <cstring>
 
 namespace Computer
 {
+    namespace
+    {
+        /// What an empty (uninstalled) module bank reads as: open bus, 0x00.
+        constexpr std::array<uint8_t, 256> kOpenBusPage{};
+
+        constexpr uint8_t kDosRomFirstPage = Memory::kDosRomStart >> 8;
+        constexpr uint8_t kDosRomLastPage = Memory::kDosRomEnd >> 8;
+        constexpr uint8_t kModuleWindowFirstPage = Memory::kModuleWindowStart >> 8;
+        constexpr uint8_t kModuleWindowLastPage = Memory::kModuleWindowEnd >> 8;
+        constexpr uint8_t kIoPage = Memory::kModuleBankRegister >> 8;
+
+        static_assert(BankArena::kBankSize == Memory::kModuleWindowSize);
+    } // namespace
+
     Memory::Memory(VIC *video_chip, PIA *pia)
-        : ram_(0x10000, 0x00), video_chip_(video_chip), pia_(pia),
-          bank_rom_(kBankCount)
+        : ram_(0x10000, 0x00), video_chip_(nullptr), pia_(pia),
+          banks_(std::make_shared<BankArena>())
     {
+        setVideoChip(video_chip);
+        replaceDevice(nullptr, pia);
     }
 
-    uint8_t Memory::read(uint16_t address) const
+    Memory::Memory(const Memory &other)
+        : ram_(other.ram_), video_chip_(other.video_chip_), pia_(other.pia_),
+          block_device_(other.block_device_), banks_(other.banks_),
+          current_bank_(other.current_bank_), dos_rom_(other.dos_rom_),
+          devices_(other.devices_), device_pages_(other.device_pages_),
+          device_page_index_(other.device_page_index_), ram_bank_(other.ram_bank_),
+          ram_bank_dirty_(other.ram_bank_dirty_), ram_bank_generation_(other.ram_bank_generation_),
+          page_generation_(other.page_generation_), clean_generation_(other.clean_generation_),
+          clean_valid_(other.clean_valid_), rom_epoch_(other.rom_epoch_),
+          side_effects_(other.side_effects_)
     {
-        // MODULE_BANK select register reads back the current bank
-        if (address == kModuleBankRegister)
+        for (int bank = 1; bank < kRamBankCount; ++bank)
         {
-            return current_bank_;
+            if (other.ram_banks_[bank])
+            {
+                ram_banks_[bank] = std::make_unique<RamBank>(*other.ram_banks_[bank]);
+            }
         }
+        mapPages();
+    }
 
-        // Check if this is a PIA register read
-        if (pia_ && pia_->isPiaAddress(address))
+    Memory &Memory::operator=(const Memory &other)
+    {
+        if (this != &other)
         {
-            return pia_->readPia(address);
+            video_chip_ = other.video_chip_;
+            pia_ = other.pia_;
+            block_device_ = other.block_device_;
+            devices_ = other.devices_;
+            device_pages_ = other.device_pages_;
+            device_page_index_ = other.device_page_index_;
+            copyStateFrom(other);
         }
+        return *this;
+    }
 
-        // Check if this is a block-device register read ($FE24-$FE28)
-        if (block_device_ && BlockDevice::isBlockAddress(address))
+    void Memory::copyStateFrom(const Memory &other)
+    {
+        if (this == &other)
+        {
+            return;
+        }
+        // In place, so a VIC bound to this memory's screen stays bound.
+        std::copy(other.ram_.begin(), other.ram_.end(), ram_.begin());
+        banks_ = other.banks_;
+        current_bank_ = other.current_bank_;
+        dos_rom_ = other.dos_rom_;
+        for (int bank = 1; bank < kRamBankCount; ++bank)
         {
-            return block_device_->read(address);
+            if (!other.ram_banks_[bank])
+            {
+                ram_banks_[bank].reset();
+            }
+            else if (ram_banks_[bank])
+            {
+                *ram_banks_[bank] = *other.ram_banks_[bank];
+            }
+            else
+            {
+                ram_banks_[bank] = std::make_unique<RamBank>(*other.ram_banks_[bank]);
+            }
         }
+        ram_bank_ = other.ram_bank_;
+        ram_bank_dirty_ = other.ram_bank_dirty_;
+        ram_bank_generation_ = other.ram_bank_generation_;
+        page_generation_ = other.page_generation_;
+        clean_generation_ = other.clean_generation_;
+        clean_valid_ = other.clean_valid_;
+        rom_epoch_ = other.rom_epoch_;
+        side_effects_ = other.side_effects_;
+        mapPages();
+    }
+
+    Memory::~Memory()
+    {
+        setVideoChip(nullptr);
+    }
+
+    void Memory::attachDevice(BusDevice *device)
+    {
+        replaceDevice(nullptr, device);
+    }
 
-        // Check if this is a video memory read
-        if (video_chip_ && video_chip_->isScreenAddress(address))
+    void Memory::detachDevice(BusDevice *device)
+    {
+        replaceDevice(device, nullptr);
+    }
+
+    void Memory::replaceDevice(BusDevice *old_device, BusDevice *new_device)
+    {
+        if (old_device)
+        {
+            devices_.erase(std::remove(devices_.begin(), devices_.end(), old_device), devices_.end());
+        }
+        if (new_device)
         {
-            return video_chip_->readScreen(address);
+            devices_.push_back(new_device);
         }
+        mapDevices();
+    }
 
-        // DOS ROM: always-mapped read-only region. Falls through to RAM when no
-        // image is installed (the pre-DOS default).
-        if (!dos_rom_.empty() && address >= kDosRomStart && address <= kDosRomEnd)
+    BusDevice *Memory::deviceAt(const uint16_t address) const
+    {
+        const uint8_t slot = device_page_index_[address >> 8];
+        return slot ? device_pages_[slot - 1][address & 0xFF] : nullptr;
+    }
+
+    void Memory::mapDevices()
+    {
+        device_pages_.clear();
+        device_page_index_.fill(0);
+        for (BusDevice *device : devices_)
         {
-            return dos_rom_[address - kDosRomStart];
+            const BusRange range = device->busRange();
+            for (uint32_t address = range.first; address <= range.last; ++address)
+            {
+                uint8_t &slot = device_page_index_[address >> 8];
+                if (slot == 0)
+                {
+                    device_pages_.emplace_back();
+                    device_pages_.back().fill(nullptr);
+                    slot = static_cast<uint8_t>(device_pages_.size());
+                }
+                device_pages_[slot - 1][address & 0xFF] = device;
+            }
         }
+        mapPages();
+    }
 
-        // Module window: a non-zero bank maps a read-only ROM module here.
-        // Bank 0 falls through to RAM (the default/boot state).
-        if (current_bank_ != 0 && address >= kModuleWindowStart && address <= kModuleWindowEnd)
+    void Memory::mapPages()
+    {
+        for (int page = 0; page < 256; ++page)
         {
-            const std::vector<uint8_t> &image = bank_rom_[current_bank_];
-            // An empty (uninstalled) bank reads as open bus -> 0x00.
-            return image.empty() ? 0x00 : image[address - kModuleWindowStart];
+            code_pages_[page] = &ram_[page << 8];
+            store_pages_[page] = &ram_[page << 8];
+            device_io_pages_[page] = false;
         }
 
-        return ram_[address];
+        // DOS ROM: always-mapped read-only region. Stays RAM when no image is
+        // installed (the pre-DOS default).
+        if (!dos_rom_.empty())
+        {
+            for (int page = kDosRomFirstPage; page <= kDosRomLastPage; ++page)
+            {
+                code_pages_[page] = &dos_rom_[(page - kDosRomFirstPage) << 8];
+                store_pages_[page] = nullptr;
+            }
+        }
+
+        // Device registers: every page a device occupies, and the I/O page,
+        // which always holds MODULE_BANK and RAM_BANK.
+        for (int page = 0; page < 256; ++page)
+        {
+            if (device_page_index_[page] != 0 || page == kIoPage)
+            {
+                code_pages_[page] = nullptr;
+                store_pages_[page] = nullptr;
+                device_io_pages_[page] = true;
+            }
+        }
+
+        mapModuleWindow();
+        publishPages(0, 255);
     }
 
-    void Memory::write(const uint16_t address, const uint8_t value)
+    void Memory::mapModuleWindow()
     {
-        // MODULE_BANK select register: map a bank into the module window
-        if (address == kModuleBankRegister)
+        // Bank 0 is RAM (RAM_BANK picks which); a non-zero bank maps its
+        // read-only ROM module, and an empty bank reads as open bus. An
+        // expansion RAM bank with no storage yet reads as zeros too, and its
+        // first store allocates it (see writeIo()).
+        const uint8_t *image = current_bank_ != 0 ? banks_->bank(current_bank_) : nullptr;
+        const int ram_bank = mappedRamBank();
+        uint8_t *const expansion = ram_bank != 0 && ram_banks_[ram_bank] ? ram_banks_[ram_bank]->data() : nullptr;
+        for (int page = kModuleWindowFirstPage; page <= kModuleWindowLastPage; ++page)
+        {
+            const size_t offset = static_cast<size_t>(page - kModuleWindowFirstPage) << 8;
+            if (device_io_pages_[page])
+            {
+                continue;   // a device mapped over the window wins
+            }
+            if (current_bank_ == 0 && ram_bank == 0)
+            {
+                code_pages_[page] = &ram_[page << 8];
+                store_pages_[page] = &ram_[page << 8];
+            }
+            else if (current_bank_ == 0)
+            {
+                code_pages_[page] = expansion ? expansion + offset : kOpenBusPage.data();
+                store_pages_[page] = expansion ? expansion + offset : nullptr;
+            }
+            else
+            {
+                code_pages_[page] = image ? image + offset : kOpenBusPage.data();
+                store_pages_[page] = nullptr;
+            }
+        }
+        publishPages(kModuleWindowFirstPage, kModuleWindowLastPage);
+    }
+
+    void Memory::publishPages(const int first, const int last)
+    {
+        const bool lazy_window = windowIsUnallocatedRam();
+        for (int page = first; page <= last; ++page)
+        {
+            const uint8_t watched = watch_pages_[page];
+            const bool lazy = lazy_window && page >= kModuleWindowFirstPage && page <= kModuleWindowLastPage;
+            read_pages_[page] = (watched & kWatchRead) ? nullptr : code_pages_[page];
+            write_pages_[page] = (watched & kWatchWrite) ? nullptr : store_pages_[page];
+            io_pages_[page] = device_io_pages_[page] || (watched & kWatchWrite) || lazy;
+        }
+    }
+
+    int Memory::mappedRamBank() const
+    {
+        return current_bank_ == 0 ? ram_bank_ % kRamBankCount : 0;
+    }
+
+    bool Memory::windowIsUnallocatedRam() const
+    {
+        const int bank = mappedRamBank();
+        return bank != 0 && !ram_banks_[bank];
+    }
+
+    void Memory::noteRamBankWrites()
+    {
+        // Only stores reach an expansion bank, and they all go through the
+        // window, so its page generations tell whether the bank changed.
+        const int bank = ram_bank_ % kRamBankCount;
+        if (bank == 0)
         {
-            current_bank_ = value;
             return;
         }
+        for (size_t i = 0; i < ram_bank_generation_.size(); ++i)
+        {
+            if (page_generation_[kModuleWindowFirstPage + i] != ram_bank_generation_[i])
+            {
+                ram_bank_dirty_.set(bank);
+                return;
+            }
+        }
+    }
+
+    void Memory::mapRamBankStart()
+    {
+        std::copy_n(page_generation_.begin() + kModuleWindowFirstPage, ram_bank_generation_.size(),
+                    ram_bank_generation_.begin());
+    }
 
-        // Check if this is a PIA register write
-        if (pia_ && pia_->isPiaAddress(address))
+    void Memory::bumpWindowGenerations()
+    {
+        for (int page = kModuleWindowFirstPage; page <= kModuleWindowLastPage; ++page)
+        {
+            const bool clean = clean_valid_ && clean_generation_[page] == page_generation_[page];
+            ++page_generation_[page];
+            if (clean)
+            {
+                clean_generation_[page] = page_generation_[page];
+            }
+        }
+    }
+
+    void Memory::switchWindow(const uint8_t bank, const uint8_t ram_bank)
+    {
+        if (bank == current_bank_ && ram_bank == ram_bank_)
         {
-            pia_->writePia(address, value);
             return;
         }
+        const bool ram_changed = (ram_bank % kRamBankCount) != (ram_bank_ % kRamBankCount);
+        if (ram_changed)
+        {
+            noteRamBankWrites();
+        }
+        current_bank_ = bank;
+        ram_bank_ = ram_bank;
+        if (ram_changed)
+        {
+            // Different RAM under the same addresses: code decoded from the
+            // old bank must not be reused.
+            bumpWindowGenerations();
+            mapRamBankStart();
+        }
+        mapModuleWindow();
+        ++side_effects_;
+    }
 
-        // Check if this is a block-device register write ($FE24-$FE28)
-        if (block_device_ && BlockDevice::isBlockAddress(address))
+    void Memory::noteWatch(const WatchKind kind, const uint16_t address, const uint8_t value) const
+    {
+        if (watch_flags_[address] & kind)
+        {
+            watch_log_.push_back({kind, address, value});
+        }
+    }
+
+    void Memory::watch(const uint16_t address, const uint8_t kinds)
+    {
+        if (watch_flags_.empty())
+        {
+            watch_flags_.assign(0x10000, 0);
+        }
+        uint8_t &flags = watch_flags_[address];
+        if (flags == 0 && kinds != 0)
+        {
+            ++watched_addresses_;
+        }
+        flags |= kinds;
+        watch_pages_[address >> 8] |= kinds;
+        publishPages(address >> 8, address >> 8);
+    }
+
+    void Memory::unwatch(const uint16_t address, const uint8_t kinds)
+    {
+        if (watch_flags_.empty() || watch_flags_[address] == 0)
         {
-            block_device_->write(address, value);
             return;
         }
+        uint8_t &flags = watch_flags_[address];
+        flags &= static_cast<uint8_t>(~kinds);
+        if (flags == 0)
+        {
+            --watched_addresses_;
+        }
 
-        // Check if this is a video memory write
-        if (video_chip_ && video_chip_->isScreenAddress(address))
+        const int page = address >> 8;
+        watch_pages_[page] = 0;
+        for (int offset = 0; offset < 0x100; ++offset)
         {
-            video_chip_->writeScreen(address, value);
+            watch_pages_[page] |= watch_flags_[(page << 8) | offset];
+        }
+        publishPages(page, page);
+    }
+
+    void Memory::clearWatches()
+    {
+        watch_flags_.clear();
+        watch_pages_.fill(0);
+        watched_addresses_ = 0;
+        watch_log_.clear();
+        publishPages(0, 255);
+    }
+
+    uint8_t Memory::readIo(const uint16_t address) const
+    {
+        // A watched RAM/ROM page: the access itself is an ordinary read.
+        if (const uint8_t *bytes = code_pages_[address >> 8])
+        {
+            const uint8_t value = bytes[address & 0xFF];
+            noteWatch(kWatchRead, address, value);
+            return value;
+        }
+
+        const uint8_t value = readDevice(address);
+        if (watch_pages_[address >> 8] & kWatchRead)
+        {
+            noteWatch(kWatchRead, address, value);
+        }
+        return value;
+    }
+
+    uint8_t Memory::readDevice(const uint16_t address) const
+    {
+        // MODULE_BANK select register reads back the current bank
+        if (address == kModuleBankRegister)
+        {
+            return current_bank_;
+        }
+        if (address == kRamBankRegister)
+        {
+            return ram_bank_;
+        }
+
+        if (BusDevice *device = deviceAt(address))
+        {
+            if (device->readHasSideEffects(address))
+            {
+                ++side_effects_;
+            }
+            return device->busRead(address);
+        }
+
+        // The rest of an I/O page is RAM.
+        return ram_[address];
+    }
+
+    void Memory::writeIo(const uint16_t address, const uint8_t value)
+    {
+        if (watch_pages_[address >> 8] & kWatchWrite)
+        {
+            noteWatch(kWatchWrite, address, value);
+        }
+
+        // First store to an expansion RAM bank: give it zeroed storage.
+        if (!store_pages_[address >> 8] && !device_io_pages_[address >> 8] && windowIsUnallocatedRam() &&
+            address >= kModuleWindowStart && address <= kModuleWindowEnd)
+        {
+            const int bank = mappedRamBank();
+            ram_banks_[bank] = std::make_unique<RamBank>();
+            ram_bank_dirty_.set(bank);
+            mapModuleWindow();
+        }
+
+        // A watched RAM page: the access itself is an ordinary store.
+        if (uint8_t *bytes = store_pages_[address >> 8])
+        {
+            uint8_t &cell = bytes[address & 0xFF];
+            if (cell != value)
+            {
+                cell = value;
+                ++page_generation_[address >> 8];
+                ++side_effects_;
+            }
             return;
         }
+        if (!device_io_pages_[address >> 8])
+        {
+            return;   // ROM
+        }
 
-        // DOS ROM is read-only: ignore writes when an image is installed.
-        if (!dos_rom_.empty() && address >= kDosRomStart && address <= kDosRomEnd)
+        // MODULE_BANK select register: map a bank into the module window
+        if (address == kModuleBankRegister)
+        {
+            switchWindow(value, ram_bank_);
+            return;
+        }
+
+        // RAM_BANK select register: pick the RAM behind the window
+        if (address == kRamBankRegister)
         {
+            switchWindow(current_bank_, value);
             return;
         }
 
-        // Module window backed by ROM (non-zero bank): writes are ignored.
-        // Bank 0 falls through to RAM.
-        if (current_bank_ != 0 && address >= kModuleWindowStart && address <= kModuleWindowEnd)
+        if (BusDevice *device = deviceAt(address))
         {
+            ++side_effects_;
+            device->busWrite(address, value);
             return;
         }
 
-        ram_[address] = value;
+        // The rest of an I/O page is RAM.
+        if (ram_[address] != value)
+        {
+            ram_[address] = value;
+            ++page_generation_[address >> 8];
+            ++side_effects_;
+        }
     }
 
     uint16_t Memory::readWord(const uint16_t address) const
@@ -115,28 +490,203 @@ namespace Computer
     {
         ram_[address] = value & 0xFF;
         ram_[address + 1] = (value >> 8) & 0xFF;
+        ++page_generation_[address >> 8];
+        ++page_generation_[static_cast<uint16_t>(address + 1) >> 8];
+        ++side_effects_;
+    }
+
+    void Memory::readBlock(uint16_t address, std::span<uint8_t> out) const
+    {
+        out = out.first(std::min<size_t>(out.size(), ram_.size()));
+        while (!out.empty())
+        {
+            const uint8_t page = address >> 8;
+            const size_t n = std::min<size_t>(out.size(), 0x100 - (address & 0xFF));
+            if (const uint8_t *bytes = read_pages_[page])
+            {
+                std::memcpy(out.data(), bytes + (address & 0xFF), n);
+            }
+            else
+            {
+                for (size_t i = 0; i < n; ++i)
+                {
+                    out[i] = readIo(static_cast<uint16_t>(address + i));
+                }
+            }
+            out = out.subspan(n);
+            address = static_cast<uint16_t>(address + n);
+        }
+    }
+
+    void Memory::writeBlock(uint16_t address, std::span<const uint8_t> data)
+    {
+        data = data.first(std::min<size_t>(data.size(), ram_.size()));
+        while (!data.empty())
+        {
+            const uint8_t page = address >> 8;
+            const size_t n = std::min<size_t>(data.size(), 0x100 - (address & 0xFF));
+            if (uint8_t *bytes = write_pages_[page])
+            {
+                // As in write(): rewriting what is there is not a change.
+                uint8_t *const target = bytes + (address & 0xFF);
+                if (std::memcmp(target, data.data(), n) != 0)
+                {
+                    std::memcpy(target, data.data(), n);
+                    ++page_generation_[page];
+                    ++side_effects_;
+                }
+            }
+            else if (io_pages_[page])
+            {
+                for (size_t i = 0; i < n; ++i)
+                {
+                    write(static_cast<uint16_t>(address + i), data[i]);
+                }
+            }
+            // Otherwise ROM: the segment is skipped.
+            data = data.subspan(n);
+            address = static_cast<uint16_t>(address + n);
+        }
+    }
+
+    std::bitset<256> Memory::dirtyPages() const
+    {
+        std::bitset<256> dirty;
+        for (size_t page = 0; page < dirty.size(); ++page)
+        {
+            dirty[page] = !clean_valid_ || page_generation_[page] != clean_generation_[page];
+        }
+        return dirty;
+    }
+
+    MemoryDelta Memory::checkpoint()
+    {
+        MemoryDelta delta;
+        delta.bank = current_bank_;
+        delta.ram_bank = ram_bank_;
+        const std::bitset<256> dirty = dirtyPages();
+        delta.pages.reserve(dirty.count());
+        delta.data.reserve(dirty.count() * MemoryDelta::kPageSize);
+        for (size_t page = 0; page < dirty.size(); ++page)
+        {
+            if (dirty[page])
+            {
+                const auto first = ram_.begin() + static_cast<ptrdiff_t>(page * MemoryDelta::kPageSize);
+                delta.pages.push_back(static_cast<uint8_t>(page));
+                delta.data.insert(delta.data.end(), first, first + MemoryDelta::kPageSize);
+            }
+        }
+
+        noteRamBankWrites();
+        for (int bank = 1; bank < kRamBankCount; ++bank)
+        {
+            if (ram_banks_[bank] && (!clean_valid_ || ram_bank_dirty_[bank]))
+            {
+                delta.ram_banks.push_back(static_cast<uint8_t>(bank));
+                delta.ram_bank_data.insert(delta.ram_bank_data.end(), ram_banks_[bank]->begin(),
+                                           ram_banks_[bank]->end());
+            }
+        }
+        clearDirtyPages();
+        return delta;
+    }
+
+    void Memory::clearDirtyPages()
+    {
+        clean_generation_ = page_generation_;
+        clean_valid_ = true;
+        ram_bank_dirty_.reset();
+        mapRamBankStart();
+    }
+
+    void Memory::applyDelta(const MemoryDelta &delta)
+    {
+        // Stores since the last note belong to the bank mapped now; what
+        // follows is not a local change.
+        noteRamBankWrites();
+        for (size_t i = 0; i < delta.pages.size() && (i + 1) * MemoryDelta::kPageSize <= delta.data.size(); ++i)
+        {
+            const uint8_t page = delta.pages[i];
+            std::copy_n(delta.data.begin() + static_cast<ptrdiff_t>(i * MemoryDelta::kPageSize),
+                        MemoryDelta::kPageSize, ram_.begin() + page * MemoryDelta::kPageSize);
+
+            // New contents for the block cache, but not a local change.
+            const bool clean = clean_valid_ && clean_generation_[page] == page_generation_[page];
+            ++page_generation_[page];
+            if (clean)
+            {
+                clean_generation_[page] = page_generation_[page];
+            }
+        }
+
+        bool mapped_changed = false;
+        for (size_t i = 0; i < delta.ram_banks.size() && (i + 1) * kModuleWindowSize <= delta.ram_bank_data.size(); ++i)
+        {
+            const uint8_t bank = delta.ram_banks[i] % kRamBankCount;
+            if (bank == 0)
+            {
+                continue;
+            }
+            if (!ram_banks_[bank])
+            {
+                ram_banks_[bank] = std::make_unique<RamBank>();
+            }
+            std::copy_n(delta.ram_bank_data.begin() + static_cast<ptrdiff_t>(i * kModuleWindowSize),
+                        kModuleWindowSize, ram_banks_[bank]->begin());
+            mapped_changed = mapped_changed || bank == ram_bank_ % kRamBankCount;
+        }
+        if (mapped_changed)
+        {
+            bumpWindowGenerations();
+        }
+        mapRamBankStart();
+        ++side_effects_;
+        switchWindow(delta.bank, delta.ram_bank);
+        mapModuleWindow();
     }
 
     void Memory::loadProgram(const std::vector<uint8_t> &program, uint16_t start_address)
     {
-        for (size_t i = 0; i < program.size(); ++i)
+        // Host-side install: goes to the RAM underneath ROM and I/O too.
+        const size_t n = std::min(program.size(), ram_.size() - start_address);
+        std::copy_n(program.begin(), n, ram_.begin() + start_address);
+        for (size_t at = start_address; at < start_address + n; at = (at | 0xFF) + 1)
         {
-            ram_[start_address + i] = program[i];
+            ++page_generation_[at >> 8];
         }
+        ++side_effects_;
     }
 
     void Memory::setVideoChip(VIC *video_chip)
     {
+        // Screen memory is ordinary RAM that the VIC displays from. A copy
+        // shares the VIC without owning its screen, so only unbind our own.
+        uint8_t *const screen = &ram_[VIC::kScreenMemoryStart];
+        if (video_chip_ && video_chip_ != video_chip && video_chip_->getScreenBuffer().data() == screen)
+        {
+            video_chip_->bindScreen(nullptr, nullptr);
+        }
         video_chip_ = video_chip;
+        if (video_chip_)
+        {
+            video_chip_->bindScreen(screen, this);
+            for (int page = VIC::kScreenMemoryStart >> 8; page <= VIC::kScreenMemoryEnd >> 8; ++page)
+            {
+                ++page_generation_[page];
+            }
+            ++side_effects_;
+        }
     }
 
     void Memory::setPia(PIA *pia)
     {
+        replaceDevice(pia_, pia);
         pia_ = pia;
     }
 
     void Memory::setBlockDevice(BlockDevice *block_device)
     {
+        replaceDevice(block_device_, block_device);
         block_device_ = block_device;
     }
 
@@ -148,10 +698,38 @@ namespace Computer
             return;
         }
 
-        std::vector<uint8_t> &dst = bank_rom_[bank];
-        dst.assign(kModuleWindowSize, 0x00);
-        const size_t n = std::min(image.size(), kModuleWindowSize);
-        std::copy_n(image.begin(), n, dst.begin());
+        ownBanks().load(bank, image);
+        if (bank == current_bank_)
+        {
+            mapModuleWindow();
+        }
+        ++rom_epoch_;
+        ++side_effects_;
+    }
+
+    bool Memory::loadBankFile(const uint8_t bank, const std::string &path)
+    {
+        if (bank == 0 || !ownBanks().loadFile(bank, path))
+        {
+            return false;
+        }
+        if (bank == current_bank_)
+        {
+            mapModuleWindow();
+        }
+        ++rom_epoch_;
+        ++side_effects_;
+        return true;
+    }
+
+    BankArena &Memory::ownBanks()
+    {
+        if (banks_.use_count() > 1)
+        {
+            banks_ = std::make_shared<BankArena>(*banks_);
+            mapModuleWindow();
+        }
+        return *banks_;
     }
 
     void Memory::loadDosRom(const std::vector<uint8_t> &image)
@@ -159,11 +737,17 @@ namespace Computer
         if (image.empty())
         {
             dos_rom_.clear(); // leaves the region as RAM
+            mapPages();
+            ++rom_epoch_;
+            ++side_effects_;
             return;
         }
         dos_rom_.assign(kDosRomSize, 0x00);
         const size_t n = std::min(image.size(), kDosRomSize);
         std::copy_n(image.begin(), n, dos_rom_.begin());
+        mapPages();
+        ++rom_epoch_;
+        ++side_effects_;
     }
 
     bool Memory::isDosRomLoaded() const
@@ -174,15 +758,42 @@ namespace Computer
     void Memory::selectBank(uint8_t bank)
     {
         current_bank_ = bank;
+        mapModuleWindow();
+        ++side_effects_;
+    }
+
+    void Memory::selectRamBank(const uint8_t bank)
+    {
+        switchWindow(current_bank_, bank);
     }
 
-    uint8_t Memory::currentBank() const
+    bool Memory::isRamBankAllocated(const uint8_t bank) const
     {
-        return current_bank_;
+        return bank != 0 && bank < kRamBankCount && ram_banks_[bank] != nullptr;
     }
 
     bool Memory::isBankLoaded(uint8_t bank) const
     {
-        return bank != 0 && !bank_rom_[bank].empty();
+        return bank != 0 && banks_->isLoaded(bank);
+    }
+
+    bool Memory::isCodeCacheable(const uint16_t address) const
+    {
+        // Mirrors the I/O checks in readIo(): anything that is not served
+        // straight from ram_ or a ROM image.
+        if (!device_io_pages_[address >> 8])
+        {
+            return true;
+        }
+        return address != kModuleBankRegister && address != kRamBankRegister && !deviceAt(address);
+    }
+
+    bool Memory::isRomAddress(const uint16_t address) const
+    {
+        if (!dos_rom_.empty() && address >= kDosRomStart && address <= kDosRomEnd)
+        {
+            return true;
+        }
+        return current_bank_ != 0 && address >= kModuleWindowStart && address <= kModuleWindowEnd;
     }
 } // namespace Computer
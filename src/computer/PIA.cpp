@@ -7,7 +7,9 @@
 #include <QFileDialog>
 #include <QCoreApplication>
 #endif
+#include <algorithm>
 #include <fstream>
+#include <span>
 #include <vector>
 
 // Verbose PIA debug logging (keystrokes, file/stream operations). Set
@@ -84,11 +86,19 @@ void PIA::writePia(const uint16_t address, const uint8_t value)
             PIA_LOG("PIA: Received file command: 0x%02X\n", value);
             file_command_ = value;
             // Block transfers and stream OPENs need a host action (and a file
-            // dialog); mark IN_PROGRESS so processFileOperations() picks them up.
+            // dialog); mark IN_PROGRESS and ring the doorbell so the run loop
+            // calls processFileOperations() at its next batch boundary.
             if (value == kFileLoadCommand || value == kFileSaveCommand ||
                 value == kFileOpenReadCommand || value == kFileOpenWriteCommand) {
                 PIA_LOG("PIA: Setting file status to IN_PROGRESS\n");
                 file_status_ = kFileInProgress;
+                if (file_doorbell_) {
+                    file_doorbell_();
+                } else if (cpu_) {
+                    // No doorbell: end the CPU's batch so a polling host
+                    // services it promptly.
+                    cpu_->raiseAttention();
+                }
             } else if (value == kFileCloseCommand) {
                 closeStream();  // handled inline (flushes a write stream)
             }
@@ -120,6 +130,19 @@ void PIA::writePia(const uint16_t address, const uint8_t value)
     }
 }
 
+bool PIA::readHasSideEffects(const uint16_t address) const
+{
+    switch (addressToOffset(address))
+    {
+        case kPortAData:
+            return hasKeypress();
+        case kFileData:
+            return stream_mode_ == kStreamRead && stream_pos_ < stream_buffer_.size();
+        default:
+            return false;
+    }
+}
+
 uint8_t PIA::readPia(const uint16_t address)
 {
     if (!isPiaAddress(address))
@@ -394,13 +417,9 @@ void PIA::processFileOperations()
             return;
         }
         
-        // Load file data into emulated memory
-        uint16_t current_address = file_address_;
-
-        for (uint8_t byte : buffer) {
-            if (current_address > 0xFFFF) break;
-            memory_->write(current_address++, byte);
-        }
+        // Load file data into emulated memory, stopping at the top of memory
+        const size_t room = 0x10000 - file_address_;
+        memory_->writeBlock(file_address_, std::span<const uint8_t>(buffer).first(std::min(buffer.size(), room)));
 
         PIA_LOG("PIA: File loaded successfully at $%04X\n", file_address_);
         
@@ -462,12 +481,8 @@ void PIA::processFileOperations()
         }
         
         // Read memory and write to file
-        std::vector<uint8_t> buffer;
-        buffer.reserve(bytes_to_save);
-        
-        for (uint16_t addr = file_address_; addr <= file_end_address_; ++addr) {
-            buffer.push_back(memory_->read(addr));
-        }
+        std::vector<uint8_t> buffer(bytes_to_save);
+        memory_->readBlock(file_address_, buffer);
         
         if (!file.write(reinterpret_cast<const char*>(buffer.data()), static_cast<std::streamsize>(buffer.size()))) {
             PIA_LOG("PIA: File save error - Failed to write file data\n");
@@ -0,0 +1,153 @@
+#include "RomTranslation.h"
+
+#include <algorithm>
+
+namespace Computer
+{
+    namespace
+    {
+        std::vector<const RomTranslation *> &registry()
+        {
+            static std::vector<const RomTranslation *> translations;
+            return translations;
+        }
+
+        bool inModuleWindow(const uint16_t address)
+        {
+            return address >= Memory::kModuleWindowStart && address <= Memory::kModuleWindowEnd;
+        }
+    } // namespace
+
+    bool RomTranslations::registerBuiltin(const RomTranslation &translation)
+    {
+        registry().push_back(&translation);
+        return true;
+    }
+
+    const std::vector<const RomTranslation *> &RomTranslations::builtin()
+    {
+        return registry();
+    }
+
+    RomTranslations::RomTranslations() : fixed_(0x10000)
+    {
+    }
+
+    void RomTranslations::add(const RomTranslation &translation)
+    {
+        if (std::find(translations_.begin(), translations_.end(), &translation) != translations_.end())
+        {
+            return;
+        }
+        translations_.push_back(&translation);
+    }
+
+    bool RomTranslations::matches(const Memory &mem, const uint16_t pc, const uint8_t *bytes, const uint16_t length)
+    {
+        // Never read I/O registers: the I/O page sits inside the kernel image.
+        for (uint16_t i = 0; i < length; ++i)
+        {
+            const uint16_t address = static_cast<uint16_t>(pc + i);
+            if (!mem.isCodeCacheable(address) || mem.read(address) != bytes[i])
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    size_t RomTranslations::bind(Memory &mem)
+    {
+        fixed_.assign(0x10000, Slot{});
+        for (auto &bank : banked_)
+        {
+            bank.clear();
+        }
+        bound_count_ = 0;
+
+        const uint8_t selected = mem.currentBank();
+        for (const RomTranslation *translation : translations_)
+        {
+            if (translation->bank > 0)
+            {
+                mem.selectBank(static_cast<uint8_t>(translation->bank));
+            }
+            for (size_t i = 0; i < translation->block_count; ++i)
+            {
+                const RomTranslation::Block &block = translation->blocks[i];
+                const uint8_t *bytes = translation->image + (block.pc - translation->base);
+                if (!matches(mem, block.pc, bytes, block.length))
+                {
+                    continue;
+                }
+
+                if (translation->bank > 0)
+                {
+                    std::vector<TranslatedBlock> &window = banked_[translation->bank];
+                    if (!inModuleWindow(block.pc))
+                    {
+                        continue;
+                    }
+                    window.resize(Memory::kModuleWindowSize);
+                    window[block.pc - Memory::kModuleWindowStart] = block.code;
+                }
+                else
+                {
+                    if (inModuleWindow(block.pc))
+                    {
+                        continue; // the window is banked; only banked images bind there
+                    }
+                    fixed_[block.pc] = Slot{block.code, bytes, block.length,
+                                            mem.pageGeneration(block.pc >> 8), mem.isRomAddress(block.pc)};
+                }
+                ++bound_count_;
+            }
+        }
+        mem.selectBank(selected);
+        epoch_ = mem.romEpoch();
+        return bound_count_;
+    }
+
+    TranslatedBlock RomTranslations::find(const Memory &mem, const uint16_t pc, AotFrame &frame)
+    {
+        if (mem.romEpoch() != epoch_)
+        {
+            return nullptr; // ROM images replaced since bind()
+        }
+
+        frame.page = pc >> 8;
+        if (inModuleWindow(pc))
+        {
+            const std::vector<TranslatedBlock> &window = banked_[mem.currentBank()];
+            if (window.empty())
+            {
+                return nullptr;
+            }
+            frame.rom = true;
+            frame.bank = mem.currentBank();
+            return window[pc - Memory::kModuleWindowStart];
+        }
+
+        Slot &slot = fixed_[pc];
+        if (!slot.code)
+        {
+            return nullptr;
+        }
+        if (!slot.rom && mem.pageGeneration(frame.page) != slot.generation)
+        {
+            // The page was written since the block was verified; it may have
+            // been data next to the code. Check the block's own bytes again and
+            // retire the translation if the code itself changed.
+            if (!matches(mem, pc, slot.bytes, slot.length))
+            {
+                slot.code = nullptr;
+                return nullptr;
+            }
+            slot.generation = mem.pageGeneration(frame.page);
+        }
+        frame.rom = slot.rom;
+        frame.bank = -1;
+        frame.generation = slot.generation;
+        return slot.code;
+    }
+} // namespace Computer
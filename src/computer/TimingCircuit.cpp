@@ -1,31 +1,91 @@
 #include "TimingCircuit.h"
-#include <chrono>
+#include <algorithm>
 #include <thread>
 
 namespace Computer
 {
-    TimingCircuit::TimingCircuit() : clock_frequency_(1000000), actual_cycle_time_(0)
+    TimingCircuit::TimingCircuit() : clock_frequency_(kSupportedFrequencies[0])
     {
-        cycle_time_ns_ = 1000000000 / clock_frequency_;
+        restart();
     }
 
-    void TimingCircuit::waitForCycle()
+    void TimingCircuit::setTargetFrequency(const uint32_t hz)
     {
-        const auto start = std::chrono::high_resolution_clock::now();
-        std::this_thread::sleep_for(std::chrono::nanoseconds(cycle_time_ns_));
-        const auto end = std::chrono::high_resolution_clock::now();
+        clock_frequency_ = hz;
+        restart();
+        actual_frequency_ = 0.0;
+    }
 
-        actual_cycle_time_ = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+    uint32_t TimingCircuit::getTargetFrequency() const
+    {
+        return clock_frequency_;
     }
 
-    double TimingCircuit::getActualFrequency() const
+    uint64_t TimingCircuit::sliceCycles() const
     {
-        if (actual_cycle_time_ == 0) return 0.0;
-        return 1000000000.0 / static_cast<double>(actual_cycle_time_);
+        if (isUnthrottled())
+        {
+            return kUnthrottledSliceCycles;
+        }
+        // Below 1 kHz a slice is under one cycle; run one so the slice
+        // still makes progress and pace() stretches the wait instead.
+        return std::max<uint64_t>(1, static_cast<uint64_t>(clock_frequency_) * kSlice.count() / 1000000);
     }
 
-    uint32_t TimingCircuit::getTargetFrequency() const
+    void TimingCircuit::restart()
     {
-        return clock_frequency_;
+        // The pause itself is neither paced nor measured.
+        origin_ = Clock::now();
+        paced_cycles_ = 0;
+        measure_start_ = origin_;
+        measure_cycles_ = 0;
+    }
+
+    void TimingCircuit::pace(const uint64_t cycles)
+    {
+        paced_cycles_ += cycles;
+        measure_cycles_ += cycles;
+
+        Clock::time_point now = Clock::now();
+        if (!isUnthrottled())
+        {
+            // Deadline from the total since the origin, not from the last
+            // slice: an oversleep here shortens the next wait.
+            const auto emulated = std::chrono::nanoseconds(
+                static_cast<int64_t>(paced_cycles_ * 1000000000.0 / clock_frequency_));
+            const Clock::time_point deadline = origin_ + emulated;
+
+            if (now - deadline > kMaxLag)
+            {
+                // Too far behind to catch up smoothly: carry on from here.
+                origin_ = now;
+                paced_cycles_ = 0;
+            }
+            else if (deadline > now)
+            {
+                if (deadline - now > kSpinThreshold)
+                {
+                    std::this_thread::sleep_until(deadline - kSpinThreshold);
+                }
+                while ((now = Clock::now()) < deadline)
+                {
+                    std::this_thread::yield();
+                }
+            }
+        }
+
+        const auto window = now - measure_start_;
+        if (window >= kMeasureWindow)
+        {
+            actual_frequency_ = static_cast<double>(measure_cycles_) /
+                                std::chrono::duration<double>(window).count();
+            measure_start_ = now;
+            measure_cycles_ = 0;
+        }
+    }
+
+    double TimingCircuit::getActualFrequency() const
+    {
+        return actual_frequency_;
     }
 } // namespace Computer
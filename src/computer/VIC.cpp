@@ -1,4 +1,7 @@
 #include "VIC.h"
+#include "Memory.h"
+#include <algorithm>
+#include <cstring>
 #include <iostream>
 #include <cstdio>
 
@@ -12,11 +15,32 @@
 
 namespace Computer
 {
-    VIC::VIC() : cursor_x_(0), cursor_y_(0), dirty_flag_(false)
+    VIC::VIC() : cursor_x_(0), cursor_y_(0)
     {
         clearScreen();
     }
 
+    void VIC::copyStateFrom(const VIC &other)
+    {
+        store(0, other.screen_buffer_);
+        shown_ = other.shown_;
+        shown_valid_ = other.shown_valid_;
+        cursor_x_ = other.cursor_x_;
+        cursor_y_ = other.cursor_y_;
+    }
+
+    void VIC::bindScreen(uint8_t *backing, Memory *memory)
+    {
+        memory_ = backing ? memory : nullptr;
+        const std::span<uint8_t, kScreenSize> next = backing ? std::span<uint8_t, kScreenSize>(backing, kScreenSize)
+                                                             : std::span<uint8_t, kScreenSize>(own_screen_);
+        if (next.data() != screen_buffer_.data())
+        {
+            std::copy(screen_buffer_.begin(), screen_buffer_.end(), next.begin());
+            screen_buffer_ = next;
+        }
+    }
+
     bool VIC::isScreenAddress(const uint16_t address) const
     {
         return address >= kScreenMemoryStart && address <= kScreenMemoryEnd;
@@ -38,8 +62,7 @@ namespace Computer
                 VIC_LOG("VIC: Writing '%c' (0x%02X) to screen offset %d (addr $%04X)\n",
                         (value >= 32 && value <= 126) ? value : '?', value, offset, address);
             }
-            screen_buffer_[offset] = value;
-            dirty_flag_ = true;
+            store(offset, std::span<const uint8_t>(&value, 1));
         }
     }
 
@@ -60,7 +83,7 @@ namespace Computer
         return 0x00;
     }
 
-    const std::array<uint8_t, VIC::kScreenSize> &VIC::getScreenBuffer() const
+    std::span<const uint8_t, VIC::kScreenSize> VIC::getScreenBuffer() const
     {
         return screen_buffer_;
     }
@@ -84,39 +107,26 @@ namespace Computer
         }
 
         const uint16_t offset = coordinatesToOffset(x, y);
-        screen_buffer_[offset] = character;
-        dirty_flag_ = true;
+        store(offset, std::span<const uint8_t>(&character, 1));
     }
 
     void VIC::clearScreen(const uint8_t fill_char)
     {
-        screen_buffer_.fill(fill_char);
+        std::array<uint8_t, kScreenSize> blank;
+        blank.fill(fill_char);
+        store(0, blank);
         cursor_x_ = 0;
         cursor_y_ = 0;
-        dirty_flag_ = true;
     }
 
     void VIC::scrollUp()
     {
-        // Move all lines up by one
-        for (uint16_t y = 0; y < kScreenHeight - 1; ++y)
-        {
-            for (uint16_t x = 0; x < kScreenWidth; ++x)
-            {
-                const uint16_t current_offset = coordinatesToOffset(x, y);
-                const uint16_t next_line_offset = coordinatesToOffset(x, y + 1);
-                screen_buffer_[current_offset] = screen_buffer_[next_line_offset];
-            }
-        }
-
-        // Clear the bottom line
-        for (uint16_t x = 0; x < kScreenWidth; ++x)
-        {
-            const uint16_t bottom_offset = coordinatesToOffset(x, kScreenHeight - 1);
-            screen_buffer_[bottom_offset] = 0x20; // Space character
-        }
-
-        dirty_flag_ = true;
+        // Move all lines up by one and clear the bottom line
+        std::array<uint8_t, kScreenSize> scrolled;
+        const uint16_t bottom_offset = coordinatesToOffset(0, kScreenHeight - 1);
+        std::copy(screen_buffer_.begin() + kScreenWidth, screen_buffer_.end(), scrolled.begin());
+        std::fill(scrolled.begin() + bottom_offset, scrolled.end(), 0x20); // Space character
+        store(0, scrolled);
     }
 
     void VIC::setCursorPosition(const uint16_t x, const uint16_t y)
@@ -136,12 +146,46 @@ namespace Computer
 
     bool VIC::isDirty() const
     {
-        return dirty_flag_;
+        return dirtyRows() != 0;
+    }
+
+    uint32_t VIC::dirtyRows() const
+    {
+        if (!shown_valid_)
+        {
+            return kAllRows;
+        }
+        // Screen stores are plain RAM writes, so compare with what was shown.
+        uint32_t rows = 0;
+        for (uint16_t y = 0; y < kScreenHeight; ++y)
+        {
+            const uint16_t offset = coordinatesToOffset(0, y);
+            if (std::memcmp(&screen_buffer_[offset], &shown_[offset], kScreenWidth) != 0)
+            {
+                rows |= 1u << y;
+            }
+        }
+        return rows;
     }
 
     void VIC::clearDirty()
     {
-        dirty_flag_ = false;
+        std::copy(screen_buffer_.begin(), screen_buffer_.end(), shown_.begin());
+        shown_valid_ = true;
+    }
+
+    void VIC::store(const uint16_t offset, const std::span<const uint8_t> bytes)
+    {
+        // Through Memory when bound, so the screen pages' generations move
+        // and cached code or a checkpoint sees the edit.
+        if (memory_)
+        {
+            memory_->writeBlock(kScreenMemoryStart + offset, bytes);
+        }
+        else
+        {
+            std::copy(bytes.begin(), bytes.end(), screen_buffer_.begin() + offset);
+        }
     }
 
     uint16_t VIC::addressToOffset(const uint16_t address) const
@@ -324,6 +324,7 @@ FILE_END_ADDR_HI   = $FE21         ; End address high byte for save range
 ; the current bank. Lives in the always-mapped I/O page (see module_slot_design.md).
 MODULE_BANK        = $FE23         ; bank-select register for the $B000-$DFFF window
 MODULE_BANK_RAM    = $00           ; bank value that maps the window to RAM
+RAM_BANK           = $FE29         ; RAM bank behind the window while MODULE_BANK = 0 (0..15)
 MODULE_WINDOW_START = $B000        ; base of the bankable module window
 MODULE_WINDOW_END  = $DFFF         ; last byte of the bankable module window
 
@@ -47,7 +47,7 @@ int main() {
     
     // Display the VIC screen buffer to show what was written to screen memory
     std::cout << "\n=== VIC SCREEN BUFFER CONTENTS ===\n";
-    auto& screen_buffer = computer.getVideoChip()->getScreenBuffer();
+    const auto screen_buffer = computer.getVideoChip()->getScreenBuffer();
     
     // Display only first few lines to see if welcome message appeared
     for (int line = 0; line < 10; ++line) {
@@ -4,12 +4,14 @@
 #include <QResizeEvent>
 #include <QKeyEvent>
 #include <QFocusEvent>
+#include <algorithm>
 #include <cstdio>
 
-DisplayWidget::DisplayWidget(Computer::VIC* video_chip, Computer::Memory* memory, QWidget* parent)
+DisplayWidget::DisplayWidget(const Computer::EmulationThread* emulation, QWidget* parent)
     : QWidget(parent)
-    , video_chip_(video_chip)
-    , memory_(memory)
+    , emulation_(emulation)
+    , frame_()
+    , frame_version_(0)
     , refresh_timer_(new QTimer(this))
     , background_color_(Qt::black)
     , foreground_color_(Qt::green)
@@ -20,10 +22,17 @@ DisplayWidget::DisplayWidget(Computer::VIC* video_chip, Computer::Memory* memory
     , has_focus_(false)
     , show_cursor_(false)
     , cursor_timer_(new QTimer(this))
+    , cursor_cell_(-1)
 {
     setupFont();
     calculateCharacterSize();
 
+    if (emulation_)
+    {
+        frame_version_ = emulation_->screenVersion();
+        frame_ = emulation_->screen();
+    }
+
     // Set initial widget size based on character dimensions
     const int widget_width = Computer::VIC::kScreenWidth * char_width_;
     const int widget_height = Computer::VIC::kScreenHeight * char_height_;
@@ -108,25 +117,29 @@ void DisplayWidget::stopRefresh() const
 
 void DisplayWidget::paintEvent(QPaintEvent* event)
 {
-    Q_UNUSED(event)
-    
-    if (!video_chip_)
+    if (!emulation_)
     {
         return;
     }
     
+    // Only the rows refreshDisplay() asked for (the whole widget after a
+    // configuration change or expose).
+    const QRect area = event->rect();
+    const int first_row = std::max(0, area.top() / char_height_);
+    const int last_row = std::min(Computer::VIC::kScreenHeight - 1, area.bottom() / char_height_);
+
     QPainter painter(this);
-    painter.fillRect(rect(), background_color_);
+    painter.fillRect(area, background_color_);
     
     // Set up painter for character rendering
     painter.setFont(character_font_);
     painter.setPen(foreground_color_);
     
-    for (int y = 0; y < Computer::VIC::kScreenHeight; ++y)
+    for (int y = first_row; y <= last_row; ++y)
     {
         for (int x = 0; x < Computer::VIC::kScreenWidth; ++x)
         {
-            const uint8_t character = video_chip_->getCharacterAt(x, y);
+            const uint8_t character = frame_.cells[y * Computer::VIC::kScreenWidth + x];
             if (character != 0x00) // Don't draw null characters
             {
                 drawCharacterAt(painter, x, y, character);
@@ -151,11 +164,70 @@ void DisplayWidget::resizeEvent(QResizeEvent* event)
 
 void DisplayWidget::refreshDisplay()
 {
-    if (video_chip_ && (video_chip_->isDirty() || needs_full_redraw_))
+    if (!emulation_)
+    {
+        return;
+    }
+
+    // The emulation thread publishes a new frame only when the screen or the
+    // cursor changed, so an unchanged version costs nothing.
+    const uint32_t version = emulation_->screenVersion();
+    if (version == frame_version_ && !needs_full_redraw_)
+    {
+        return;
+    }
+    frame_version_ = version;
+    const Computer::ScreenFrame previous = frame_;
+    frame_ = emulation_->screen();
+
+    if (needs_full_redraw_)
     {
         update();
-        video_chip_->clearDirty();
     }
+    else
+    {
+        for (int y = 0; y < Computer::VIC::kScreenHeight; ++y)
+        {
+            const size_t row = static_cast<size_t>(y) * Computer::VIC::kScreenWidth;
+            if (!std::equal(frame_.cells.begin() + row, frame_.cells.begin() + row + Computer::VIC::kScreenWidth,
+                            previous.cells.begin() + row))
+            {
+                updateRow(y);
+            }
+        }
+    }
+
+    // The cursor lives in kernel RAM rather than screen memory; repaint the
+    // rows it left and entered.
+    const int cell = cursorCell();
+    if (cell != cursor_cell_)
+    {
+        if (cursor_cell_ >= 0)
+        {
+            updateRow(cursor_cell_ / Computer::VIC::kScreenWidth);
+        }
+        if (cell >= 0)
+        {
+            updateRow(cell / Computer::VIC::kScreenWidth);
+        }
+        cursor_cell_ = cell;
+    }
+}
+
+int DisplayWidget::cursorCell() const
+{
+    const int cursor_x = frame_.cursor_x;
+    const int cursor_y = frame_.cursor_y;
+    if (cursor_x >= Computer::VIC::kScreenWidth || cursor_y >= Computer::VIC::kScreenHeight)
+    {
+        return -1;
+    }
+    return cursor_y * Computer::VIC::kScreenWidth + cursor_x;
+}
+
+void DisplayWidget::updateRow(const int row)
+{
+    update(0, row * char_height_, width(), char_height_);
 }
 
 void DisplayWidget::setupFont()
@@ -253,14 +325,10 @@ void DisplayWidget::drawCursor(QPainter& painter)
 {
     // The kernel tracks the text cursor in CURSOR_X ($0276) / CURSOR_Y ($0277),
     // kept current for both the monitor and BASIC (all output flows through
-    // PRINT_CHAR), so the on-screen cursor follows the typing point.
-    if (!memory_)
-    {
-        return;
-    }
-
-    const int cursor_x = memory_->read(0x0276);
-    const int cursor_y = memory_->read(0x0277);
+    // PRINT_CHAR), so the on-screen cursor follows the typing point. Both
+    // come with the published frame.
+    const int cursor_x = frame_.cursor_x;
+    const int cursor_y = frame_.cursor_y;
 
     // Guard against any out-of-range value
     if (cursor_x >= Computer::VIC::kScreenWidth || cursor_y >= Computer::VIC::kScreenHeight)
@@ -296,7 +364,11 @@ void DisplayWidget::focusInEvent(QFocusEvent* event)
 {
     has_focus_ = true;
     show_cursor_ = true; // show immediately on focus; blink toggles it thereafter
-    update();
+    cursor_cell_ = cursorCell();
+    if (cursor_cell_ >= 0)
+    {
+        updateRow(cursor_cell_ / Computer::VIC::kScreenWidth);
+    }
     QWidget::focusInEvent(event);
 }
 
@@ -304,7 +376,10 @@ void DisplayWidget::focusOutEvent(QFocusEvent* event)
 {
     has_focus_ = false;
     show_cursor_ = false;
-    update();
+    if (cursor_cell_ >= 0)
+    {
+        updateRow(cursor_cell_ / Computer::VIC::kScreenWidth);
+    }
     QWidget::focusOutEvent(event);
 }
 
@@ -313,7 +388,10 @@ void DisplayWidget::blinkCursor()
     if (has_focus_)
     {
         show_cursor_ = !show_cursor_;
-        update();
+        if (cursor_cell_ >= 0)
+        {
+            updateRow(cursor_cell_ / Computer::VIC::kScreenWidth);
+        }
     }
 }
 
@@ -1,4 +1,5 @@
 #include "MainWindow.h"
+#include <QActionGroup>
 #include <QApplication>
 #include <QMenuBar>
 #include <QStatusBar>
@@ -17,6 +18,7 @@ MainWindow::MainWindow(QWidget* parent)
     , reset_button_(nullptr)
     , nmi_button_(nullptr)
     , status_label_(nullptr)
+    , speed_label_(nullptr)
     , cpu_header_label_(nullptr)
     , current_byte_label_(nullptr)
     , reg_a_label_(nullptr)
@@ -28,28 +30,22 @@ MainWindow::MainWindow(QWidget* parent)
     , flags_values_label_(nullptr)
     , status_timer_(new QTimer(this))
     , computer_(new Computer::Computer6502())
-    , execution_timer_(new QTimer(this))
-    , irq_timer_(new QTimer(this))
-    , is_running_(false)
-    , execution_cycle_count_(0)
+    , emulation_(new Computer::EmulationThread(*computer_))
 {
     setupUI();
     setupMenus();
     connectSignals();
     
-    // Auto-start system powered on and running
+    // Auto-start system powered on and running on its own thread. File
+    // commands still open their dialogs here, on the GUI thread.
     computer_->power_on();
+    emulation_->setHostExecutor([this](std::function<void()> job) {
+        QMetaObject::invokeMethod(this, std::move(job), Qt::QueuedConnection);
+    });
+    emulation_->publish();
+    emulation_->start();
     display_widget_->startRefresh();
     display_widget_->setFocus();
-    is_running_ = true;
-    execution_timer_->start(1); // 1ms intervals for 1MHz operation
-
-    // Drive the PIA interval-timer IRQ at ~60 Hz (wall-clock), independent of
-    // emulation speed. This is the system "jiffy" tick behind BASIC's ON IRQ.
-    connect(irq_timer_, &QTimer::timeout, this, [this]() {
-        computer_->getPia()->pulseTimerIrq();
-    });
-    irq_timer_->start(16); // ~62.5 Hz
     
     // Initialize status
     updateStatus();
@@ -60,14 +56,14 @@ MainWindow::MainWindow(QWidget* parent)
 
 MainWindow::~MainWindow()
 {
+    delete emulation_;   // joins the thread before the machine goes away
     delete computer_;
 }
 
 
 void MainWindow::onResetClicked()
 {
-    computer_->reset();
-    execution_cycle_count_ = 0;
+    emulation_->requestReset();
 
     status_label_->setText("System reset - Running");
 }
@@ -76,11 +72,8 @@ void MainWindow::onNmiClicked()
 {
     // Trigger a non-maskable interrupt: BASIC handles it if ON NMI is enabled,
     // otherwise the kernel ISR breaks back to the monitor (a "stop" key).
-    if (computer_)
-    {
-        computer_->getCpu()->requestNmi();
-        status_label_->setText("NMI");
-    }
+    emulation_->requestNmi();
+    status_label_->setText("NMI");
     display_widget_->setFocus();  // keep typing focus on the display
 }
 
@@ -89,22 +82,21 @@ void MainWindow::onNmiClicked()
 
 void MainWindow::updateStatus()
 {
-    if (computer_)
-    {
-        updateCpuStatusSidebar();
-    }
+    updateCpuStatusSidebar();
+
+    // Effective clock as measured by the pacer
+    const double mhz = emulation_->registers().frequency / 1e6;
+    speed_label_->setText(mhz > 0.0 ? QString("%1 MHz").arg(mhz, 0, 'f', 2) : QString());
 }
 
 
 void MainWindow::onDisplayKeyPressed(uint8_t ascii_code)
 {
-    if (!computer_)
+    // Queued for the emulation thread, which hands it to the PIA between slices
+    if (!emulation_->postKey(ascii_code))
     {
-        return;
+        status_label_->setText("Keyboard queue full");
     }
-    
-    // Send keypress directly to PIA
-    computer_->getPia()->addKeypress(ascii_code);
 }
 
 void MainWindow::setupUI()
@@ -121,7 +113,7 @@ void MainWindow::setupUI()
     display_layout_->setContentsMargins(0, 0, 0, 0); // No margins
     
     // Create display widget
-    display_widget_ = new DisplayWidget(computer_->getVideoChip(), computer_->getMemory(), this);
+    display_widget_ = new DisplayWidget(emulation_, this);
     display_layout_->addWidget(display_widget_);
     
     // Connect display widget keyboard input to PIA
@@ -223,6 +215,9 @@ void MainWindow::setupUI()
     status_label_ = new QLabel("System running", this);
     
     statusBar()->addWidget(status_label_);
+
+    speed_label_ = new QLabel(this);
+    statusBar()->addPermanentWidget(speed_label_);
 }
 
 void MainWindow::setupMenus()
@@ -233,6 +228,26 @@ void MainWindow::setupMenus()
     QAction* exit_action = file_menu->addAction("E&xit");
     exit_action->setShortcut(QKeySequence::Quit);
     connect(exit_action, &QAction::triggered, this, &QWidget::close);
+
+    // Speed menu: target clock for the real-time pacer
+    QMenu* speed_menu = menuBar()->addMenu("&Speed");
+    QActionGroup* speed_group = new QActionGroup(this);
+    const Computer::TimingCircuit* timing = computer_->getTimingCircuit();   // not running yet
+    auto addSpeed = [&](const QString& label, uint32_t hz) {
+        QAction* action = speed_menu->addAction(label);
+        action->setCheckable(true);
+        action->setChecked(timing->getTargetFrequency() == hz);
+        speed_group->addAction(action);
+        connect(action, &QAction::triggered, this, [this, hz]() {
+            emulation_->requestFrequency(hz);
+            display_widget_->setFocus();
+        });
+    };
+    for (const uint32_t hz : Computer::TimingCircuit::kSupportedFrequencies)
+    {
+        addSpeed(QString("%1 MHz").arg(hz / 1000000), hz);
+    }
+    addSpeed("&Unthrottled", Computer::TimingCircuit::kUnthrottled);
     
     // Help menu
     QMenu* help_menu = menuBar()->addMenu("&Help");
@@ -253,51 +268,36 @@ void MainWindow::connectSignals()
     connect(nmi_button_, &QPushButton::clicked, this, &MainWindow::onNmiClicked);
     
     connect(status_timer_, &QTimer::timeout, this, &MainWindow::updateStatus);
-    
-    // Connect execution timer to run computer cycles
-    connect(execution_timer_, &QTimer::timeout, [this]() {
-        if (is_running_ && computer_)
-        {
-            // Run 1000 cycles per 1ms tick for 1MHz operation
-            for (int i = 0; i < 1000; ++i)
-            {
-                computer_->run(1);
-                execution_cycle_count_++;
-            }
-        }
-    });
 }
 
 void MainWindow::updateCpuStatusSidebar()
 {
-    if (!computer_ || !computer_->getCpu())
-    {
-        return;
-    }
-    
-    Computer::CPU6502* cpu = computer_->getCpu();
+    // One consistent snapshot, published by the emulation thread after its
+    // last slice
+    const Computer::CpuSnapshot cpu = emulation_->registers();
+    using Computer::CPU6502;
     
     // Get current byte at PC
-    uint8_t current_byte = cpu->getCurrentByte();
+    const uint8_t current_byte = cpu.current_byte;
     current_byte_label_->setText(QString("0x%1").arg(current_byte, 2, 16, QChar('0')).toUpper());
     
     // Update CPU registers
-    reg_a_label_->setText(QString("A: 0x%1").arg(cpu->reg.A, 2, 16, QChar('0')).toUpper());
-    reg_x_label_->setText(QString("X: 0x%1").arg(cpu->reg.X, 2, 16, QChar('0')).toUpper());
-    reg_y_label_->setText(QString("Y: 0x%1").arg(cpu->reg.Y, 2, 16, QChar('0')).toUpper());
-    reg_pc_label_->setText(QString("PC: %1").arg(cpu->reg.PC, 4, 16, QChar('0')).toUpper());
-    reg_sp_label_->setText(QString("SP: 0x%1").arg(cpu->reg.SP, 2, 16, QChar('0')).toUpper());
+    reg_a_label_->setText(QString("A: 0x%1").arg(cpu.a, 2, 16, QChar('0')).toUpper());
+    reg_x_label_->setText(QString("X: 0x%1").arg(cpu.x, 2, 16, QChar('0')).toUpper());
+    reg_y_label_->setText(QString("Y: 0x%1").arg(cpu.y, 2, 16, QChar('0')).toUpper());
+    reg_pc_label_->setText(QString("PC: %1").arg(cpu.pc, 4, 16, QChar('0')).toUpper());
+    reg_sp_label_->setText(QString("SP: 0x%1").arg(cpu.sp, 2, 16, QChar('0')).toUpper());
     
     // Extract individual flag bits for display
     QString flags;
-    flags += (cpu->reg.P & cpu->kNegative) ? '1' : '0';  // Bit 7: N
-    flags += (cpu->reg.P & cpu->kOverflow) ? '1' : '0';  // Bit 6: V  
-    flags += (cpu->reg.P & cpu->kUnused) ? '1' : '0';    // Bit 5: - (always 1)
-    flags += (cpu->reg.P & cpu->kBreak) ? '1' : '0';     // Bit 4: B
-    flags += (cpu->reg.P & cpu->kDecimal) ? '1' : '0';   // Bit 3: D
-    flags += (cpu->reg.P & cpu->kInterrupt) ? '1' : '0'; // Bit 2: I
-    flags += (cpu->reg.P & cpu->kZero) ? '1' : '0';      // Bit 1: Z
-    flags += (cpu->reg.P & cpu->kCarry) ? '1' : '0';     // Bit 0: C
+    flags += (cpu.p & CPU6502::kNegative) ? '1' : '0';  // Bit 7: N
+    flags += (cpu.p & CPU6502::kOverflow) ? '1' : '0';  // Bit 6: V  
+    flags += (cpu.p & CPU6502::kUnused) ? '1' : '0';    // Bit 5: - (always 1)
+    flags += (cpu.p & CPU6502::kBreak) ? '1' : '0';     // Bit 4: B
+    flags += (cpu.p & CPU6502::kDecimal) ? '1' : '0';   // Bit 3: D
+    flags += (cpu.p & CPU6502::kInterrupt) ? '1' : '0'; // Bit 2: I
+    flags += (cpu.p & CPU6502::kZero) ? '1' : '0';      // Bit 1: Z
+    flags += (cpu.p & CPU6502::kCarry) ? '1' : '0';     // Bit 0: C
     
     flags_values_label_->setText(flags);
 }
\ No newline at end of file
@@ -28,6 +28,7 @@
 #include <vector>
 
 #include "computer/BlockDevice.h"
+#include "computer/Computer6502.h"
 #include "computer/Memory.h"
 
 using Computer::BlockDevice;
@@ -218,4 +219,67 @@ TEST_F(BlockDeviceTest, ErrorStatusOnUnwritablePath) {
     EXPECT_EQ(mem.read(BlockDevice::kRegStatus), BlockDevice::kStatusError);
 }
 
+// After freezeImage() writes stay in memory; a copy shares the sectors
+// written so far and neither side sees the other's later writes.
+TEST_F(BlockDeviceTest, FrozenCopiesKeepTheirOwnSectors) {
+    const auto base = makeSector(0x01);
+    const auto parent_data = makeSector(0x02);
+    const auto child_data = makeSector(0x03);
+
+    BlockDevice dev{image_path_};
+    Memory mem{nullptr, nullptr};
+    mem.setBlockDevice(&dev);
+    writeSector(mem, 1, base);             // goes to the image
+    dev.freezeImage();
+    writeSector(mem, 2, parent_data);      // kept in memory
+    EXPECT_EQ(dev.overlaySectors(), 1u);
+
+    BlockDevice copy = dev;
+    Memory copy_mem{nullptr, nullptr};
+    copy_mem.setBlockDevice(&copy);
+    writeSector(copy_mem, 1, child_data);
+
+    EXPECT_EQ(readSector(mem, 1), base);
+    EXPECT_EQ(readSector(copy_mem, 1), child_data);
+    EXPECT_EQ(readSector(copy_mem, 2), parent_data);
+
+    // The image itself only ever saw the write made before the freeze.
+    BlockDevice reopened{image_path_};
+    Memory reopened_mem{nullptr, nullptr};
+    reopened_mem.setBlockDevice(&reopened);
+    EXPECT_EQ(readSector(reopened_mem, 1), base);
+    EXPECT_EQ(readSector(reopened_mem, 2), (std::array<uint8_t, kSectorSize>{}));
+}
+
+// A forked machine resumes from the parent's state and then runs on its own.
+TEST_F(BlockDeviceTest, ForkedMachineRunsIndependently) {
+    Computer::Computer6502 parent;
+    parent.getBlockDevice()->setImagePath(image_path_);
+    Memory &mem = *parent.getMemory();
+    const std::vector<uint8_t> program{0xA9, 0x42,         // LDA #$42
+                                       0x8D, 0x00, 0x02};  // STA $0200
+    mem.writeBlock(0x0300, program);
+    mem.write(0x0200, 0x01);
+    parent.getVideoChip()->setCharacterAt(3, 4, 'P');
+    parent.getCpu()->reg.PC = 0x0300;
+    parent.getCpu()->reg.X = 0x77;
+
+    auto child = parent.fork();
+    EXPECT_TRUE(parent.getBlockDevice()->isImageFrozen());
+    EXPECT_EQ(child->getVideoChip()->getCharacterAt(3, 4), 'P');
+    EXPECT_EQ(child->getCpu()->reg.X, 0x77);
+
+    child->run(2);
+    EXPECT_EQ(child->getMemory()->read(0x0200), 0x42);
+    EXPECT_EQ(child->getCpu()->reg.PC, 0x0305);
+    EXPECT_EQ(mem.read(0x0200), 0x01);
+    EXPECT_EQ(parent.getCpu()->reg.PC, 0x0300);
+
+    child->getVideoChip()->setCharacterAt(3, 4, 'C');
+    EXPECT_EQ(parent.getVideoChip()->getCharacterAt(3, 4), 'P');
+
+    writeSector(*child->getMemory(), 9, makeSector(0x09));
+    EXPECT_EQ(readSector(mem, 9), (std::array<uint8_t, kSectorSize>{}));
+}
+
 } // namespace
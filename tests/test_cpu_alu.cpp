@@ -10,10 +10,16 @@
  *   - ADC/SBC honor decimal mode (BCD) with correct per-nibble adjust.
  */
 
+#include <chrono>
+#include <thread>
+#include <vector>
+
 #include <gtest/gtest.h>
 
 #include "computer/CPU6502.h"
 #include "computer/Memory.h"
+#include "computer/PIA.h"
+#include "computer/VIC.h"
 
 using Computer::CPU6502;
 using Computer::Memory;
@@ -448,6 +454,514 @@ TEST_F(CpuAluTest, NopThreeByte) {
     EXPECT_EQ(cpu.reg.PC, static_cast<uint16_t>(kProgAddr + 3));
 }
 
+// Every one of the 256 opcodes has a handler in the dispatch table (the
+// 65C02 defines them all), so no byte value reports "unknown opcode".
+TEST_F(CpuAluTest, EveryOpcodeDispatches) {
+    for (int op = 0; op < 256; ++op) {
+        mem.write(kProgAddr, static_cast<uint8_t>(op));
+        mem.write(kProgAddr + 1, 0x00);
+        mem.write(kProgAddr + 2, 0x02);
+        cpu.reg.PC = kProgAddr;
+        EXPECT_TRUE(cpu.executeSingleInstruction()) << "opcode $" << std::hex << op;
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Batched execution (runCycles) matches single-stepping
+// ---------------------------------------------------------------------------
+
+// A countdown loop with a JSR, run once through runCycles and once one
+// instruction at a time, ends in the same state after the same cycle count.
+TEST_F(CpuAluTest, RunCyclesMatchesSingleStep) {
+    const uint8_t program[] = {
+        0xA2, 0x40,                    // LDX #$40
+        0x20, 0x00, 0x03,              // JSR $0300
+        0xCA,                          // DEX
+        0xD0, 0xFA,                    // BNE -6
+        0x80, 0xF6,                    // BRA -10
+    };
+    for (size_t i = 0; i < sizeof(program); ++i)
+        mem.write(static_cast<uint16_t>(kProgAddr + i), program[i]);
+    mem.write(0x0300, 0xE8);           // INX
+    mem.write(0x0301, 0x60);           // RTS
+    cpu.reg.SP = 0xFF;
+    cpu.reg.PC = kProgAddr;
+
+    const uint64_t ran = cpu.runCycles(5000);
+    EXPECT_GE(ran, 5000u);
+    EXPECT_EQ(cpu.getCycles(), ran);
+    const CPU6502::Registers batched = cpu.reg;
+
+    Memory mem2{nullptr, nullptr};
+    for (size_t i = 0; i < sizeof(program); ++i)
+        mem2.write(static_cast<uint16_t>(kProgAddr + i), program[i]);
+    mem2.write(0x0300, 0xE8);
+    mem2.write(0x0301, 0x60);
+    CPU6502 stepped{mem2};
+    stepped.reg.SP = 0xFF;
+    stepped.reg.PC = kProgAddr;
+    while (stepped.getCycles() < ran)
+        ASSERT_TRUE(stepped.executeSingleInstruction());
+
+    EXPECT_EQ(stepped.getCycles(), ran);
+    EXPECT_EQ(stepped.reg.PC, batched.PC);
+    EXPECT_EQ(stepped.reg.X, batched.X);
+    EXPECT_EQ(stepped.reg.SP, batched.SP);
+}
+
+// Status flags set by different instructions (CMP for C/N, BIT for V/Z)
+// are assembled correctly when P is pushed mid-batch and when the batch ends.
+TEST_F(CpuAluTest, RunCyclesPacksStatusFlags) {
+    const uint8_t program[] = {
+        0xA9, 0x80,                    // LDA #$80
+        0xC9, 0x90,                    // CMP #$90   -> C=0, N=1
+        0x24, 0x10,                    // BIT $10    -> V=1, Z=1 (N from M: 0)
+        0x08,                          // PHP
+        0x38,                          // SEC
+        0x80, 0xFE,                    // BRA -2 (spin)
+    };
+    for (size_t i = 0; i < sizeof(program); ++i)
+        mem.write(static_cast<uint16_t>(kProgAddr + i), program[i]);
+    mem.write(0x0010, 0x40);
+    cpu.reg.SP = 0xFF;
+    cpu.reg.PC = kProgAddr;
+    cpu.reg.P = CPU6502::kUnused | CPU6502::kCarry;
+
+    cpu.runCycles(50);
+    const uint8_t pushed = mem.read(0x01FF);
+    EXPECT_EQ(pushed, CPU6502::kUnused | CPU6502::kBreak | CPU6502::kOverflow | CPU6502::kZero);
+    EXPECT_EQ(cpu.reg.P, CPU6502::kUnused | CPU6502::kOverflow | CPU6502::kZero | CPU6502::kCarry);
+    EXPECT_TRUE(c());
+    EXPECT_TRUE(v());
+    EXPECT_TRUE(z());
+    EXPECT_FALSE(n());
+}
+
+// An asserted IRQ line is serviced inside the batch once I is clear.
+TEST_F(CpuAluTest, RunCyclesServicesIrq) {
+    mem.write(kProgAddr, 0x80);        // BRA -2 (spin)
+    mem.write(kProgAddr + 1, 0xFE);
+    mem.writeWord(0xFFFE, 0x0300);
+    mem.write(0x0300, 0x80);           // BRA -2 (spin in the handler)
+    mem.write(0x0301, 0xFE);
+    cpu.reg.SP = 0xFF;
+    cpu.reg.PC = kProgAddr;
+    cpu.setFlag(CPU6502::kInterrupt, false);
+
+    cpu.setIrqLine(true);
+    cpu.runCycles(100);
+    EXPECT_EQ(cpu.reg.PC, 0x0300);
+    EXPECT_TRUE(cpu.getFlag(CPU6502::kInterrupt));
+    EXPECT_EQ(cpu.reg.SP, 0xFC);       // return address + status pushed
+}
+
+// ---------------------------------------------------------------------------
+// WAI / STP halt the CPU
+// ---------------------------------------------------------------------------
+
+// WAI halts; the clock runs on without executing until the IRQ line rises.
+// With I clear the IRQ is taken; RTI returns past the WAI.
+TEST_F(CpuAluTest, WaiResumesOnIrq) {
+    mem.write(kProgAddr, 0xCB);        // WAI
+    mem.write(kProgAddr + 1, 0xE8);    // INX
+    mem.writeWord(0xFFFE, 0x0300);
+    mem.write(0x0300, 0x40);           // RTI
+    cpu.reg.SP = 0xFF;
+    cpu.reg.PC = kProgAddr;
+    cpu.setFlag(CPU6502::kInterrupt, false);
+
+    cpu.runCycles(1000);
+    EXPECT_EQ(cpu.runState(), CPU6502::RunState::Waiting);
+    EXPECT_EQ(cpu.reg.PC, kProgAddr + 1);
+    EXPECT_EQ(cpu.getCycles(), 1000u);
+    EXPECT_TRUE(cpu.isIdle());
+
+    cpu.setIrqLine(true);
+    EXPECT_FALSE(cpu.isHalted());
+    ASSERT_TRUE(cpu.executeSingleInstruction());   // IRQ entry
+    EXPECT_EQ(cpu.reg.PC, 0x0300);
+    cpu.setIrqLine(false);
+    ASSERT_TRUE(cpu.executeSingleInstruction());   // RTI
+    ASSERT_TRUE(cpu.executeSingleInstruction());   // INX
+    EXPECT_EQ(cpu.reg.X, 1);
+}
+
+// With I set, the IRQ only releases WAI: execution continues after it.
+TEST_F(CpuAluTest, WaiWithInterruptsMaskedContinues) {
+    mem.write(kProgAddr, 0xCB);        // WAI
+    mem.write(kProgAddr + 1, 0xE8);    // INX
+    mem.write(kProgAddr + 2, 0xCB);    // WAI
+    mem.write(kProgAddr + 3, 0x80);    // BRA -2 (spin)
+    mem.write(kProgAddr + 4, 0xFE);
+    cpu.reg.PC = kProgAddr;
+    cpu.setFlag(CPU6502::kInterrupt, true);
+
+    ASSERT_TRUE(cpu.executeSingleInstruction());
+    EXPECT_TRUE(cpu.isHalted());
+    ASSERT_TRUE(cpu.executeSingleInstruction());   // halted: one idle cycle
+    EXPECT_EQ(cpu.reg.PC, kProgAddr + 1);
+
+    cpu.setIrqLine(true);
+    cpu.runCycles(100);
+    EXPECT_EQ(cpu.reg.X, 1);
+    // The line is still asserted, so the second WAI falls straight through.
+    EXPECT_FALSE(cpu.isHalted());
+    EXPECT_EQ(cpu.reg.PC, kProgAddr + 3);
+}
+
+// STP ignores interrupts and only a reset restarts the CPU.
+TEST_F(CpuAluTest, StpHaltsUntilReset) {
+    mem.write(kProgAddr, 0xDB);        // STP
+    mem.writeWord(0xFFFC, 0x0300);
+    cpu.reg.PC = kProgAddr;
+
+    cpu.runCycles(100);
+    EXPECT_EQ(cpu.runState(), CPU6502::RunState::Stopped);
+    cpu.requestNmi();
+    cpu.setIrqLine(true);
+    EXPECT_FALSE(cpu.waitWhileHalted(std::chrono::microseconds(100)));
+    EXPECT_EQ(cpu.reg.PC, kProgAddr + 1);
+
+    cpu.reset();
+    EXPECT_EQ(cpu.runState(), CPU6502::RunState::Running);
+    EXPECT_EQ(cpu.reg.PC, 0x0300);
+}
+
+// A host thread sleeping on a waiting CPU is woken by an NMI from another thread.
+TEST_F(CpuAluTest, WaitWhileHaltedWakesOnNmi) {
+    mem.write(kProgAddr, 0xCB);        // WAI
+    cpu.reg.PC = kProgAddr;
+    cpu.runCycles(10);
+    ASSERT_TRUE(cpu.isHalted());
+
+    std::thread waker([this] { cpu.requestNmi(); });
+    EXPECT_TRUE(cpu.waitWhileHalted(std::chrono::seconds(10)));
+    waker.join();
+}
+
+// ---------------------------------------------------------------------------
+// Predecoded block cache: self-modifying code and banked ROM
+// ---------------------------------------------------------------------------
+
+// A store that patches the operand of the next instruction in the same
+// block takes effect immediately.
+TEST_F(CpuAluTest, RunCyclesSeesSelfModifyingStore) {
+    const uint8_t program[] = {
+        0xA9, 0x01,                    // LDA #$01
+        0x8D, 0x06, 0x02,              // STA $0206 (LDX operand below)
+        0xA2, 0x00,                    // LDX #$00
+        0x80, 0xFE,                    // BRA -2 (spin)
+    };
+    for (size_t i = 0; i < sizeof(program); ++i)
+        mem.write(static_cast<uint16_t>(kProgAddr + i), program[i]);
+    cpu.reg.PC = kProgAddr;
+
+    cpu.runCycles(100);
+    EXPECT_EQ(cpu.reg.X, 0x01);
+}
+
+// Single-stepping fetches operands from the code's page when the whole
+// instruction fits in it, and through the bus when it straddles a page or
+// runs from the I/O page.
+TEST_F(CpuAluTest, SingleStepFetchesAcrossPagesAndFromIoPage) {
+    mem.write(0x02FE, 0xAD);           // LDA $1234 (operand high byte on $0300)
+    mem.write(0x02FF, 0x34);
+    mem.write(0x0300, 0x12);
+    mem.write(0x1234, 0x5A);
+    mem.write(0x0301, 0x4C);           // JMP $FE80 (RAM in the I/O page)
+    mem.writeWord(0x0302, 0xFE80);
+    mem.write(0xFE80, 0xA2);           // LDX #$77
+    mem.write(0xFE81, 0x77);
+    cpu.reg.PC = 0x02FE;
+
+    ASSERT_TRUE(cpu.executeSingleInstruction());
+    EXPECT_EQ(cpu.reg.A, 0x5A);
+    ASSERT_TRUE(cpu.executeSingleInstruction());
+    ASSERT_TRUE(cpu.executeSingleInstruction());
+    EXPECT_EQ(cpu.reg.X, 0x77);
+    EXPECT_EQ(cpu.reg.PC, 0xFE82);
+}
+
+// Code rewritten between batches is re-decoded, not replayed stale.
+TEST_F(CpuAluTest, RunCyclesRedecodesRewrittenCode) {
+    mem.write(kProgAddr, 0xA2);        // LDX #$11
+    mem.write(kProgAddr + 1, 0x11);
+    mem.write(kProgAddr + 2, 0x80);    // BRA -2 (spin)
+    mem.write(kProgAddr + 3, 0xFE);
+    cpu.reg.PC = kProgAddr;
+    cpu.runCycles(100);
+    EXPECT_EQ(cpu.reg.X, 0x11);
+
+    mem.write(kProgAddr + 1, 0x22);
+    cpu.reg.PC = kProgAddr;
+    cpu.runCycles(100);
+    EXPECT_EQ(cpu.reg.X, 0x22);
+}
+
+// Code in screen memory rewritten by the VIC is re-decoded too.
+TEST_F(CpuAluTest, RunCyclesRedecodesCodeRewrittenByVic) {
+    Computer::VIC vic;
+    Memory screen_mem{&vic, nullptr};
+    CPU6502 screen_cpu{screen_mem};
+    constexpr uint16_t kScreenProg = Computer::VIC::kScreenMemoryStart + 0x100;
+    screen_mem.writeBlock(kScreenProg, std::vector<uint8_t>{0xA2, 0x11, 0x80, 0xFE});  // LDX #$11 / BRA -2
+    screen_cpu.reg.PC = kScreenProg;
+    screen_cpu.runCycles(100);
+    EXPECT_EQ(screen_cpu.reg.X, 0x11);
+
+    vic.setCharacterAt(0x101 % Computer::VIC::kScreenWidth, 0x101 / Computer::VIC::kScreenWidth, 0x22);
+    screen_cpu.reg.PC = kScreenProg;
+    screen_cpu.runCycles(100);
+    EXPECT_EQ(screen_cpu.reg.X, 0x22);
+}
+
+// The same PC in the module window decodes per bank.
+TEST_F(CpuAluTest, RunCyclesKeysBlocksByBank) {
+    mem.loadBank(1, {0xA9, 0x11, 0x80, 0xFE});  // LDA #$11 / BRA -2
+    mem.loadBank(2, {0xA9, 0x22, 0x80, 0xFE});  // LDA #$22 / BRA -2
+
+    mem.selectBank(1);
+    cpu.reg.PC = Memory::kModuleWindowStart;
+    cpu.runCycles(100);
+    EXPECT_EQ(cpu.reg.A, 0x11);
+
+    mem.selectBank(2);
+    cpu.reg.PC = Memory::kModuleWindowStart;
+    cpu.runCycles(100);
+    EXPECT_EQ(cpu.reg.A, 0x22);
+}
+
+// READ_CMD_LOOP in miniature: JSR to a GET_KEYSTROKE that polls the PIA
+// control register, BCC back while no key is waiting.
+constexpr uint8_t kPollProgram[] = {
+    0x20, 0x00, 0x03,              // $0200 JSR $0300
+    0x90, 0xFB,                    //       BCC $0200
+    0x80, 0xFE,                    // $0205 BRA *
+};
+constexpr uint8_t kGetKeystroke[] = {
+    0xAD, 0x02, 0xFE,              // $0300 LDA PIA_CONTROL
+    0x29, 0x01,                    //       AND #PIA_DATA_AVAIL
+    0xF0, 0x05,                    //       BEQ $030C
+    0xAD, 0x00, 0xFE,              //       LDA PIA_DATA
+    0x38,                          //       SEC
+    0x60,                          //       RTS
+    0x18,                          // $030C CLC
+    0x60,                          //       RTS
+};
+
+void loadPollProgram(Memory &m) {
+    for (size_t i = 0; i < sizeof(kPollProgram); ++i)
+        m.write(static_cast<uint16_t>(kProgAddr + i), kPollProgram[i]);
+    for (size_t i = 0; i < sizeof(kGetKeystroke); ++i)
+        m.write(static_cast<uint16_t>(0x0300 + i), kGetKeystroke[i]);
+}
+
+// A keyboard poll loop is fast-forwarded to the end of the batch, lands
+// exactly where single-stepping the same cycles would, and still sees a key
+// queued by the host between batches.
+TEST(CpuIdleTest, RunCyclesFastForwardsPollLoop) {
+    Computer::PIA pia;
+    Memory mem{nullptr, &pia};
+    loadPollProgram(mem);
+    CPU6502 cpu{mem};
+    cpu.reg.SP = 0xFF;
+    cpu.reg.PC = kProgAddr;
+
+    const uint64_t ran = cpu.runCycles(1'000'000);
+    EXPECT_TRUE(cpu.isIdle());
+    EXPECT_GT(cpu.idleCycles(), 990'000u);
+    EXPECT_EQ(cpu.getCycles(), ran);
+
+    Computer::PIA step_pia;
+    Memory step_mem{nullptr, &step_pia};
+    loadPollProgram(step_mem);
+    CPU6502 stepped{step_mem};
+    stepped.reg.SP = 0xFF;
+    stepped.reg.PC = kProgAddr;
+    while (stepped.getCycles() < ran)
+        ASSERT_TRUE(stepped.executeSingleInstruction());
+    EXPECT_EQ(stepped.getCycles(), ran);
+    EXPECT_EQ(stepped.reg.PC, cpu.reg.PC);
+    EXPECT_EQ(stepped.reg.A, cpu.reg.A);
+    EXPECT_EQ(stepped.reg.SP, cpu.reg.SP);
+    EXPECT_EQ(stepped.reg.P, cpu.reg.P);
+
+    pia.addKeypress('K');
+    cpu.runCycles(1000);
+    EXPECT_FALSE(cpu.isIdle());
+    EXPECT_EQ(cpu.reg.PC, kProgAddr + 5);  // left the loop on BRA *
+    EXPECT_EQ(cpu.reg.A, 'K');
+}
+
+// A budget that is a whole number of passes: the skip lands exactly on the
+// end of the batch and nothing runs past it.
+TEST(CpuIdleTest, RunCyclesStopsAtBudgetAfterExactSkip) {
+    Computer::PIA pia;
+    Memory mem{nullptr, &pia};
+    mem.write(kProgAddr, 0xAD);        // LDA PIA_CONTROL   (4 cycles)
+    mem.write(kProgAddr + 1, 0x02);
+    mem.write(kProgAddr + 2, 0xFE);
+    mem.write(kProgAddr + 3, 0xF0);    // BEQ -5            (3 cycles taken)
+    mem.write(kProgAddr + 4, 0xFB);
+    CPU6502 cpu{mem};
+    cpu.reg.PC = kProgAddr;
+
+    constexpr uint64_t kPeriod = 7;
+    for (const uint64_t budget : {kPeriod * 100, kPeriod * 10'000}) {
+        const uint64_t start = cpu.getCycles();
+        EXPECT_EQ(cpu.runCycles(budget), budget);
+        EXPECT_EQ(cpu.getCycles(), start + budget);
+        EXPECT_TRUE(cpu.isIdle());
+        EXPECT_EQ(cpu.reg.PC, kProgAddr);
+    }
+}
+
+// A loop that changes memory on every pass is never skipped.
+TEST(CpuIdleTest, RunCyclesRunsBusyLoop) {
+    Memory mem{nullptr, nullptr};
+    mem.write(kProgAddr, 0xE6);        // INC $10
+    mem.write(kProgAddr + 1, 0x10);
+    mem.write(kProgAddr + 2, 0x80);    // BRA -4
+    mem.write(kProgAddr + 3, 0xFC);
+    CPU6502 cpu{mem};
+    cpu.reg.PC = kProgAddr;
+
+    cpu.runCycles(100'000);
+    EXPECT_FALSE(cpu.isIdle());
+    EXPECT_EQ(cpu.idleCycles(), 0u);
+}
+
+// Watch hits carry the instruction's PC and start cycle; the batch ends at
+// each hit.
+TEST(CpuWatchTest, WatchpointsReportAccessesWithPc) {
+    Memory mem{nullptr, nullptr};
+    const uint8_t program[] = {
+        0xA5, 0x10,                    // $0200 LDA $10
+        0x8D, 0x00, 0x03,              // $0202 STA $0300
+        0xEA,                          // $0205 NOP
+        0x80, 0xFE,                    // $0206 BRA *
+    };
+    for (size_t i = 0; i < sizeof(program); ++i)
+        mem.write(static_cast<uint16_t>(kProgAddr + i), program[i]);
+    mem.write(0x0010, 0x42);
+    CPU6502 cpu{mem};
+    cpu.reg.PC = kProgAddr;
+
+    std::vector<CPU6502::WatchHit> hits;
+    cpu.setWatchHandler([&](const CPU6502::WatchHit &hit) { hits.push_back(hit); });
+    cpu.addWatchpoint(0x0010, Computer::kWatchRead);
+    cpu.addWatchpoint(0x0300, Computer::kWatchWrite);
+    cpu.addWatchpoint(0x0205, Computer::kWatchExecute);
+    cpu.addWatchpoint(0x0201, Computer::kWatchRead);  // an operand: fetched, not read
+
+    uint64_t batches = 0;
+    while (cpu.getCycles() < 200) {
+        cpu.runCycles(200 - cpu.getCycles());
+        ++batches;
+    }
+    EXPECT_GE(batches, 3u);
+
+    ASSERT_EQ(hits.size(), 3u);
+    EXPECT_EQ(hits[0].kind, Computer::kWatchRead);
+    EXPECT_EQ(hits[0].pc, 0x0200);
+    EXPECT_EQ(hits[0].address, 0x0010);
+    EXPECT_EQ(hits[0].value, 0x42);
+    EXPECT_EQ(hits[0].cycles, 0u);
+    EXPECT_EQ(hits[1].kind, Computer::kWatchWrite);
+    EXPECT_EQ(hits[1].pc, 0x0202);
+    EXPECT_EQ(hits[1].address, 0x0300);
+    EXPECT_EQ(hits[1].cycles, 4u);     // opcode fetch + LDA zp
+    EXPECT_EQ(hits[2].kind, Computer::kWatchExecute);
+    EXPECT_EQ(hits[2].pc, 0x0205);
+    EXPECT_EQ(hits[2].value, 0xEA);
+    EXPECT_EQ(hits[2].cycles, 9u);     // + STA abs
+    EXPECT_EQ(mem.read(0x0300), 0x42);
+
+    // Unwatched again: the pages are back on the fast path.
+    cpu.removeWatchpoint(0x0010, Computer::kWatchRead);
+    cpu.removeWatchpoint(0x0300, Computer::kWatchWrite);
+    cpu.removeWatchpoint(0x0205, Computer::kWatchExecute);
+    cpu.removeWatchpoint(0x0201, Computer::kWatchRead);
+    EXPECT_FALSE(mem.hasWatches());
+    cpu.reg.PC = kProgAddr;
+    cpu.runCycles(100);
+    EXPECT_EQ(hits.size(), 3u);
+}
+
+// One of each fused idiom, looping back to the start.
+constexpr uint8_t kFusionProgram[] = {
+    0xA2, 0x05,                    // $0200 LDX #$05
+    0xCA,                          // $0202 DEX
+    0xD0, 0xFD,                    //       BNE $0202        (countdown)
+    0xA0, 0x03,                    // $0205 LDY #$03
+    0x88,                          // $0207 DEY
+    0xD0, 0xFD,                    //       BNE $0207        (countdown)
+    0xA9, 0x42,                    // $020A LDA #$42
+    0x85, 0x10,                    //       STA $10          (load/store)
+    0xAD, 0x00, 0x03,              // $020E LDA $0300
+    0x91, 0x20,                    //       STA ($20),Y
+    0xC8,                          //       INY
+    0xD0, 0xF8,                    //       BNE $020E        (sector copy)
+    0xC9, 0x5A,                    // $0216 CMP #$5A
+    0xF0, 0x02,                    //       BEQ $021C        (compare/branch)
+    0x00, 0x00,                    //       BRK
+    0xE6, 0x30,                    // $021C INC $30
+    0xD0, 0xFC,                    //       BNE $021C        (pointer bump)
+    0x80, 0xDE,                    // $0220 BRA $0200
+};
+
+void loadFusionProgram(Memory &m) {
+    for (size_t i = 0; i < sizeof(kFusionProgram); ++i)
+        m.write(static_cast<uint16_t>(kProgAddr + i), kFusionProgram[i]);
+    m.write(0x0300, 0x5A);             // "data port" read by the copy loop
+    m.write(0x0020, 0x00);             // copy destination $1000
+    m.write(0x0021, 0x10);
+}
+
+// Fused idioms leave exactly the state and cycle count of one-by-one
+// execution, whether the batch runs them fused (large budget) or has to
+// fall back to single records (budgets smaller than an idiom).
+TEST_F(CpuAluTest, RunCyclesFusedIdiomsMatchSingleStep) {
+    for (const uint64_t slice : {uint64_t{50000}, uint64_t{7}}) {
+        Memory batch_mem{nullptr, nullptr};
+        loadFusionProgram(batch_mem);
+        CPU6502 batched{batch_mem};
+        batched.reg.PC = kProgAddr;
+        while (batched.getCycles() < 50000)
+            batched.runCycles(slice);
+
+        Memory step_mem{nullptr, nullptr};
+        loadFusionProgram(step_mem);
+        CPU6502 stepped{step_mem};
+        stepped.reg.PC = kProgAddr;
+        while (stepped.getCycles() < batched.getCycles())
+            ASSERT_TRUE(stepped.executeSingleInstruction());
+
+        EXPECT_EQ(stepped.getCycles(), batched.getCycles()) << "slice " << slice;
+        EXPECT_EQ(stepped.reg.PC, batched.reg.PC) << "slice " << slice;
+        EXPECT_EQ(stepped.reg.A, batched.reg.A);
+        EXPECT_EQ(stepped.reg.X, batched.reg.X);
+        EXPECT_EQ(stepped.reg.Y, batched.reg.Y);
+        EXPECT_EQ(stepped.reg.P, batched.reg.P);
+        EXPECT_EQ(step_mem.read(0x0010), batch_mem.read(0x0010));
+        EXPECT_EQ(step_mem.read(0x0030), batch_mem.read(0x0030));
+        EXPECT_EQ(step_mem.read(0x10FF), batch_mem.read(0x10FF));
+
+#if !defined(CPU6502_NO_FUSION) && !defined(CPU6502_JIT)
+        // (Translated blocks run natively and never reach the fused replay.)
+        using Fusion = Computer::BlockCache::Fusion;
+        for (const Fusion fusion : {Fusion::CountdownBranch, Fusion::LoadStore, Fusion::CompareBranch,
+                                    Fusion::IncrementBranch, Fusion::SectorCopy}) {
+            const CPU6502::FusionStats stats = batched.fusionStats(fusion);
+            if (slice > 1000)
+                EXPECT_GT(stats.fused, 0u) << Computer::BlockCache::fusionName(fusion);
+            else
+                EXPECT_GT(stats.unfused, 0u) << Computer::BlockCache::fusionName(fusion);
+        }
+#endif
+    }
+}
+
 // ---------------------------------------------------------------------------
 // 65C02 BRK clears the decimal flag (the NMOS 6502 does not)
 // ---------------------------------------------------------------------------
@@ -0,0 +1,175 @@
+/**
+ * @file test_emulation_thread.cpp
+ * @brief Unit tests for running the machine on its own thread.
+ *
+ * Covers the lock-free pieces the host and the emulation thread share - the
+ * single-producer keypress queue and the seqlock that publishes the screen
+ * and registers - and EmulationThread itself: keys posted from the test
+ * thread reach a running program, its output comes back through the
+ * published screen, and file work is handed to a host executor and waited
+ * for.
+ */
+
+#include <gtest/gtest.h>
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "computer/Computer6502.h"
+#include "computer/EmulationThread.h"
+#include "computer/Seqlock.h"
+#include "computer/SpscQueue.h"
+
+using Computer::EmulationThread;
+
+namespace {
+
+constexpr auto kPatience = std::chrono::seconds(5);
+
+/// Poll @p done until it holds or kPatience runs out.
+bool waitFor(const std::function<bool()> &done) {
+    const auto deadline = std::chrono::steady_clock::now() + kPatience;
+    while (!done()) {
+        if (std::chrono::steady_clock::now() > deadline) {
+            return false;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return true;
+}
+
+TEST(SpscQueueTest, KeepsOrderAndRefusesWhenFull) {
+    Computer::SpscQueue<uint8_t, 4> queue;
+    uint8_t value = 0;
+    EXPECT_TRUE(queue.empty());
+    EXPECT_FALSE(queue.pop(value));
+
+    for (uint8_t i = 1; i <= 4; ++i) {
+        EXPECT_TRUE(queue.push(i));
+    }
+    EXPECT_FALSE(queue.push(5));
+
+    // Wrap around the ring a few times.
+    for (uint8_t i = 1; i <= 10; ++i) {
+        ASSERT_TRUE(queue.pop(value));
+        EXPECT_EQ(value, i);
+        EXPECT_TRUE(queue.push(i + 4));
+    }
+    EXPECT_FALSE(queue.empty());
+}
+
+TEST(SeqlockTest, ReadersNeverSeeATornValue) {
+    struct Wide {
+        std::array<uint64_t, 16> words;
+    };
+    Computer::Seqlock<Wide> published;
+    EXPECT_EQ(published.load().words[0], 0u);
+
+    std::atomic<bool> stop{false};
+    std::thread writer([&] {
+        Wide value{};
+        for (uint64_t n = 1; !stop.load(std::memory_order_relaxed); ++n) {
+            value.words.fill(n);
+            published.store(value);
+        }
+    });
+
+    uint64_t last = 0;
+    for (int read = 0; read < 20000; ++read) {
+        const Wide value = published.load();
+        for (const uint64_t word : value.words) {
+            ASSERT_EQ(word, value.words[0]);
+        }
+        EXPECT_GE(value.words[0], last);
+        last = value.words[0];
+    }
+    stop = true;
+    writer.join();
+    EXPECT_EQ(published.version() % 2, 0u);
+}
+
+TEST(EmulationThreadTest, KeysReachTheProgramAndTheScreenComesBack) {
+    Computer::Computer6502 machine;
+    Computer::Memory &mem = *machine.getMemory();
+    // Echo the keyboard to the top-left screen cell.
+    const std::vector<uint8_t> echo{0x78,               // SEI
+                                    0xAD, 0x00, 0xFE,   // LDA KBD_DATA
+                                    0xF0, 0xFB,         // BEQ $0301
+                                    0x8D, 0x00, 0x04,   // STA $0400
+                                    0x4C, 0x01, 0x03};  // JMP $0301
+    mem.writeBlock(0x0300, echo);
+    mem.write(0x0400, ' ');
+    machine.getCpu()->reg.PC = 0x0300;
+
+    EmulationThread emulation(machine);
+    emulation.requestFrequency(Computer::TimingCircuit::kUnthrottled);
+    emulation.start();
+    ASSERT_TRUE(emulation.isRunning());
+
+    const uint32_t before = emulation.screenVersion();
+    EXPECT_TRUE(emulation.postKey('A'));
+    ASSERT_TRUE(waitFor([&] { return emulation.screen().cells[0] == 'A'; }));
+    EXPECT_NE(emulation.screenVersion(), before);
+
+    ASSERT_TRUE(waitFor([&] { return emulation.registers().cycles > 100000; }));
+    const Computer::CpuSnapshot registers = emulation.registers();
+    EXPECT_GE(registers.pc, 0x0301);
+    EXPECT_LT(registers.pc, 0x030C);
+    EXPECT_FALSE(registers.halted);
+
+    emulation.stop();
+    EXPECT_FALSE(emulation.isRunning());
+    EXPECT_EQ(mem.read(0x0400), 'A');
+    EXPECT_TRUE(machine.getTimingCircuit()->isUnthrottled());
+}
+
+TEST(EmulationThreadTest, FileWorkRunsOnTheHostThread) {
+    using Computer::PIA;
+    Computer::Computer6502 machine;
+    Computer::Memory &mem = *machine.getMemory();
+    // Open a file, wait for the result, and show the status.
+    const std::vector<uint8_t> open{0x78,               // SEI
+                                    0xA9, 0x03,         // LDA #OPEN_READ
+                                    0x8D, 0x10, 0xFE,   // STA FILE_CMD
+                                    0xAD, 0x11, 0xFE,   // LDA FILE_STATUS
+                                    0xC9, 0x01,         // CMP #IN_PROGRESS
+                                    0xF0, 0xF9,         // BEQ $0306
+                                    0x8D, 0x00, 0x04,   // STA $0400
+                                    0x4C, 0x10, 0x03};  // JMP $0310
+    mem.writeBlock(0x0300, open);
+    machine.getCpu()->reg.PC = 0x0300;
+
+    std::mutex mutex;
+    std::vector<std::function<void()>> posted;
+    EmulationThread emulation(machine);
+    emulation.setHostExecutor([&](std::function<void()> job) {
+        std::lock_guard lock(mutex);
+        posted.push_back(std::move(job));
+    });
+    emulation.start();
+
+    // The emulation thread waits for the host to run the job.
+    ASSERT_TRUE(waitFor([&] {
+        std::lock_guard lock(mutex);
+        return !posted.empty();
+    }));
+    const uint64_t waiting = emulation.registers().cycles;
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    EXPECT_EQ(emulation.registers().cycles, waiting);
+
+    std::function<void()> job;
+    {
+        std::lock_guard lock(mutex);
+        job = std::move(posted.front());
+    }
+    job();   // console builds have no file dialog, so the open fails
+    ASSERT_TRUE(waitFor([&] { return emulation.screen().cells[0] == PIA::kFileError; }));
+    emulation.stop();
+}
+
+} // namespace
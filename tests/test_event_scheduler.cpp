@@ -0,0 +1,228 @@
+/**
+ * @file test_event_scheduler.cpp
+ * @brief Unit tests for the cycle-timestamped event scheduler.
+ *
+ * Covers the heap ordering (earliest cycle first, posting order on ties),
+ * cancellation, callbacks that repost themselves, and Computer6502::runCycles
+ * stopping its batches on event cycles - including through an idle loop the
+ * CPU would otherwise fast-forward to the end of the budget - and the PIA file
+ * doorbell that posts file work as an event, and the jiffy IRQ releasing a
+ * WAI under the console run loop. The real-time pacer
+ * (TimingCircuit) that spaces those batches in wall time is covered at the end.
+ */
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+#include "computer/Computer6502.h"
+#include "computer/EventScheduler.h"
+#include "computer/TimingCircuit.h"
+
+using Computer::EventScheduler;
+
+namespace {
+
+TEST(EventSchedulerTest, FiresEarliestFirstAndTiesInPostingOrder) {
+    EventScheduler scheduler;
+    std::vector<int> fired;
+    scheduler.schedule(30, [&](uint64_t) { fired.push_back(3); });
+    scheduler.schedule(10, [&](uint64_t) { fired.push_back(1); });
+    scheduler.schedule(30, [&](uint64_t) { fired.push_back(4); });
+    scheduler.schedule(20, [&](uint64_t) { fired.push_back(2); });
+    EXPECT_EQ(scheduler.nextDue(), 10u);
+    EXPECT_EQ(scheduler.size(), 4u);
+
+    EXPECT_EQ(scheduler.runDue(9), 0u);
+    EXPECT_EQ(scheduler.runDue(25), 2u);
+    EXPECT_EQ(scheduler.nextDue(), 30u);
+    EXPECT_EQ(scheduler.runDue(100), 2u);
+    EXPECT_EQ(fired, (std::vector<int>{1, 2, 3, 4}));
+    EXPECT_EQ(scheduler.nextDue(), EventScheduler::kNever);
+}
+
+TEST(EventSchedulerTest, CancelledEventsNeverFire) {
+    EventScheduler scheduler;
+    int fired = 0;
+    const auto first = scheduler.schedule(5, [&](uint64_t) { fired += 1; });
+    scheduler.schedule(8, [&](uint64_t) { fired += 10; });
+    EXPECT_TRUE(scheduler.cancel(first));
+    EXPECT_FALSE(scheduler.cancel(first));
+    EXPECT_EQ(scheduler.nextDue(), 8u);
+    EXPECT_EQ(scheduler.size(), 1u);
+    scheduler.runDue(8);
+    EXPECT_EQ(fired, 10);
+}
+
+TEST(EventSchedulerTest, PeriodicEventRepostsWithoutDrift) {
+    EventScheduler scheduler;
+    std::vector<uint64_t> dues;
+    std::function<void(uint64_t)> tick = [&](const uint64_t due) {
+        dues.push_back(due);
+        scheduler.schedule(due + 100, tick);
+    };
+    scheduler.schedule(100, tick);
+
+    // Late batches (the clock a few cycles past the due cycle) keep the phase.
+    scheduler.runDue(103);
+    scheduler.runDue(207);
+    scheduler.runDue(450);
+    EXPECT_EQ(dues, (std::vector<uint64_t>{100, 200, 300, 400}));
+    EXPECT_EQ(scheduler.nextDue(), 500u);
+}
+
+TEST(EventSchedulerTest, MachineBatchesStopAtEvents) {
+    Computer::Computer6502 machine;
+    Computer::Memory &mem = *machine.getMemory();
+    Computer::CPU6502 &cpu = *machine.getCpu();
+    mem.write(0x0300, 0x4C);   // JMP $0300: an idle loop
+    mem.write(0x0301, 0x00);
+    mem.write(0x0302, 0x03);
+    cpu.reg.PC = 0x0300;
+
+    EventScheduler &scheduler = *machine.getScheduler();
+    const uint64_t start = cpu.getCycles();
+    std::vector<uint64_t> seen;
+    scheduler.schedule(start + 1000, [&](uint64_t) { seen.push_back(cpu.getCycles()); });
+    scheduler.schedule(start + 5000, [&](uint64_t) { seen.push_back(cpu.getCycles()); });
+
+    machine.runCycles(20000);
+    ASSERT_EQ(seen.size(), 2u);
+
+    // Fired at the end of the instruction that reached the cycle, not at the
+    // end of the fast-forwarded budget.
+    EXPECT_GE(seen[0], start + 1000);
+    EXPECT_LT(seen[0], start + 1000 + 8);
+    EXPECT_GE(seen[1], start + 5000);
+    EXPECT_LT(seen[1], start + 5000 + 8);
+    EXPECT_GE(cpu.getCycles(), start + 20000);
+}
+
+TEST(EventSchedulerTest, FileCommandRingsTheDoorbell) {
+    using Computer::PIA;
+    Computer::Computer6502 machine;
+    Computer::Memory &mem = *machine.getMemory();
+    mem.write(0x0300, 0x4C);   // JMP $0300
+    mem.write(0x0301, 0x00);
+    mem.write(0x0302, 0x03);
+    machine.getCpu()->reg.PC = 0x0300;
+
+    EventScheduler &scheduler = *machine.getScheduler();
+    machine.runCycles(1000);
+    EXPECT_EQ(scheduler.size(), 1u);   // just the jiffy timer: nothing is polled for
+
+    mem.write(PIA::kPiaMemoryStart + PIA::kFileCommand, PIA::kFileOpenReadCommand);
+    EXPECT_EQ(mem.read(PIA::kPiaMemoryStart + PIA::kFileStatus), PIA::kFileInProgress);
+    EXPECT_EQ(scheduler.size(), 2u);
+
+    // Serviced at the next batch boundary (console builds have no file
+    // dialog, so the open fails).
+    machine.runCycles(10);
+    EXPECT_FALSE(machine.getPia()->hasFileOperation());
+    EXPECT_EQ(mem.read(PIA::kPiaMemoryStart + PIA::kFileStatus), PIA::kFileError);
+    EXPECT_EQ(scheduler.size(), 1u);
+}
+
+TEST(EventSchedulerTest, JiffyIrqFollowsEmulatedTime) {
+    using Computer::Computer6502;
+    using Computer::PIA;
+    Computer6502 machine;
+    Computer::Memory &mem = *machine.getMemory();
+    const std::vector<uint8_t> idle{0x58,               // CLI
+                                    0x4C, 0x01, 0x03};  // JMP $0301
+    const std::vector<uint8_t> handler{0x8D, 0x0E, 0xFE,  // STA TIMER_IRQ_ACK
+                                       0xE6, 0x10,        // INC $10
+                                       0x40};             // RTI
+    mem.writeBlock(0x0300, idle);
+    mem.writeBlock(0x0400, handler);
+    mem.write(0xFFFE, 0x00);
+    mem.write(0xFFFF, 0x04);
+    mem.write(0x0010, 0);
+    machine.getCpu()->reg.PC = 0x0300;
+
+    // Ten periods of the CPU clock give ten ticks, whatever the host speed.
+    machine.runCycles(Computer6502::kJiffyCycles * 10 + 100);
+    EXPECT_EQ(mem.read(0x0010), 10);
+
+    // A reset restarts the clock and the timer with it.
+    mem.write(0xFFFC, 0x00);
+    mem.write(0xFFFD, 0x03);
+    machine.reset();
+    EXPECT_EQ(machine.getScheduler()->nextDue(), Computer6502::kJiffyCycles);
+    machine.runCycles(Computer6502::kJiffyCycles + 100);
+    EXPECT_EQ(mem.read(0x0010), 11);
+}
+
+TEST(EventSchedulerTest, JiffyReleasesWaiUnderRun) {
+    using Computer::Computer6502;
+    Computer6502 machine;
+    Computer::Memory &mem = *machine.getMemory();
+    const std::vector<uint8_t> wait{0x58,               // CLI
+                                    0xCB,               // WAI
+                                    0xE6, 0x11,         // INC $11
+                                    0x4C, 0x01, 0x03};  // JMP $0301
+    const std::vector<uint8_t> handler{0x8D, 0x0E, 0xFE,  // STA TIMER_IRQ_ACK
+                                       0xE6, 0x10,        // INC $10
+                                       0x40};             // RTI
+    mem.writeBlock(0x0300, wait);
+    mem.writeBlock(0x0400, handler);
+    mem.write(0xFFFE, 0x00);
+    mem.write(0xFFFF, 0x04);
+    mem.write(0x0010, 0);
+    mem.write(0x0011, 0);
+    machine.getCpu()->reg.PC = 0x0300;
+
+    // The console loop idles the halted CPU up to each tick instead of
+    // sleeping on the wall clock, so every tick releases the WAI.
+    machine.run(100000);
+    const int ticks = mem.read(0x0010);
+    const int released = mem.read(0x0011);
+    EXPECT_GE(ticks, static_cast<int>(100000 / Computer6502::kJiffyCycles));
+    EXPECT_LE(ticks, static_cast<int>(100000 / Computer6502::kJiffyCycles) + 1);
+    EXPECT_GE(released + 1, ticks);   // the last tick's WAI may end the run
+    EXPECT_GE(machine.getCpu()->getCycles(), 100000u);
+}
+
+TEST(TimingCircuitTest, PacesSlicesToTheTargetClock) {
+    using Computer::TimingCircuit;
+    TimingCircuit timing;
+    EXPECT_EQ(timing.getTargetFrequency(), 1000000u);
+    EXPECT_EQ(timing.sliceCycles(), 1000u);
+    timing.setTargetFrequency(4000000);
+    EXPECT_EQ(timing.sliceCycles(), 4000u);
+
+    // 20 slices of 1 ms at 4 MHz: never sooner than 20 ms of wall time.
+    const auto start = TimingCircuit::Clock::now();
+    for (int slice = 0; slice < 20; ++slice) {
+        timing.pace(timing.sliceCycles());
+    }
+    EXPECT_GE(TimingCircuit::Clock::now() - start, std::chrono::milliseconds(20) - std::chrono::microseconds(50));
+
+    timing.setTargetFrequency(TimingCircuit::kUnthrottled);
+    EXPECT_TRUE(timing.isUnthrottled());
+    EXPECT_EQ(timing.getActualFrequency(), 0.0);
+    const auto fast = TimingCircuit::Clock::now();
+    while (TimingCircuit::Clock::now() - fast < TimingCircuit::kMeasureWindow) {
+        timing.pace(timing.sliceCycles());
+    }
+    timing.pace(timing.sliceCycles());
+    EXPECT_GT(timing.getActualFrequency(), 8000000.0);   // 20000 cycles per call, no waiting
+}
+
+TEST(TimingCircuitTest, SlowClockStillRunsWholeCycles) {
+    using Computer::TimingCircuit;
+    TimingCircuit timing;
+    timing.setTargetFrequency(500);
+    EXPECT_EQ(timing.sliceCycles(), 1u);   // half a cycle per kSlice, rounded up
+
+    // 5 cycles at 500 Hz: 10 ms, not a busy loop of empty slices.
+    const auto start = TimingCircuit::Clock::now();
+    for (int slice = 0; slice < 5; ++slice) {
+        timing.pace(timing.sliceCycles());
+    }
+    EXPECT_GE(TimingCircuit::Clock::now() - start, std::chrono::milliseconds(10) - std::chrono::microseconds(50));
+}
+
+} // namespace
@@ -10,14 +10,20 @@
  *   - a non-zero loaded bank reads the module image and ignores writes,
  *   - switching back to bank 0 restores the original RAM contents,
  *   - addresses just outside the window are unaffected,
- *   - an uninstalled non-zero bank reads as open bus ($00).
+ *   - an uninstalled non-zero bank reads as open bus ($00),
+ *   - RAM_BANK ($FE29) swaps lazily allocated expansion RAM in at bank 0.
  */
 
 #include <gtest/gtest.h>
 
+#include <bitset>
+#include <filesystem>
+#include <fstream>
 #include <vector>
 
+#include "computer/BusDevice.h"
 #include "computer/Memory.h"
+#include "computer/VIC.h"
 
 using Computer::Memory;
 
@@ -223,4 +229,333 @@ TEST_F(MemoryBankingTest, ShortImageIsZeroPadded) {
     EXPECT_EQ(mem.read(kWinEnd), 0x00);       // padded
 }
 
+// --- Page table ------------------------------------------------------------
+
+TEST_F(MemoryBankingTest, ReloadingSelectedBankRemapsWindow) {
+    mem.loadBank(2, makeImage(0x11));
+    mem.write(kBankReg, 2);
+    EXPECT_EQ(mem.read(kWinStart), 0x11);
+    mem.loadBank(2, makeImage(0x22)); // replaces the image under the window
+    EXPECT_EQ(mem.read(kWinStart), 0x22);
+    EXPECT_EQ(mem.read(kWinEnd), static_cast<uint8_t>(0xFF ^ 0x22));
+}
+
+TEST_F(MemoryBankingTest, CopyHasItsOwnPages) {
+    mem.loadDosRom(makeDosImage(0x33));
+    mem.write(0x1234, 0x56);
+    Memory copy = mem;
+    copy.write(0x1234, 0x78);
+    EXPECT_EQ(mem.read(0x1234), 0x56);
+    EXPECT_EQ(copy.read(0x1234), 0x78);
+    EXPECT_EQ(copy.read(kDosStart), 0x33);
+    copy.write(kDosStart, 0x00);           // still ROM in the copy
+    EXPECT_EQ(copy.read(kDosStart), 0x33);
+}
+
+// --- Module ROM files ---------------------------------------------------------
+
+TEST_F(MemoryBankingTest, BankFileIsMappedWhenSelected) {
+    const std::filesystem::path path = std::filesystem::temp_directory_path() / "memory_banking_bank.rom";
+    {
+        const std::vector<uint8_t> image = makeImage(0x5A);
+        std::ofstream file(path, std::ios::binary);
+        file.write(reinterpret_cast<const char *>(image.data()), 100); // short image
+    }
+    ASSERT_TRUE(mem.loadBankFile(4, path.string()));
+    EXPECT_TRUE(mem.isBankLoaded(4));
+
+    Memory copy = mem; // shares the arena
+    mem.write(kBankReg, 4);
+    EXPECT_EQ(mem.read(kWinStart), 0x5A);
+    EXPECT_EQ(mem.read(kWinStart + 99), static_cast<uint8_t>(99 ^ 0x5A));
+    EXPECT_EQ(mem.read(kWinStart + 100), 0x00); // padded
+    EXPECT_EQ(mem.read(kWinEnd), 0x00);
+    mem.write(kWinStart, 0x00);                 // still read-only
+    EXPECT_EQ(mem.read(kWinStart), 0x5A);
+
+    copy.loadBank(4, makeImage(0x11));          // unshares; mem keeps the file
+    copy.selectBank(4);
+    EXPECT_EQ(copy.read(kWinStart), 0x11);
+    EXPECT_EQ(mem.read(kWinStart), 0x5A);
+
+    std::filesystem::remove(path);
+}
+
+TEST_F(MemoryBankingTest, MissingBankFileLeavesBankEmpty) {
+    EXPECT_FALSE(mem.loadBankFile(5, "/nonexistent/module.rom"));
+    EXPECT_FALSE(mem.isBankLoaded(5));
+    EXPECT_FALSE(mem.loadBankFile(0, "/nonexistent/module.rom"));
+}
+
+// --- Bus devices -------------------------------------------------------------
+
+// A one-register latch: reads return the last byte written.
+class LatchDevice : public Computer::BusDevice {
+public:
+    explicit LatchDevice(uint16_t address) : address_(address) {}
+    Computer::BusRange busRange() const override { return {address_, address_}; }
+    uint8_t busRead(uint16_t) override { return value_; }
+    void busWrite(uint16_t, uint8_t value) override { value_ = static_cast<uint8_t>(value ^ 0xFF); }
+
+private:
+    uint16_t address_;
+    uint8_t value_ = 0;
+};
+
+TEST_F(MemoryBankingTest, AttachedDeviceAnswersOnlyItsRange) {
+    LatchDevice latch{0xFE40};
+    mem.write(0xFE41, 0x12);
+    mem.attachDevice(&latch);
+    EXPECT_FALSE(mem.isCodeCacheable(0xFE40));
+    EXPECT_TRUE(mem.isCodeCacheable(0xFE41));
+
+    mem.write(0xFE40, 0x0F);
+    EXPECT_EQ(mem.read(0xFE40), 0xF0);   // the device, not RAM
+    EXPECT_EQ(mem.read(0xFE41), 0x12);   // neighbouring RAM untouched
+
+    mem.detachDevice(&latch);
+    mem.write(0xFE40, 0x0F);
+    EXPECT_EQ(mem.read(0xFE40), 0x0F);   // RAM again
+}
+
+TEST_F(MemoryBankingTest, DeviceOutsideIoPageIsDispatched) {
+    LatchDevice latch{0x3000};
+    mem.attachDevice(&latch);
+    mem.write(0x3000, 0x55);
+    mem.write(0x3001, 0x66);
+    EXPECT_EQ(mem.read(0x3000), 0xAA);
+    EXPECT_EQ(mem.read(0x3001), 0x66);
+}
+
+TEST_F(MemoryBankingTest, BlockRoundTripsFullAddressSpace) {
+    std::vector<uint8_t> image(0x10000);
+    for (size_t i = 0; i < image.size(); ++i) {
+        image[i] = static_cast<uint8_t>(i * 7 + (i >> 8));
+    }
+    image[kBankReg] = 0;   // keep bank 0 selected
+    image[Memory::kRamBankRegister] = 0;   // and the base RAM behind it
+    mem.writeBlock(0x0000, image);
+
+    std::vector<uint8_t> snapshot(0x10000);
+    mem.readBlock(0x0000, snapshot);
+    EXPECT_EQ(snapshot, image);
+    EXPECT_EQ(mem.read(0x1234), image[0x1234]);
+}
+
+TEST_F(MemoryBankingTest, BlockWriteSkipsRomAndWraps) {
+    mem.loadBank(1, makeImage(0x5A));
+    mem.write(kBankReg, 1);
+
+    // Straddles the RAM/ROM boundary at $B000: the ROM half is read-only.
+    const std::vector<uint8_t> data(0x20, 0xEE);
+    mem.writeBlock(kWinStart - 0x10, data);
+    std::vector<uint8_t> back(0x20);
+    mem.readBlock(kWinStart - 0x10, back);
+    for (size_t i = 0; i < back.size(); ++i) {
+        EXPECT_EQ(back[i], i < 0x10 ? 0xEE : makeImage(0x5A)[i - 0x10]) << i;
+    }
+
+    // Wraps from $FFFF to $0000.
+    const std::vector<uint8_t> pair{0x11, 0x22};
+    mem.writeBlock(0xFFFF, pair);
+    EXPECT_EQ(mem.read(0x0000), 0x22);
+}
+
+TEST_F(MemoryBankingTest, BlockAccessGoesThroughDevices) {
+    LatchDevice latch{0xFE40};
+    mem.attachDevice(&latch);
+    const std::vector<uint8_t> data{0x01, 0x02, 0x03};
+    mem.writeBlock(0xFE3F, data);
+
+    std::vector<uint8_t> back(3);
+    mem.readBlock(0xFE3F, back);
+    EXPECT_EQ(back[0], 0x01);
+    EXPECT_EQ(back[1], 0xFD);   // the device's inverted latch
+    EXPECT_EQ(back[2], 0x03);
+}
+
+TEST_F(MemoryBankingTest, CheckpointHoldsOnlyChangedPages) {
+    EXPECT_TRUE(mem.dirtyPages().all());   // no checkpoint yet
+    Memory replica = mem;
+    replica.applyDelta(mem.checkpoint());
+    EXPECT_TRUE(mem.dirtyPages().none());
+
+    mem.write(0x0210, 0x42);
+    mem.write(0x0211, 0x43);
+    mem.write(0x8FFF, 0x99);
+    mem.write(0x3000, 0x00);               // same value: not a change
+    mem.loadBank(2, makeImage(0x11));
+    mem.write(kBankReg, 2);
+    mem.write(0xB000, 0x77);               // ROM: ignored
+
+    const Computer::MemoryDelta delta = mem.checkpoint();
+    EXPECT_EQ(delta.pages, (std::vector<uint8_t>{0x02, 0x8F}));
+    EXPECT_EQ(delta.data.size(), 2 * Computer::MemoryDelta::kPageSize);
+    EXPECT_EQ(delta.bank, 2);
+    EXPECT_TRUE(mem.dirtyPages().none());
+
+    replica.loadBank(2, makeImage(0x11));
+    replica.applyDelta(delta);
+    EXPECT_EQ(replica.read(0x0211), 0x43);
+    EXPECT_EQ(replica.read(0x8FFF), 0x99);
+    EXPECT_EQ(replica.currentBank(), 2);
+    EXPECT_EQ(replica.read(0xB000), mem.read(0xB000));
+}
+
+TEST_F(MemoryBankingTest, WatchedAccessesAreLoggedAcrossBankSwitches) {
+    mem.loadBank(1, makeImage(0x33));
+    mem.write(kWinStart + 5, 0x66);                 // bank 0 RAM
+    mem.watch(kWinStart + 5, Computer::kWatchRead | Computer::kWatchWrite);
+    EXPECT_EQ(mem.codePage(kWinStart >> 8)[5], 0x66);   // fetches are not watched
+
+    EXPECT_EQ(mem.read(kWinStart + 5), 0x66);
+    EXPECT_EQ(mem.read(kWinStart + 6), 0x00);       // same page, not watched
+    mem.write(kBankReg, 1);
+    mem.write(kWinStart + 5, 0x99);                 // ROM: logged, ignored
+    EXPECT_EQ(mem.read(kWinStart + 5), makeImage(0x33)[5]);
+
+    const auto &log = mem.watchLog();
+    ASSERT_EQ(log.size(), 3u);
+    EXPECT_EQ(log[0].kind, Computer::kWatchRead);
+    EXPECT_EQ(log[0].value, 0x66);
+    EXPECT_EQ(log[1].kind, Computer::kWatchWrite);
+    EXPECT_EQ(log[1].value, 0x99);
+    EXPECT_EQ(log[2].value, makeImage(0x33)[5]);
+
+    mem.clearWatches();
+    EXPECT_FALSE(mem.hasWatches());
+    EXPECT_TRUE(mem.watchLog().empty());
+}
+
+TEST_F(MemoryBankingTest, ExpansionRamBankIsAllocatedOnFirstWrite) {
+    constexpr uint16_t kRamBankReg = Memory::kRamBankRegister;
+    mem.write(kWinStart, 0x11);                     // base RAM
+    mem.write(kRamBankReg, 3);
+    EXPECT_EQ(mem.read(kRamBankReg), 3);
+    EXPECT_EQ(mem.currentRamBank(), 3);
+    EXPECT_EQ(mem.read(kWinStart), 0x00);           // reads do not allocate
+    EXPECT_FALSE(mem.isRamBankAllocated(3));
+
+    const uint32_t generation = mem.pageGeneration(kWinStart >> 8);
+    mem.write(kWinEnd, 0x33);
+    EXPECT_TRUE(mem.isRamBankAllocated(3));
+    EXPECT_EQ(mem.read(kWinEnd), 0x33);
+    EXPECT_EQ(mem.read(kWinStart), 0x00);           // zero-filled
+    EXPECT_EQ(mem.pageGeneration(kWinStart >> 8), generation);
+
+    mem.write(kRamBankReg, 0x15);                   // mirrors bank 5
+    EXPECT_EQ(mem.read(kRamBankReg), 0x15);
+    EXPECT_EQ(mem.currentRamBank(), 5);
+    EXPECT_NE(mem.pageGeneration(kWinStart >> 8), generation);   // decoded code is stale
+    mem.write(kWinEnd, 0x55);
+
+    // A ROM module over the window leaves the RAM bank selection alone.
+    mem.loadBank(1, makeImage(0x44));
+    mem.write(kBankReg, 1);
+    EXPECT_EQ(mem.read(kWinStart), makeImage(0x44)[0]);
+    mem.write(kBankReg, 0);
+    EXPECT_EQ(mem.read(kWinEnd), 0x55);
+
+    mem.selectRamBank(3);
+    EXPECT_EQ(mem.read(kWinEnd), 0x33);
+    mem.selectRamBank(0);
+    EXPECT_EQ(mem.read(kWinStart), 0x11);
+    EXPECT_FALSE(mem.isRamBankAllocated(4));
+}
+
+TEST_F(MemoryBankingTest, CheckpointCarriesExpansionRamBanks) {
+    mem.selectRamBank(2);
+    mem.write(kWinStart + 1, 0x22);
+    mem.selectRamBank(0);
+    Memory replica{nullptr, nullptr};
+    replica.applyDelta(mem.checkpoint());
+    EXPECT_TRUE(replica.isRamBankAllocated(2));
+    replica.selectRamBank(2);
+    EXPECT_EQ(replica.read(kWinStart + 1), 0x22);
+    replica.selectRamBank(0);
+
+    // Only the bank stored to since the checkpoint travels.
+    mem.selectRamBank(7);
+    mem.write(kWinStart + 2, 0x77);
+    Computer::MemoryDelta delta = mem.checkpoint();
+    EXPECT_EQ(delta.ram_banks, std::vector<uint8_t>{7});
+    EXPECT_EQ(delta.ram_bank, 7);
+    replica.applyDelta(delta);
+    EXPECT_EQ(replica.currentRamBank(), 7);
+    EXPECT_EQ(replica.read(kWinStart + 2), 0x77);
+    EXPECT_TRUE(mem.checkpoint().ram_banks.empty());
+}
+
+TEST_F(MemoryBankingTest, CopyHasItsOwnExpansionRam) {
+    mem.selectRamBank(1);
+    mem.write(kWinStart, 0xA1);
+    Memory copy{mem};
+    copy.write(kWinStart, 0xB2);
+    EXPECT_EQ(mem.read(kWinStart), 0xA1);
+    EXPECT_EQ(copy.read(kWinStart), 0xB2);
+    EXPECT_EQ(copy.currentRamBank(), 1);
+}
+
+TEST_F(MemoryBankingTest, ScreenMemoryIsSharedWithVic) {
+    Computer::VIC vic;
+    vic.setCharacterAt(0, 0, 'A');
+    Memory mem{&vic, nullptr};   // declared after the VIC it binds
+    EXPECT_TRUE(mem.isCodeCacheable(Computer::VIC::kScreenMemoryStart));
+    EXPECT_EQ(mem.read(Computer::VIC::kScreenMemoryStart), 'A');   // carried over on bind
+
+    mem.write(Computer::VIC::kScreenMemoryStart + 2 * Computer::VIC::kScreenWidth + 5, 'Z');
+    EXPECT_EQ(vic.getCharacterAt(5, 2), 'Z');
+    vic.setCharacterAt(1, 3, 'Q');
+    EXPECT_EQ(mem.read(Computer::VIC::kScreenMemoryStart + 3 * Computer::VIC::kScreenWidth + 1), 'Q');
+}
+
+TEST_F(MemoryBankingTest, VicEditsDirtyScreenPages) {
+    using Computer::VIC;
+    VIC vic;
+    Memory mem{&vic, nullptr};
+    mem.clearDirtyPages();
+    const uint32_t generation = mem.pageGeneration(5);
+
+    vic.setCharacterAt(0, 7, 'A');   // $0518
+    EXPECT_NE(mem.pageGeneration(5), generation);   // decoded code is stale
+    std::bitset<256> expected;
+    expected.set(5);
+    EXPECT_EQ(mem.dirtyPages(), expected);
+    const Computer::MemoryDelta delta = mem.checkpoint();
+    EXPECT_EQ(delta.pages, (std::vector<uint8_t>{0x05}));
+
+    vic.setCharacterAt(0, 7, 'A');   // same value: not a change
+    EXPECT_TRUE(mem.dirtyPages().none());
+
+    vic.scrollUp();                  // row 7 ($0518) moves to row 6 ($04F0)
+    expected.set(4);
+    EXPECT_EQ(mem.dirtyPages(), expected);
+    EXPECT_EQ(mem.read(VIC::kScreenMemoryStart + 6 * VIC::kScreenWidth), 'A');
+    mem.clearDirtyPages();
+
+    vic.clearScreen();
+    expected.reset(5);
+    EXPECT_EQ(mem.dirtyPages(), expected);   // the rest was already blank
+    vic.clearScreen('*');
+    EXPECT_EQ(mem.dirtyPages().count(), 4u);
+}
+
+TEST_F(MemoryBankingTest, VicReportsOnlyChangedRows) {
+    Computer::VIC vic;
+    Memory mem{&vic, nullptr};
+    EXPECT_EQ(vic.dirtyRows(), Computer::VIC::kAllRows);   // nothing shown yet
+
+    vic.clearDirty();
+    EXPECT_FALSE(vic.isDirty());
+    mem.write(Computer::VIC::kScreenMemoryStart + 7 * Computer::VIC::kScreenWidth + 39, 'x');
+    mem.write(Computer::VIC::kScreenMemoryStart + 24 * Computer::VIC::kScreenWidth, 'y');
+    EXPECT_EQ(vic.dirtyRows(), (1u << 7) | (1u << 24));
+
+    // Writing back what was displayed leaves the row clean.
+    mem.write(Computer::VIC::kScreenMemoryStart + 24 * Computer::VIC::kScreenWidth, 0x20);
+    EXPECT_EQ(vic.dirtyRows(), 1u << 7);
+    vic.clearDirty();
+    EXPECT_EQ(vic.dirtyRows(), 0u);
+}
+
 } // namespace
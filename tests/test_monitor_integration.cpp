@@ -264,7 +264,7 @@ private:
     }
 
     std::string getScreenText() {
-        auto& screen_buffer = computer.getVideoChip()->getScreenBuffer();
+        const auto screen_buffer = computer.getVideoChip()->getScreenBuffer();
         std::string content;
 
         // Convert screen buffer to string
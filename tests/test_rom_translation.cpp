@@ -0,0 +1,160 @@
+/**
+ * @file test_rom_translation.cpp
+ * @brief Unit tests for ahead-of-time ROM translations (tools/romc)
+ *
+ * The build runs romc.py on tests/support/aot_sample.rom twice: once as a
+ * fixed image at $E000 ("sample") and once as module bank 1 at $B000
+ * ("sample_bank1"). The program is a short counting loop:
+ *
+ *   LDX #0 / LDY #0 / loop: CLC / TXA / ADC #3 / TAX / INY / BNE loop /
+ *   INX / BRA *
+ *
+ * Every test runs the same batch with and without the translations and
+ * expects identical registers and cycle counts.
+ */
+
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "computer/CPU6502.h"
+#include "computer/Memory.h"
+#include "computer/RomTranslation.h"
+
+using Computer::AotFrame;
+using Computer::CPU6502;
+using Computer::Memory;
+using Computer::RomTranslation;
+using Computer::RomTranslations;
+
+namespace {
+
+constexpr uint16_t kFixedBase = 0xE000;
+constexpr uint8_t kSampleBank = 1;
+constexpr uint64_t kBudget = 20000;  // enough to leave the 256-pass loop
+
+const RomTranslation *builtin(const char *name) {
+    for (const RomTranslation *translation : RomTranslations::builtin()) {
+        if (std::strcmp(translation->name, name) == 0) {
+            return translation;
+        }
+    }
+    return nullptr;
+}
+
+std::vector<uint8_t> sampleImage() {
+    std::ifstream file(AOT_SAMPLE_ROM, std::ios::binary);
+    return {std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()};
+}
+
+class RomTranslationTest : public ::testing::Test {
+protected:
+    Memory mem{nullptr, nullptr};
+    CPU6502 cpu{mem};
+    Memory ref_mem{nullptr, nullptr};
+    CPU6502 ref{ref_mem};
+    RomTranslations translations;
+
+    void SetUp() override {
+        image = sampleImage();
+        ASSERT_EQ(image.size(), 16u);
+    }
+
+    // Both machines run kBudget cycles from pc; only cpu uses translations.
+    void runBoth(const uint16_t pc) {
+        cpu.reg.PC = pc;
+        ref.reg.PC = pc;
+        cpu.runCycles(kBudget);
+        ref.runCycles(kBudget);
+    }
+
+    void expectSameState() const {
+        EXPECT_EQ(cpu.reg.A, ref.reg.A);
+        EXPECT_EQ(cpu.reg.X, ref.reg.X);
+        EXPECT_EQ(cpu.reg.Y, ref.reg.Y);
+        EXPECT_EQ(cpu.reg.PC, ref.reg.PC);
+        EXPECT_EQ(cpu.reg.P, ref.reg.P);
+        EXPECT_EQ(cpu.getCycles(), ref.getCycles());
+    }
+
+    std::vector<uint8_t> image;
+};
+
+} // namespace
+
+TEST_F(RomTranslationTest, GeneratedTranslationsAreRegistered) {
+    const RomTranslation *fixed = builtin("sample");
+    ASSERT_NE(fixed, nullptr);
+    EXPECT_EQ(fixed->base, kFixedBase);
+    EXPECT_EQ(fixed->bank, -1);
+    EXPECT_EQ(std::vector<uint8_t>(fixed->image, fixed->image + fixed->size), image);
+    EXPECT_GT(fixed->block_count, 0u);
+
+    const RomTranslation *banked = builtin("sample_bank1");
+    ASSERT_NE(banked, nullptr);
+    EXPECT_EQ(banked->base, Memory::kModuleWindowStart);
+    EXPECT_EQ(banked->bank, kSampleBank);
+}
+
+TEST_F(RomTranslationTest, TranslatedRunMatchesInterpreter) {
+    mem.loadProgram(image, kFixedBase);
+    ref_mem.loadProgram(image, kFixedBase);
+    translations.add(*builtin("sample"));
+    ASSERT_EQ(translations.bind(mem), builtin("sample")->block_count);
+    cpu.setRomTranslations(&translations);
+
+    AotFrame frame{nullptr, &mem, 0, nullptr};
+    EXPECT_NE(translations.find(mem, kFixedBase, frame), nullptr);
+
+    runBoth(kFixedBase);
+    expectSameState();
+    EXPECT_EQ(cpu.reg.PC, kFixedBase + 0x0D);  // parked on BRA *
+}
+
+TEST_F(RomTranslationTest, UnmatchedImageIsNotBound) {
+    std::vector<uint8_t> other = image;
+    other[7] = 0x05;  // ADC #5: not the bytes the translation was made from
+    mem.loadProgram(other, kFixedBase);
+    translations.add(*builtin("sample"));
+    // Only the loop block differs; the blocks around it still bind.
+    EXPECT_EQ(translations.bind(mem), builtin("sample")->block_count - 1);
+}
+
+TEST_F(RomTranslationTest, RewrittenCodeRetiresTranslation) {
+    mem.loadProgram(image, kFixedBase);
+    ref_mem.loadProgram(image, kFixedBase);
+    translations.add(*builtin("sample"));
+    translations.bind(mem);
+    cpu.setRomTranslations(&translations);
+
+    // Patch ADC #3 into ADC #5 after binding.
+    mem.write(kFixedBase + 7, 0x05);
+    ref_mem.write(kFixedBase + 7, 0x05);
+
+    AotFrame frame{nullptr, &mem, 0, nullptr};
+    EXPECT_EQ(translations.find(mem, kFixedBase + 4, frame), nullptr);
+
+    runBoth(kFixedBase);
+    expectSameState();
+}
+
+TEST_F(RomTranslationTest, BankedTranslationFollowsSelectedBank) {
+    mem.loadBank(kSampleBank, image);
+    ref_mem.loadBank(kSampleBank, image);
+    translations.add(*builtin("sample_bank1"));
+    ASSERT_GT(translations.bind(mem), 0u);
+    cpu.setRomTranslations(&translations);
+
+    AotFrame frame{nullptr, &mem, 0, nullptr};
+    EXPECT_EQ(translations.find(mem, Memory::kModuleWindowStart, frame), nullptr);
+
+    mem.selectBank(kSampleBank);
+    ref_mem.selectBank(kSampleBank);
+    EXPECT_NE(translations.find(mem, Memory::kModuleWindowStart, frame), nullptr);
+
+    runBoth(Memory::kModuleWindowStart);
+    expectSameState();
+}
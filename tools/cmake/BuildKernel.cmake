@@ -30,6 +30,7 @@ if(CA65_FOUND AND LD65_FOUND)
         COMMAND ${CMAKE_COMMAND} -E echo "================================================================"
         COMMENT "Building kernel ROM in build directory"
         WORKING_DIRECTORY ${CMAKE_BINARY_DIR}/kernel
+        BYPRODUCTS ${KERNEL_ROM} ${KERNEL_MAP}
         DEPENDS ${KERNEL_ASM_SOURCE} ${KERNEL_CONFIG}
         VERBATIM
     )
@@ -61,6 +62,7 @@ if(CA65_FOUND AND LD65_FOUND)
         COMMAND ${CMAKE_COMMAND} -DBASIC_ROM_FILE=${BASIC_ROM} -P ${CMAKE_SOURCE_DIR}/tools/cmake/check_basic_size.cmake
         COMMENT "Building BASIC ROM"
         WORKING_DIRECTORY ${CMAKE_BINARY_DIR}/kernel
+        BYPRODUCTS ${BASIC_ROM} ${BASIC_MAP}
         DEPENDS ${BASIC_ASM_SOURCE} ${BASIC_CONFIG}
         VERBATIM
     )
@@ -85,6 +87,7 @@ if(CA65_FOUND AND LD65_FOUND)
         COMMAND ${CMAKE_COMMAND} -E echo "ASSEMBLER module ROM built (bank 2)"
         COMMENT "Building ASSEMBLER module ROM"
         WORKING_DIRECTORY ${CMAKE_BINARY_DIR}/kernel
+        BYPRODUCTS ${ASSEMBLER_ROM} ${ASSEMBLER_MAP}
         DEPENDS ${ASSEMBLER_ASM_SOURCE} ${ASSEMBLER_CONFIG} ${ASSEMBLER_INC}
         VERBATIM
     )
@@ -107,10 +110,47 @@ if(CA65_FOUND AND LD65_FOUND)
         COMMAND ${CMAKE_COMMAND} -E echo "MFC-DOS resident ROM built ($9000-$AFFF)"
         COMMENT "Building MFC-DOS resident ROM"
         WORKING_DIRECTORY ${CMAKE_BINARY_DIR}/kernel
+        BYPRODUCTS ${DOS_ROM} ${DOS_MAP}
         DEPENDS ${DOS_ASM_SOURCE} ${DOS_CONFIG}
         VERBATIM
     )
 
+    # ================================================================
+    # Ahead-of-time ROM translations (tools/romc)
+    # ================================================================
+
+    # Each ROM is translated into C++ (one function per basic block) and
+    # linked into the emulator; CPU6502::runCycles() runs those blocks
+    # directly. The translation is re-generated whenever its ROM changes.
+    find_program(ROMC_PYTHON NAMES python3 python)
+    option(CPU6502_AOT_ROMS "Link ahead-of-time translations of the ROM images" ON)
+
+    if(CPU6502_AOT_ROMS AND ROMC_PYTHON)
+        set(ROMC ${CMAKE_SOURCE_DIR}/tools/romc/romc.py)
+        set(ROMC_OPCODES ${CMAKE_SOURCE_DIR}/include/computer/CPU6502Instructions.h)
+        file(MAKE_DIRECTORY ${CMAKE_BINARY_DIR}/aot)
+
+        # translate_rom(<name> <rom target> <rom> <map> <base> <bank>)
+        function(translate_rom name rom_target rom map base bank)
+            set(output ${CMAKE_BINARY_DIR}/aot/${name}_aot.cpp)
+            add_custom_command(
+                OUTPUT ${output}
+                COMMAND ${ROMC_PYTHON} ${ROMC} --rom ${rom} --map ${map} --base ${base}
+                        --bank ${bank} --name ${name} -o ${output}
+                DEPENDS ${rom_target} ${rom} ${map} ${ROMC} ${ROMC_OPCODES}
+                COMMENT "Translating ${name} ROM"
+                VERBATIM
+            )
+            target_sources(6502-kernel PRIVATE ${output})
+        endfunction()
+
+        translate_rom(kernel kernel_rom ${KERNEL_ROM} ${KERNEL_MAP} 0xE000 -1)
+        translate_rom(dos dos_rom ${DOS_ROM} ${DOS_MAP} 0x9000 -1)
+        translate_rom(basic basic_rom ${BASIC_ROM} ${BASIC_MAP} 0xB000 1)
+        translate_rom(assembler assembler_rom ${ASSEMBLER_ROM} ${ASSEMBLER_MAP} 0xB000 2)
+        message(STATUS "ROM images will be translated ahead of time (CPU6502_AOT_ROMS)")
+    endif()
+
 else()
     message(WARNING "cc65 toolchain not found. Please install ca65 and ld65 to build kernel ROM automatically.")
     message(STATUS "You can manually build the kernel ROM with:")
@@ -2,11 +2,12 @@
 """Generate the canonical 65C02 opcode/addressing-mode table from the emulator.
 
 The single source of truth for which opcodes exist and how they decode is the
-CPU6502 emulator's handler map (src/computer/CPU6502.cpp). That CPU is validated
-against the Klaus2m5/amb5l functional, decimal, and 65C02-extended test suites,
-so its handler set IS the WDC W65C02S instruction set as this project defines it.
+CPU6502 emulator's opcode table (CPU6502_OPCODE_TABLE in
+include/computer/CPU6502Instructions.h). That CPU is validated against the
+Klaus2m5/amb5l functional, decimal, and 65C02-extended test suites, so its
+opcode table IS the WDC W65C02S instruction set as this project defines it.
 
-This script parses those handler registrations and emits:
+This script parses those X(opcode, Operation, Mode, Cycles) entries and emits:
   * src/kernel/assembler/opcodes_65c02.inc - ca65 tables for the assembler/
     disassembler module (Phase 4): per-opcode mnemonic id + mode id, the
     mnemonic strings, and per-mode operand length.
@@ -14,7 +15,7 @@ This script parses those handler registrations and emits:
 
 Run with --check to regenerate in memory and fail (exit 1) if the committed
 files are stale - this is wired into ctest so the table can never silently
-drift from CPU6502.cpp. Regenerate (no --check) after changing CPU opcodes.
+drift from the CPU. Regenerate (no --check) after changing CPU opcodes.
 """
 
 import os
@@ -22,41 +23,35 @@ import re
 import sys
 
 REPO_ROOT = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
-CPU_SRC = os.path.join(REPO_ROOT, "src", "computer", "CPU6502.cpp")
+CPU_SRC = os.path.join(REPO_ROOT, "include", "computer", "CPU6502Instructions.h")
+CPU_SRC_REL = "include/computer/CPU6502Instructions.h"
 INC_OUT = os.path.join(REPO_ROOT, "src", "kernel", "assembler", "opcodes_65c02.inc")
 MD_OUT = os.path.join(REPO_ROOT, "docs", "opcode_table_65c02.md")
 
-# Branch mnemonics use relative addressing; every other zero-suffix handler is
-# implied. (The handler name carries no mode suffix for either, so we split them
-# here.)
-BRANCHES = {"BPL", "BMI", "BVC", "BVS", "BCC", "BCS", "BNE", "BEQ", "BRA"}
-
-# Handler-name mode suffix -> (mode id, asm operand template, byte length).
-# The template uses {} for the operand value; %02X / %04X picked by the renderer.
-MODE_SUFFIX = {
-    "":                         None,  # resolved to IMP or REL by mnemonic
-    "Accumulator":              ("ACC", "A",          1),
-    "Immediate":                ("IMM", "#${:02X}",   2),
-    "ZeroPage":                 ("ZP",  "${:02X}",    2),
-    "ZeroPageX":                ("ZPX", "${:02X},X",  2),
-    "ZeroPageY":                ("ZPY", "${:02X},Y",  2),
-    "ZeroPageIndirect":         ("ZPI", "(${:02X})",  2),
-    "IndexedIndirect":          ("IZX", "(${:02X},X)", 2),
-    "IndirectIndexed":          ("IZY", "(${:02X}),Y", 2),
-    "Absolute":                 ("ABS", "${:04X}",    3),
-    "AbsoluteX":                ("ABX", "${:04X},X",  3),
-    "AbsoluteY":                ("ABY", "${:04X},Y",  3),
-    "Indirect":                 ("IND", "(${:04X})",  3),
-    "AbsoluteIndexedIndirect":  ("AIX", "(${:04X},X)", 3),
+# Addressing-mode policy name -> mode id. Undefined1/2/3 are the 65C02's
+# deterministic 1/2/3-byte NOPs; they are rendered as raw bytes by the
+# disassembler and never emitted by the assembler.
+MODE_POLICY = {
+    "Implied":                  "IMP",
+    "Accumulator":              "ACC",
+    "Immediate":                "IMM",
+    "ZeroPage":                 "ZP",
+    "ZeroPageX":                "ZPX",
+    "ZeroPageY":                "ZPY",
+    "ZeroPageIndirect":         "ZPI",
+    "IndexedIndirect":          "IZX",
+    "IndirectIndexed":          "IZY",
+    "Relative":                 "REL",
+    "Absolute":                 "ABS",
+    "AbsoluteX":                "ABX",
+    "AbsoluteY":                "ABY",
+    "Indirect":                 "IND",
+    "AbsoluteIndexedIndirect":  "AIX",
+    "ZeroPageRelative":         "ZPR",
+    "Undefined1":               "UN1",
+    "Undefined2":               "UN2",
+    "Undefined3":               "UN3",
 }
-MODE_IMP = ("IMP", "",          1)
-MODE_REL = ("REL", "${:04X}",   2)  # disassembler resolves the target address
-# Bit ops (added by formula, not parsed): RMBn/SMBn zp, BBRn/BBSn zp,rel.
-MODE_ZP_BIT = ("ZP",  "${:02X}",          2)
-MODE_ZPREL  = ("ZPR", "${:02X},${:04X}",  3)
-# Synthetic modes for undefined opcodes (deterministic multi-byte NOPs on the
-# 65C02). Rendered as raw bytes by the disassembler; never emitted by the asm.
-MODE_UND = {1: ("UN1", "", 1), 2: ("UN2", "", 2), 3: ("UN3", "", 3)}
 
 # Stable mode ordering for the emitted MODE_LEN table / mode ids.
 MODE_ORDER = ["IMP", "ACC", "IMM", "ZP", "ZPX", "ZPY", "ZPI", "IZX", "IZY",
@@ -68,8 +63,9 @@ MODE_LEN = {
     "AIX": 3, "ZPR": 3, "UN1": 1, "UN2": 2, "UN3": 3,
 }
 
-DIRECT_RE = re.compile(
-    r"handlers_\[(0x[0-9A-Fa-f]+)\]\s*=\s*\[this\]\(\)\s*\{\s*handle([A-Za-z0-9]+)\(\);")
+# X(0xNN, Operation, Mode, Cycles); bit ops carry their bit as Rmb<3> etc.
+ENTRY_RE = re.compile(
+    r"X\((0x[0-9A-Fa-f]{2}),\s*([A-Za-z]+)(?:<(\d)>)?,\s*([A-Za-z0-9]+),\s*\d+\)")
 
 
 def build_table():
@@ -79,47 +75,20 @@ def build_table():
 
     # opcode -> (mnemonic, mode_id)
     table = {}
-
-    # 1) Directly registered, single-operation handlers (handle<Mnem><Mode>()).
-    for m in DIRECT_RE.finditer(src):
+    for m in ENTRY_RE.finditer(src):
         opcode = int(m.group(1), 16)
-        name = m.group(2)
-        mnem = name[:3].upper()           # all 6502 mnemonics are 3 letters
-        suffix = name[3:]
-        mode_info = MODE_SUFFIX.get(suffix)
-        if mode_info is None:
-            if suffix != "":
-                raise SystemExit(f"Unknown mode suffix '{suffix}' in handle{name}")
-            # No mode suffix: branches are relative, JSR is the one absolute op
-            # whose handler carries no suffix (handleJsr), everything else implied.
-            if mnem in BRANCHES:
-                mode_info = MODE_REL
-            elif mnem == "JSR":
-                mode_info = MODE_SUFFIX["Absolute"]
-            else:
-                mode_info = MODE_IMP
-        table[opcode] = (mnem, mode_info[0])
-
-    # 2) Rockwell/WDC bit ops, registered in a loop in CPU6502.cpp:
-    #    RMBn $07+n*$10, SMBn $87+n*$10 (zp); BBRn $0F+n*$10, BBSn $8F+n*$10 (zp,rel).
-    for n in range(8):
-        table[0x07 + n * 0x10] = (f"RMB{n}", MODE_ZP_BIT[0])
-        table[0x87 + n * 0x10] = (f"SMB{n}", MODE_ZP_BIT[0])
-        table[0x0F + n * 0x10] = (f"BBR{n}", MODE_ZPREL[0])
-        table[0x8F + n * 0x10] = (f"BBS{n}", MODE_ZPREL[0])
-
-    # 3) Undefined opcodes -> deterministic NOPs of 1/2/3 bytes (per the WDC
-    #    datasheet / CPU6502's NOP-family loops). Fill whatever is left.
-    nop1 = ([op for op in range(0x03, 0x100, 0x10)] +
-            [op for op in range(0x0B, 0x100, 0x10) if op not in (0xCB, 0xDB)])
-    nop2 = [0x02, 0x22, 0x42, 0x62, 0x82, 0xC2, 0xE2, 0x44, 0x54, 0xD4, 0xF4]
-    nop3 = [0x5C, 0xDC, 0xFC]
-    for op in nop1:
-        table.setdefault(op, ("???", MODE_UND[1][0]))
-    for op in nop2:
-        table.setdefault(op, ("???", MODE_UND[2][0]))
-    for op in nop3:
-        table.setdefault(op, ("???", MODE_UND[3][0]))
+        operation, bit, policy = m.group(2), m.group(3), m.group(4)
+        mode = MODE_POLICY.get(policy)
+        if mode is None:
+            raise SystemExit(f"Unknown addressing mode '{policy}' for ${opcode:02X}")
+        if opcode in table:
+            raise SystemExit(f"Opcode ${opcode:02X} listed twice")
+        if mode.startswith("UN"):
+            mnem = "???"
+        else:
+            # RMBn/SMBn/BBRn/BBSn carry the bit number as a template argument.
+            mnem = operation.upper() + (bit or "")
+        table[opcode] = (mnem, mode)
 
     missing = [op for op in range(256) if op not in table]
     if missing:
@@ -150,7 +119,7 @@ def emit_inc(table):
     lines.append("; ===================================================================")
     lines.append("; opcodes_65c02.inc - canonical 65C02 opcode/addressing-mode table")
     lines.append("; ===================================================================")
-    lines.append("; AUTO-GENERATED by tools/gen_opcode_table.py from src/computer/CPU6502.cpp.")
+    lines.append(f"; AUTO-GENERATED by tools/gen_opcode_table.py from {CPU_SRC_REL}.")
     lines.append("; DO NOT EDIT BY HAND. Regenerate after changing CPU6502 opcode handlers;")
     lines.append("; the memory_opcode_table ctest fails if this file is stale.")
     lines.append(";")
@@ -202,7 +171,7 @@ def emit_md(table):
     lines.append("# Canonical 65C02 Opcode Table")
     lines.append("")
     lines.append("Auto-generated by `tools/gen_opcode_table.py` from "
-                 "`src/computer/CPU6502.cpp` (the validated W65C02S emulator) - "
+                 f"`{CPU_SRC_REL}` (the validated W65C02S emulator) - "
                  "**do not edit by hand**. This is the single source of truth for the "
                  "Phase 4 assembler/disassembler module. Regenerate after changing "
                  "CPU opcode handlers; the `memory_opcode_table` test fails if stale.")
@@ -0,0 +1,286 @@
+#!/usr/bin/env python3
+"""Ahead-of-time translate a 65C02 ROM image into C++.
+
+The kernel, DOS, BASIC and assembler ROMs never change while the emulator
+runs, so their code can be translated once at build time instead of being
+decoded over and over. This tool walks the code reachable from the ROM's
+entry points (the hardware vectors, the ld65 map's exports and any --entry
+addresses), splits it into basic blocks and emits one C++ function per block.
+Each function is a straight run of Computer::aotStep<Op, Mode, Cycles>()
+calls, the same instruction bodies the interpreter uses (taken from
+CPU6502_OPCODE_TABLE in include/computer/CPU6502Instructions.h), with the
+operand bytes as constants for the compiler to fold.
+
+Blocks follow the interpreter's block rules: at most 16 instructions, never
+leaving the 256-byte page they start in, and ending after the opcodes listed
+in Isa::endsBlock(). The emulator checks each block's bytes against memory
+before using it (see RomTranslations::bind), so a stale translation is
+ignored rather than trusted.
+
+Usage:
+  romc.py --rom kernel.rom --base 0xE000 [--map kernel.map] [--bank N]
+          [--entry 0xE123 ...] --name kernel -o kernel_aot.cpp
+"""
+
+import argparse
+import os
+import re
+import sys
+
+REPO_ROOT = os.path.dirname(os.path.dirname(os.path.dirname(os.path.abspath(__file__))))
+CPU_SRC = os.path.join(REPO_ROOT, "include", "computer", "CPU6502Instructions.h")
+
+ENTRY_RE = re.compile(r"X\((0x[0-9A-Fa-f]{2}),\s*([A-Za-z]+(?:<\d>)?),\s*([A-Za-z0-9]+),\s*(\d+)\)")
+ENDS_BLOCK_RE = re.compile(r"constexpr bool endsBlock\(.*?\)\s*\{(.*?)return true;", re.S)
+CASE_RE = re.compile(r"case (0x[0-9A-Fa-f]{2}):")
+EXPORT_RE = re.compile(r"([A-Za-z_.@][\w.@]*)\s+([0-9A-Fa-f]{6})\s+[A-Z]{2,3}")
+
+# Operand bytes per addressing-mode policy (ModeTraits::kOperandBytes).
+MODE_BYTES = {
+    "Implied": 0, "Accumulator": 0, "Immediate": 1,
+    "ZeroPage": 1, "ZeroPageX": 1, "ZeroPageY": 1, "ZeroPageIndirect": 1,
+    "IndexedIndirect": 1, "IndirectIndexed": 1, "Relative": 1,
+    "Absolute": 2, "AbsoluteX": 2, "AbsoluteY": 2, "Indirect": 2,
+    "AbsoluteIndexedIndirect": 2, "ZeroPageRelative": 2,
+    "Undefined1": 0, "Undefined2": 1, "Undefined3": 2,
+}
+
+MAX_BLOCK_INSTRUCTIONS = 16  # BlockCache::kMaxInstructions
+
+# Opcodes after which execution does not fall through to the next byte.
+NO_FALLTHROUGH = {0x40, 0x4C, 0x60, 0x6C, 0x7C, 0x80, 0xDB}  # RTI JMP RTS JMP JMP BRA STP
+JSR, JMP_ABS, BRK = 0x20, 0x4C, 0x00
+
+
+def load_opcode_table():
+    with open(CPU_SRC, encoding="utf-8") as f:
+        text = f.read()
+    table = {}
+    for m in ENTRY_RE.finditer(text):
+        opcode = int(m.group(1), 16)
+        table[opcode] = (m.group(2), m.group(3), int(m.group(4)))
+    if len(table) != 256:
+        sys.exit(f"romc: expected 256 opcodes in {CPU_SRC}, found {len(table)}")
+    ends = ENDS_BLOCK_RE.search(text)
+    if not ends:
+        sys.exit(f"romc: endsBlock() not found in {CPU_SRC}")
+    ends_block = {int(c, 16) for c in CASE_RE.findall(ends.group(1))}
+    return table, ends_block
+
+
+def parse_exports(map_path):
+    """Exported symbol values from an ld65 map file ("Exports list by name")."""
+    values = []
+    in_exports = False
+    with open(map_path, encoding="utf-8", errors="replace") as f:
+        for line in f:
+            if line.startswith("Exports list by name"):
+                in_exports = True
+                continue
+            if in_exports:
+                if line.startswith("Exports list by value") or line.startswith("Imports list"):
+                    break
+                values.extend(int(m.group(2), 16) for m in EXPORT_RE.finditer(line))
+    return values
+
+
+class Rom:
+    def __init__(self, image, base, table):
+        self.image = image
+        self.base = base
+        self.table = table
+
+    def contains(self, address, length=1):
+        return self.base <= address and address + length <= self.base + len(self.image)
+
+    def byte(self, address):
+        return self.image[address - self.base]
+
+    def word(self, address):
+        return self.byte(address) | (self.byte(address + 1) << 8)
+
+    def decode(self, address):
+        """(opcode, op, mode, cycles, length, operands) or None off the image."""
+        if not self.contains(address):
+            return None
+        opcode = self.byte(address)
+        op, mode, cycles = self.table[opcode]
+        length = 1 + MODE_BYTES[mode]
+        if not self.contains(address, length):
+            return None
+        operands = [self.byte(address + 1 + i) for i in range(length - 1)]
+        return opcode, op, mode, cycles, length, operands
+
+
+def signed(byte):
+    return byte - 0x100 if byte & 0x80 else byte
+
+
+def successors(address, insn):
+    """Addresses control can reach after the instruction at address."""
+    opcode, _, mode, _, length, operands = insn
+    nxt = (address + length) & 0xFFFF
+    out = []
+    if opcode not in NO_FALLTHROUGH:
+        out.append(nxt)
+    if opcode == BRK:
+        out.append((address + 2) & 0xFFFF)  # RTI returns past the signature byte
+    if mode == "Relative":
+        out.append((nxt + signed(operands[0])) & 0xFFFF)
+    elif mode == "ZeroPageRelative":
+        out.append((nxt + signed(operands[1])) & 0xFFFF)
+    elif opcode in (JMP_ABS, JSR):
+        out.append(operands[0] | (operands[1] << 8))
+    return out
+
+
+def find_code(rom, entries):
+    """Recursive descent: instruction starts and block leaders."""
+    starts = set()
+    leaders = set(e for e in entries if rom.contains(e))
+    work = sorted(leaders)
+    while work:
+        address = work.pop()
+        if address in starts:
+            continue
+        insn = rom.decode(address)
+        if insn is None:
+            continue
+        starts.add(address)
+        opcode, length = insn[0], insn[4]
+        for target in successors(address, insn):
+            if not rom.contains(target):
+                continue
+            # Jump targets and return addresses start blocks; an untaken
+            # branch falls through inside its block, as in BlockCache.
+            if target != ((address + length) & 0xFFFF) or opcode in (JSR, BRK):
+                leaders.add(target)
+            work.append(target)
+    return starts, leaders
+
+
+def build_blocks(rom, starts, leaders, ends_block):
+    blocks = {}
+    pending = sorted(leaders)
+    while pending:
+        leader = pending.pop()
+        if leader in blocks or leader not in starts:
+            continue
+        page = leader >> 8
+        insns = []
+        address = leader
+        while len(insns) < MAX_BLOCK_INSTRUCTIONS:
+            if insns and address in leaders:
+                break  # the next block takes over
+            insn = rom.decode(address)
+            if insn is None or address not in starts:
+                break
+            length = insn[4]
+            if (address >> 8) != page or ((address + length - 1) >> 8) != page:
+                break  # page-straddling instruction: left to the interpreter
+            insns.append((address, insn))
+            address = (address + length) & 0xFFFF
+            if insn[0] in ends_block:
+                break
+        if not insns:
+            continue
+        blocks[leader] = insns
+        last_address, last = insns[-1]
+        follow = (last_address + last[4]) & 0xFFFF
+        if last[0] not in NO_FALLTHROUGH and follow in starts and follow not in leaders:
+            # Cut by length or page end: continue in a block of its own.
+            leaders.add(follow)
+            pending.append(follow)
+    return blocks
+
+
+def emit(name, rom, bank, blocks, source_names):
+    out = []
+    out.append(f"// Generated by tools/romc/romc.py from {', '.join(source_names)} - do not edit.")
+    out.append("")
+    out.append('#include "RomTranslation.h"')
+    out.append("")
+    out.append("namespace Computer")
+    out.append("{")
+    out.append("    namespace")
+    out.append("    {")
+    out.append(f"        const uint8_t kImage[{len(rom.image)}] = {{")
+    for i in range(0, len(rom.image), 16):
+        chunk = ", ".join(f"0x{b:02X}" for b in rom.image[i:i + 16])
+        out.append(f"            {chunk},")
+    out.append("        };")
+    for leader in sorted(blocks):
+        out.append("")
+        out.append(f"        void block_{leader:04X}(AotFrame &f)")
+        out.append("        {")
+        insns = blocks[leader]
+        for index, (address, insn) in enumerate(insns):
+            _, op, mode, cycles, _, operands = insn
+            lo = operands[0] if len(operands) > 0 else 0
+            hi = operands[1] if len(operands) > 1 else 0
+            call = f"aotStep<Isa::{op}, Isa::{mode}, {cycles}>(f, 0x{lo:02X}, 0x{hi:02X})"
+            comment = f"  // ${address:04X}"
+            if index + 1 < len(insns):
+                out.append(f"            if (!{call}) return;{comment}")
+            else:
+                out.append(f"            (void){call};{comment}")
+        out.append("        }")
+    out.append("")
+    out.append(f"        const RomTranslation::Block kBlocks[{max(len(blocks), 1)}] = {{")
+    for leader in sorted(blocks):
+        insns = blocks[leader]
+        end_address, end_insn = insns[-1]
+        length = end_address + end_insn[4] - leader
+        out.append(f"            {{0x{leader:04X}, {length}, &block_{leader:04X}}},")
+    if not blocks:
+        out.append("            {0, 0, nullptr},")
+    out.append("        };")
+    out.append("")
+    out.append(f"        const RomTranslation kTranslation{{\"{name}\", 0x{rom.base:04X}, {bank}, kImage, sizeof(kImage),")
+    out.append(f"                                         kBlocks, {len(blocks)}}};")
+    out.append("")
+    out.append(f"        [[maybe_unused]] const bool kRegistered = RomTranslations::registerBuiltin(kTranslation);")
+    out.append("    } // namespace")
+    out.append("} // namespace Computer")
+    out.append("")
+    return "\n".join(out)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("--rom", required=True, help="ROM image")
+    parser.add_argument("--base", required=True, type=lambda s: int(s, 0), help="load address of the image")
+    parser.add_argument("--map", help="ld65 map file; its exports become entry points")
+    parser.add_argument("--bank", type=int, default=-1, help="module bank the image is installed in")
+    parser.add_argument("--entry", action="append", default=[], type=lambda s: int(s, 0),
+                        help="additional entry point (repeatable)")
+    parser.add_argument("--name", required=True, help="name recorded in the translation")
+    parser.add_argument("-o", "--output", required=True, help="C++ file to write")
+    args = parser.parse_args()
+
+    table, ends_block = load_opcode_table()
+    with open(args.rom, "rb") as f:
+        rom = Rom(f.read(), args.base, table)
+
+    entries = [args.base] + args.entry
+    for vector in (0xFFFA, 0xFFFC, 0xFFFE):
+        if rom.contains(vector, 2):
+            entries.append(rom.word(vector))
+    sources = [os.path.basename(args.rom)]
+    if args.map:
+        entries.extend(parse_exports(args.map))
+        sources.append(os.path.basename(args.map))
+
+    starts, leaders = find_code(rom, entries)
+    blocks = build_blocks(rom, starts, leaders, ends_block)
+
+    text = emit(args.name, rom, args.bank, blocks, sources)
+    os.makedirs(os.path.dirname(os.path.abspath(args.output)), exist_ok=True)
+    with open(args.output, "w", encoding="utf-8") as f:
+        f.write(text)
+    instructions = sum(len(b) for b in blocks.values())
+    print(f"romc: {args.name}: {len(blocks)} blocks, {instructions} instructions -> {args.output}")
+
+
+if __name__ == "__main__":
+    main()